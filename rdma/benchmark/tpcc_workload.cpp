@@ -67,9 +67,17 @@ RC tpcc_workload_t::init_table(){
     //              - new order
     //              - order line
     /**********************************/
+    // the random state is per warehouse, queries index it by warehouse as well
     tpcc_buffer = new drand48_data*[g_num_wh];
+    for(uint64_t wid=1; wid<=g_num_wh; wid++){
+	tpcc_buffer[wid-1] = (drand48_data *) _mm_malloc(sizeof(drand48_data), 64);
+	srand48_r(wid, tpcc_buffer[wid-1]);
+    }
+
+    // at most g_init_parallelism loaders, each takes every loader_num-th warehouse
+    int loader_num = std::min(g_num_wh, g_init_parallelism);
     std::vector<std::thread> thd;
-    for(int i=0; i<g_num_wh; i++)
+    for(int i=0; i<loader_num; i++)
 	thd.push_back(std::thread(thread_init_warehouse, this, i));
     for(auto& t: thd) t.join();
     printf("TPCC Data Initialization Complete!\n");
@@ -84,41 +92,41 @@ RC tpcc_workload_t::get_txn_man(txn_man_t*& txn_manager, thread_t* thd){
 
 void* tpcc_workload_t::thread_init_warehouse(void* This, int tid){
     auto wl = (tpcc_workload_t*)This;
-    uint32_t wid = tid + 1;
-    tpcc_buffer[tid] = (drand48_data *) _mm_malloc(sizeof(drand48_data), 64);
-    assert((uint64_t)tid < g_num_wh);
-    srand48_r(wid, tpcc_buffer[tid]);
+    int loader_num = std::min(g_num_wh, g_init_parallelism);
+    assert(tid < loader_num);
 
     if (tid == 0)
 	wl->init_tab_item(tid);
-    wl->init_tab_wh(wid, tid);
-    wl->init_tab_dist(wid, tid);
-    wl->init_tab_stock(wid, tid );
-    for (uint64_t did = 1; did <= DIST_PER_WARE; did++) {
-	wl->init_tab_cust(did, wid, tid);
-	wl->init_tab_order(did, wid, tid);
-	for (uint64_t cid = 1; cid <= g_cust_per_dist; cid++)
-	    wl->init_tab_hist(cid, did, wid, tid);
+    for (uint32_t wid = tid + 1; wid <= g_num_wh; wid += loader_num) {
+	wl->init_tab_wh(wid, tid);
+	wl->init_tab_dist(wid, tid);
+	wl->init_tab_stock(wid, tid);
+	for (uint64_t did = 1; did <= DIST_PER_WARE; did++) {
+	    wl->init_tab_cust(did, wid, tid);
+	    wl->init_tab_order(did, wid, tid);
+	    for (uint64_t cid = 1; cid <= g_cust_per_dist; cid++)
+		wl->init_tab_hist(cid, did, wid, tid);
+	}
     }
     return NULL;
 }
 
 uint64_t tpcc_workload_t::rpc_alloc_row(int pid, int tid){
-    if(pid >= MR_PARTITION_NUM){
-	debug::notify_error("tid %d ---- pid %d is larger than MR_PARTITON_NUM %d", tid, pid, MR_PARTITION_NUM);
+    if(pid >= PARTITION_NUM){
+	debug::notify_error("tid %d ---- pid %d is larger than PARTITION_NUM %d", tid, pid, PARTITION_NUM);
     }
-    assert(pid < MR_PARTITION_NUM);
+    assert(pid < PARTITION_NUM);
     auto send_ptr = mem->request_buffer_pool(tid);
-    auto request = create_message<request_t>((void*)send_ptr, tid, pid, request_type::TABLE_ALLOC_ROW);
-    transport->send((uint64_t)request, sizeof(request_t), tid);
+    auto request = create_message<request_t>((void*)send_ptr, tid, PART_TO_MR(pid), request_type::TABLE_ALLOC_ROW);
+    transport->send((uint64_t)request, sizeof(request_t), tid, PART_TO_SERVER(pid));
 
     auto recv_ptr = mem->response_buffer_pool(tid);
     auto response = create_message<response_t>((void*)recv_ptr);
-    transport->recv((uint64_t)response, sizeof(response_t), tid);
+    transport->recv((uint64_t)response, sizeof(response_t), tid, PART_TO_SERVER(pid));
     if(response->type != response_type::SUCCESS)
 	debug::notify_error("New row allocation failed (%d)", response->type);
 
-    return response->addr;
+    return gaddr(PART_TO_SERVER(pid), response->addr);
 }
 
 void tpcc_workload_t::init_tab_item(int tid) {
@@ -477,5 +485,5 @@ void tpcc_workload_t::init_permutation(uint64_t* perm_c_id, uint64_t wid) {
 }
 
 int tpcc_workload_t::key_to_part(Key key){
-    return h(&key, sizeof(key), HASH_FUNC) % MR_PARTITION_NUM;
+    return h(&key, sizeof(key), HASH_FUNC) % PARTITION_NUM;
 }
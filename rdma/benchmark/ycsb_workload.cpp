@@ -10,6 +10,7 @@
 #include "index/tree.h"
 #include "client/transport.h"
 #include "client/mr.h"
+#include "common/topology.h"
 
 #include <vector>
 #include <thread>
@@ -39,7 +40,7 @@ RC ycsb_workload_t::init_table(){
 }
 
 RC ycsb_workload_t::init_table_parallel(int tid){
-    bind_core(tid);
+    bind_core(topology.cpu(tid));
 
     uint64_t chunk = g_synth_table_size / g_init_parallelism;
     uint64_t from = chunk * tid + 1;
@@ -51,15 +52,15 @@ RC ycsb_workload_t::init_table_parallel(int tid){
 	uint64_t row_id = asm_rdtsc();
 	int pid = key_to_part(key);
 	auto send_ptr = mem->request_buffer_pool(tid);
-	auto request = create_message<request_t>((void*)send_ptr, tid, pid, request_type::TABLE_ALLOC_ROW);
-	transport->send((uint64_t)request, sizeof(request_t), tid);
+	auto request = create_message<request_t>((void*)send_ptr, tid, PART_TO_MR(pid), request_type::TABLE_ALLOC_ROW);
+	transport->send((uint64_t)request, sizeof(request_t), tid, PART_TO_SERVER(pid));
 
 	auto recv_ptr = mem->response_buffer_pool(tid);
 	auto response = create_message<response_t>((void*)recv_ptr);
-	transport->recv((uint64_t)response, sizeof(response_t), tid);
+	transport->recv((uint64_t)response, sizeof(response_t), tid, PART_TO_SERVER(pid));
 	if(response->type != response_type::SUCCESS)
 	    debug::notify_error("Memory allocation for new row failed (%d)", response->type);
-	uint64_t row_addr = response->addr;
+	uint64_t row_addr = gaddr(PART_TO_SERVER(pid), response->addr);
 	uint64_t primary_key = key;
 	auto schema = table->get_schema();
 	auto new_row = mem->row_buffer_pool(tid, 0);
@@ -90,5 +91,5 @@ RC ycsb_workload_t::get_txn_man(txn_man_t*& txn_man, thread_t* thd){
 }
 
 int ycsb_workload_t::key_to_part(Key key){
-    return h(&key, sizeof(key), HASH_FUNC) % MR_PARTITION_NUM;
+    return h(&key, sizeof(key), HASH_FUNC) % PARTITION_NUM;
 }
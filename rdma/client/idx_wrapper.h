@@ -8,7 +8,7 @@ class client_transport_t;
 
 class idx_wrapper_t{
     public:
-	idx_wrapper_t(config_t* conf);
+	idx_wrapper_t(config_t* conf, int thread_num);
 
 	// network
 	client_transport_t* transport;
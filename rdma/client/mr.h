@@ -7,14 +7,16 @@ class row_t;
 
 class client_mr_t{
     public:
-	uint64_t memory_pool[CLIENT_THREAD_NUM];
-	uint64_t memory_size[CLIENT_THREAD_NUM];
-	memory_region_t* memory_region[CLIENT_THREAD_NUM];
+	// one region holds the buffers of every thread so it is registered as a single MR
+	uint64_t memory_pool;
+	uint64_t memory_size;
+	uint64_t thread_size;
+	memory_region_t* memory_region;
 
-	client_mr_t();
+	client_mr_t(int thread_num);
 
-	uint64_t get_memory_pool(int tid);
-	uint64_t get_memory_size(int tid);
+	uint64_t get_memory_pool();
+	uint64_t get_memory_size();
 
 	request_t* request_buffer_pool(int tid);
 	response_t* response_buffer_pool(int tid);
@@ -23,4 +25,9 @@ class client_mr_t{
 	uint64_t page_buffer_pool(int tid);
 	uint64_t sibling_buffer_pool(int tid);
 	row_t* row_buffer_pool(int tid, int rid);
+
+    private:
+	uint64_t thread_pool(int tid){
+	    return memory_pool + thread_size * tid;
+	}
 };
@@ -1,18 +1,30 @@
 #include "client/transport.h"
 
-client_transport_t::client_transport_t(config_t* conf, uint64_t* mem_pool, uint64_t* mem_size): conf(conf){
+client_transport_t::client_transport_t(config_t* conf, uint64_t mem_pool, uint64_t mem_size, int thread_num): thread_num(thread_num), conf(conf){
     bool ret = init(mem_pool, mem_size);
     if(!ret)
 	exit(0);
 }
 
-bool client_transport_t::init(uint64_t* mem_pool, uint64_t* mem_size){
+bool client_transport_t::init(uint64_t mem_pool, uint64_t mem_size){
     bool ret = false;
+    group_num = (thread_num + QP_SHARE_NUM - 1) / QP_SHARE_NUM;
+    int qp_num = group_num * SERVER_NUM;
+    qps = new shared_qp_t[qp_num]();
+    threads = new thread_ctx_t[thread_num]();
+    mr = nullptr;
+    context.pd = nullptr;
+
     context.gid_idx = 0;
     context.ctx = open_device();
     if(!context.ctx)
         goto CLEANUP;
 
+    if(thread_num > CLIENT_THREAD_NUM){
+	debug::notify_error("%d client threads exceed CLIENT_THREAD_NUM %d", thread_num, CLIENT_THREAD_NUM);
+	goto CLEANUP;
+    }
+
     context.pd = alloc_pd(context.ctx);
     if(!context.pd)
         goto CLEANUP;
@@ -21,30 +33,31 @@ bool client_transport_t::init(uint64_t* mem_pool, uint64_t* mem_size){
     if(!ret)
         goto CLEANUP;
 
-    // create CQs
-    for(int i=0; i<CLIENT_THREAD_NUM; i++){
-	send_cq[i] = create_cq(context.ctx);
-        recv_cq[i] = create_cq(context.ctx);
-        if(!send_cq[i] || !recv_cq[i])
+    // create CQs and QPs, one of each per core group and memory server
+    for(int i=0; i<qp_num; i++){
+	auto q = &qps[i];
+	q->send_cq = create_cq(context.ctx);
+        q->recv_cq = create_cq(context.ctx);
+        if(!q->send_cq || !q->recv_cq)
             goto CLEANUP;
-    }
 
-    // create QPs
-    for(int i=0; i<CLIENT_THREAD_NUM; i++){
-        qp[i] = create_qp(context.pd, send_cq[i], recv_cq[i]);
-        if(!qp[i])
+        q->qp = create_qp(context.pd, q->send_cq, q->recv_cq);
+        if(!q->qp)
             goto CLEANUP;
-        if(!modify_qp_state_to_init(qp[i]))
+        if(!modify_qp_state_to_init(q->qp))
             goto CLEANUP;
-    }
 
-    // create MR
-    for(int i=0; i<CLIENT_THREAD_NUM; i++){
-        mr[i] = register_mr(context.pd, mem_pool[i], mem_size[i]);
-        if(!mr[i])
-            goto CLEANUP;
+	for(int j=0; j<QP_SHARE_NUM; j++)
+	    q->ring[j].seq.store(j);
+	q->tail.store(0);
+	q->head = 0;
     }
 
+    // create MR over the buffers of every thread
+    mr = register_mr(context.pd, mem_pool, mem_size);
+    if(!mr)
+	goto CLEANUP;
+
     if(!setup_connection())
         goto CLEANUP;
 
@@ -52,18 +65,16 @@ bool client_transport_t::init(uint64_t* mem_pool, uint64_t* mem_size){
 
 CLEANUP:
     debug::notify_error("Error occurred during initialization --- cleaning up ...");
-    for(int i=0; i<CLIENT_THREAD_NUM; i++){
-        if(mr[i])
-            ibv_dereg_mr(mr[i]);
-    }
-
-    for(int i=0; i<CLIENT_THREAD_NUM; i++){
-        if(qp[i])
-            ibv_destroy_qp(qp[i]);
-        if(send_cq[i])
-            ibv_destroy_cq(send_cq[i]);
-        if(recv_cq[i])
-            ibv_destroy_cq(recv_cq[i]);
+    if(mr)
+	ibv_dereg_mr(mr);
+
+    for(int i=0; i<qp_num; i++){
+        if(qps[i].qp)
+            ibv_destroy_qp(qps[i].qp);
+        if(qps[i].send_cq)
+            ibv_destroy_cq(qps[i].send_cq);
+        if(qps[i].recv_cq)
+            ibv_destroy_cq(qps[i].recv_cq);
     }
 
     if(context.pd)
@@ -75,47 +86,154 @@ CLEANUP:
 }
 
 bool client_transport_t::setup_connection(){
-    struct server_client_meta local;
-    memset(&local, 0, sizeof(struct server_client_meta));
-
-    local.gid_idx = context.gid_idx;
-    memcpy(&local.gid, &context.gid, sizeof(union ibv_gid));
-    local.lid = context.port_attr.lid;
-    for(int i=0; i<CLIENT_THREAD_NUM; i++)
-        local.qpn[i] = qp[i]->qp_num;
-
-    client_connect(conf->get_ip(0).c_str(), &local, &meta);
-    for(int i=0; i<CLIENT_THREAD_NUM; i++){
-        if(!modify_qp_state_to_rtr(qp[i], meta.gid, meta.gid_idx, meta.lid, meta.qpn[i]))
-            return false;
-        if(!modify_qp_state_to_rts(qp[i]))
-            return false;
+    if(conf->get_server_num() != SERVER_NUM){
+	debug::notify_error("host.txt lists %d memory servers but SERVER_NUM is %d", conf->get_server_num(), SERVER_NUM);
+	return false;
+    }
+
+    for(int node=0; node<SERVER_NUM; node++){
+	struct server_client_meta local;
+	memset(&local, 0, sizeof(struct server_client_meta));
+
+	local.gid_idx = context.gid_idx;
+	memcpy(&local.gid, &context.gid, sizeof(union ibv_gid));
+	local.lid = context.port_attr.lid;
+	local.qp_num = group_num;
+	for(int i=0; i<group_num; i++)
+	    local.qpn[i] = qps[node * group_num + i].qp->qp_num;
+
+	client_connect(conf->get_ip(node).c_str(), &local, &meta[node]);
+	for(int i=0; i<group_num; i++){
+	    auto q = qps[node * group_num + i].qp;
+	    if(!modify_qp_state_to_rtr(q, meta[node].gid, meta[node].gid_idx, meta[node].lid, meta[node].qpn[i]))
+		return false;
+	    if(!modify_qp_state_to_rts(q))
+		return false;
+	}
+	debug::notify_info("Connected to Memory Worker %d (%s) with %d QPs", node, conf->get_ip(node).c_str(), group_num);
     }
 
-    debug::notify_info("Connected to Memory Worker");
     return true;
 }
 
-void client_transport_t::prepost_recv(uint64_t ptr, int size, int qp_id){
-    rdma_recv_prepost(qp[qp_id], ptr, size, mr[qp_id]->lkey);
+struct ibv_send_wr* client_transport_t::prepare(int qp_id, uint64_t src, int size, enum ibv_wr_opcode opcode){
+    auto t = &threads[qp_id];
+    memset(&t->sge, 0, sizeof(t->sge));
+    memset(&t->wr, 0, sizeof(t->wr));
+
+    t->sge.addr = (uintptr_t)src;
+    t->sge.length = size;
+    t->sge.lkey = mr->lkey;
+
+    t->wr.wr_id = qp_id;
+    t->wr.sg_list = &t->sge;
+    t->wr.num_sge = 1;
+    t->wr.opcode = opcode;
+    t->wr.send_flags = IBV_SEND_SIGNALED;
+    return &t->wr;
 }
 
-void client_transport_t::recv(uint64_t ptr, int size, int qp_id){
-    rdma_recv(qp[qp_id], recv_cq[qp_id], ptr, size, mr[qp_id]->lkey);
+// returns once the work request of the thread has completed
+void client_transport_t::submit(shared_qp_t* q, int qp_id){
+    auto t = &threads[qp_id];
+    t->done.store(false, std::memory_order_relaxed);
+
+    auto pos = q->tail.fetch_add(1);
+    auto& slot = q->ring[pos & (QP_SHARE_NUM - 1)];
+    while(slot.seq.load(std::memory_order_acquire) != pos);
+    slot.wr = &t->wr;
+    slot.seq.store(pos + 1, std::memory_order_release);
+
+    // a request published after the poster looked at the ring is posted by its own thread here
+    while(!t->done.load(std::memory_order_acquire)){
+	if(!q->posting.exchange(true, std::memory_order_acquire)){
+	    drain(q);
+	    q->posting.store(false, std::memory_order_release);
+	}
+	poll(q);
+    }
 }
 
-void client_transport_t::send(uint64_t ptr, int size, int qp_id){
-    rdma_send(qp[qp_id], send_cq[qp_id], ptr, size, mr[qp_id]->lkey);
+void client_transport_t::drain(shared_qp_t* q){
+    struct ibv_send_wr* first = nullptr;
+    struct ibv_send_wr* last = nullptr;
+    while(true){
+	auto& slot = q->ring[q->head & (QP_SHARE_NUM - 1)];
+	if(slot.seq.load(std::memory_order_acquire) != q->head + 1)
+	    break;
+	auto wr = slot.wr;
+	slot.seq.store(q->head + QP_SHARE_NUM, std::memory_order_release);
+	q->head++;
+
+	wr->next = nullptr;
+	if(last)
+	    last->next = wr;
+	else
+	    first = wr;
+	last = wr;
+    }
+
+    struct ibv_send_wr* wr_bad;
+    if(first && ibv_post_send(q->qp, first, &wr_bad))
+	debug::notify_error("Failed to ibv_post_send (shared QP)");
+}
+
+void client_transport_t::poll(shared_qp_t* q){
+    if(q->polling.exchange(true, std::memory_order_acquire))
+	return;
+
+    struct ibv_wc wc[QP_SHARE_NUM];
+    int cnt = ibv_poll_cq(q->send_cq, QP_SHARE_NUM, wc);
+    for(int i=0; i<cnt; i++){
+	if(wc[i].status != IBV_WC_SUCCESS)
+	    debug::notify_error("Failed to ibv_poll_cq ---- status %s (%d)", ibv_wc_status_str(wc[i].status), wc[i].status);
+	threads[wc[i].wr_id].done.store(true, std::memory_order_release);
+    }
+    q->polling.store(false, std::memory_order_release);
+}
+
+void client_transport_t::recv(uint64_t ptr, int size, int qp_id, int node){
+    auto q = conn(qp_id, node);
+    struct ibv_wc wc;
+    post_recv(q->qp, ptr, size, mr->lkey, qp_id);
+    poll_cq(q->recv_cq, 1, &wc);
+    q->rpc.store(false, std::memory_order_release);
+}
+
+// the response lands in whichever recv is posted first, so the threads of a QP take turns on rpcs
+void client_transport_t::send(uint64_t ptr, int size, int qp_id, int node){
+    auto q = conn(qp_id, node);
+    while(q->rpc.exchange(true, std::memory_order_acquire));
+
+    auto wr = prepare(qp_id, ptr, size, IBV_WR_SEND);
+    if(size <= 1024)
+	wr->send_flags |= IBV_SEND_INLINE;
+    submit(q, qp_id);
 }
 
 void client_transport_t::write(uint64_t src, uint64_t dest, int size, int qp_id, int pid){
-    rdma_write(qp[qp_id], send_cq[qp_id], src, dest, size, mr[qp_id]->lkey, meta.rkey[pid]);
+    auto node = gaddr_node(dest);
+    auto wr = prepare(qp_id, src, size, IBV_WR_RDMA_WRITE);
+    wr->wr.rdma.remote_addr = gaddr_offset(dest);
+    wr->wr.rdma.rkey = meta[node].rkey[PART_TO_MR(pid)];
+    submit(conn(qp_id, node), qp_id);
 }
 
 void client_transport_t::read(uint64_t src, uint64_t dest, int size, int qp_id, int pid){
-    rdma_read(qp[qp_id], send_cq[qp_id], src, dest, size, mr[qp_id]->lkey, meta.rkey[pid]);
+    auto node = gaddr_node(dest);
+    auto wr = prepare(qp_id, src, size, IBV_WR_RDMA_READ);
+    wr->wr.rdma.remote_addr = gaddr_offset(dest);
+    wr->wr.rdma.rkey = meta[node].rkey[PART_TO_MR(pid)];
+    submit(conn(qp_id, node), qp_id);
 }
 
 bool client_transport_t::cas(uint64_t src, uint64_t dest, uint64_t cmp, uint64_t swap, int size, int qp_id, int pid){
-    return rdma_cas(qp[qp_id], send_cq[qp_id], src, dest, cmp, swap, size, mr[qp_id]->lkey, meta.rkey[pid]);
+    auto node = gaddr_node(dest);
+    auto wr = prepare(qp_id, src, size, IBV_WR_ATOMIC_CMP_AND_SWP);
+    wr->wr.atomic.remote_addr = gaddr_offset(dest);
+    wr->wr.atomic.compare_add = cmp;
+    wr->wr.atomic.swap = swap;
+    wr->wr.atomic.rkey = meta[node].rkey[PART_TO_MR(pid)];
+    submit(conn(qp_id, node), qp_id);
+    return cmp == *(uint64_t*)src;
 }
@@ -3,30 +3,67 @@
 #include "net/config.h"
 #include "common/global.h"
 
+#include <atomic>
+
 class client_transport_t{
     public:
-        client_transport_t(config_t* conf, uint64_t* mem_pool, uint64_t* mem_size);
-        bool init(uint64_t* mem_pool, uint64_t* mem_size);
+	// QPs and CQs are sized for thread_num client threads, mem_pool is the buffer region of all of them
+        client_transport_t(config_t* conf, uint64_t mem_pool, uint64_t mem_size, int thread_num);
+        bool init(uint64_t mem_pool, uint64_t mem_size);
         bool setup_connection();
 
-        void prepost_recv(uint64_t ptr, int size, int qp_id);
-	void recv(uint64_t ptr, int size, int qp_id);
-        void send(uint64_t ptr, int size, int qp_id);
+        // rpcs go to the memory server given by node, one-sided verbs to the server encoded in dest
+        // an rpc is a send followed by the recv of its response, it holds the rpc slot of the shared QP in between
+	void recv(uint64_t ptr, int size, int qp_id, int node=0);
+        void send(uint64_t ptr, int size, int qp_id, int node=0);
 	void read(uint64_t src, uint64_t dest, int size, int qp_id, int pid);
 	void write(uint64_t src, uint64_t dest, int size, int qp_id, int pid);
 	bool cas(uint64_t src, uint64_t dest, uint64_t cmp, uint64_t swap, int size, int qp_id, int pid);
 
     private:
-        struct rdma_ctx context;
-        struct server_client_meta meta;
-        struct ibv_qp* qp[CLIENT_THREAD_NUM];
-        struct ibv_cq* send_cq[CLIENT_THREAD_NUM];
-        struct ibv_cq* recv_cq[CLIENT_THREAD_NUM];
-        struct ibv_mr* mr[CLIENT_THREAD_NUM];
+	// QP_SHARE_NUM adjacent threads share a QP, each has at most one work request outstanding
+	// a thread publishes its request in a bounded MPSC ring, whichever thread takes the post flag
+	// drains the ring into a single ibv_post_send and completions are handed back by wr_id
+	struct alignas(64) shared_qp_t{
+	    struct ibv_qp* qp;
+	    struct ibv_cq* send_cq;
+	    struct ibv_cq* recv_cq;
 
-	config_t* conf;
-};
+	    struct slot_t{
+		std::atomic<uint64_t> seq;
+		struct ibv_send_wr* wr;
+	    } ring[QP_SHARE_NUM];
+	    std::atomic<uint64_t> tail;
+	    uint64_t head; // only touched under posting
+
+	    std::atomic<bool> posting;
+	    std::atomic<bool> polling;
+	    std::atomic<bool> rpc;
+	};
 
+	struct alignas(64) thread_ctx_t{
+	    struct ibv_send_wr wr;
+	    struct ibv_sge sge;
+	    std::atomic<bool> done;
+	};
 
+	shared_qp_t* conn(int qp_id, int node){
+	    return &qps[node * group_num + qp_id / QP_SHARE_NUM];
+	}
 
+	struct ibv_send_wr* prepare(int qp_id, uint64_t src, int size, enum ibv_wr_opcode opcode);
+	void submit(shared_qp_t* q, int qp_id);
+	void drain(shared_qp_t* q);
+	void poll(shared_qp_t* q);
 
+	int thread_num;
+	int group_num; // QPs per memory server
+
+        struct rdma_ctx context;
+        struct server_client_meta meta[SERVER_NUM];
+	shared_qp_t* qps;
+	thread_ctx_t* threads;
+        struct ibv_mr* mr;
+
+	config_t* conf;
+};
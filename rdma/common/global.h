@@ -159,16 +159,41 @@ enum status_t: unsigned int{
 #define STATS_ENABLE 		true
 #define BACKOFF 		10000
 
+// retry scheduler config
+#define RETRY_LINEAR 		1
+#define RETRY_EXPONENTIAL 	2
+#define RETRY_POLICY 		RETRY_EXPONENTIAL
+#define MAX_BACKOFF 		(BACKOFF * 64)
+#define RETRY_QUEUE_SIZE 	4
+#define CONFLICT_HISTORY 	16
+
 // client config
+// upper bound on client threads, QPs, CQs and the buffer MR are sized from the threads actually run
 #define CLIENT_THREAD_NUM 	128
+// adjacent client threads (a core group) multiplex their verbs on one QP per memory server, power of two
+#define QP_SHARE_NUM 		4
 #define HASH_FUNC 		1
 
 // server config
+// memory servers listed in host.txt, each exports MR_PARTITION_NUM regions and the
+// partitions are numbered across servers (pid / MR_PARTITION_NUM is the owning server)
 #define SERVER_NUM 		1
 #define SERVER_THREAD_NUM 	1
 //#define MR_PARTITION_NUM	50
 #define MR_PARTITION_NUM	25
 //#define MR_PARTITION_NUM	10
+#define PARTITION_NUM 		(SERVER_NUM * MR_PARTITION_NUM)
+#define PART_TO_SERVER(pid) 	((pid) / MR_PARTITION_NUM)
+#define PART_TO_MR(pid) 	((pid) % MR_PARTITION_NUM)
+// the partitions are allocated and registered by one thread each at startup, with MR_ODP they are
+// registered with on-demand paging and pinned on first access instead of all up front
+//#define MR_ODP
+
+// placement config
+#define PLACE_LINEAR 		1 	// thread i on cpu i, memory on the node that first touches it
+#define PLACE_NIC_LOCAL 	2 	// threads and client buffers on the NIC's node first, MR partitions spread over nodes
+#define PLACE_INTERLEAVE 	3 	// threads alternate over the nodes, MR partitions spread over nodes
+#define PLACEMENT_POLICY 	PLACE_NIC_LOCAL
 
 
 #define THREAD_CNT 		64
@@ -1,4 +1,23 @@
 #pragma once
+#include <cstdint>
+
+// a remote pointer is a single word so it fits in index entries and can be swapped with rdma cas,
+// the memory server that owns it sits in the top bits above the 48-bit virtual address
+#define GADDR_NODE_SHIFT 	48
+#define GADDR_OFFSET_MASK 	((1ULL << GADDR_NODE_SHIFT) - 1)
+
+static inline uint64_t gaddr(uint64_t node_id, uint64_t addr){
+    return addr ? ((node_id << GADDR_NODE_SHIFT) | addr) : 0; // null stays null on every node
+}
+
+static inline uint64_t gaddr_node(uint64_t gaddr){
+    return gaddr >> GADDR_NODE_SHIFT;
+}
+
+static inline uint64_t gaddr_offset(uint64_t gaddr){
+    return gaddr & GADDR_OFFSET_MASK;
+}
+
 class global_addr_t{
     public:
 	uint64_t node_id;
@@ -6,6 +25,11 @@ class global_addr_t{
 
 	global_addr_t(): node_id(0), addr(0){ }
 	global_addr_t(const global_addr_t& other): node_id(other.node_id), addr(other.addr){ }
+	explicit global_addr_t(uint64_t gaddr): node_id(gaddr_node(gaddr)), addr(gaddr_offset(gaddr)){ }
+
+	uint64_t to_word() const{
+	    return gaddr(node_id, addr);
+	}
 
 	static global_addr_t null(){
 	    return global_addr_t();
@@ -8,18 +8,21 @@ constexpr uint64_t MR_SIZE = (uint64_t)1024 * 1024 * 1024 * 4;
 
 class memory_region_t{
     public:
+	// no memset, fresh hugepages are already zero and are faulted in when the MR is registered
 	memory_region_t(): _size(MR_SIZE){
 	    addr = huge_page_alloc(_size);
 	    if(!addr){
 		debug::notify_error("failed to allocate memory_region");
 		exit(0);
 	    }
-	    memset(addr, 0, _size);
 	}
 
 	memory_region_t(size_t _size): _size(_size){
 	    addr = huge_page_alloc(_size);
-	    memset(addr, 0, _size);
+	    if(!addr){
+		debug::notify_error("failed to allocate memory_region");
+		exit(0);
+	    }
 	}
 
 	~memory_region_t(){
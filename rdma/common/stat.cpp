@@ -3,7 +3,7 @@
 #include <iostream>
 #include <fstream>
 
-stat_thread_t::stat_thread_t(): run_cnt(0), run_time(0), abort_cnt(0){
+stat_thread_t::stat_thread_t(): run_cnt(0), run_time(0), abort_cnt(0), retry_cnt(0), defer_cnt(0){
     latency.clear();
     latency.resize(MAX_TRANSACTION);
     latency.resize(0);
@@ -20,6 +20,8 @@ void stat_thread_t::clear(){
     run_cnt = 0;
     run_time = 0;
     abort_cnt = 0;
+    retry_cnt = 0;
+    defer_cnt = 0;
 
     time_abort = 0;
     time_commit = 0;
@@ -34,10 +36,12 @@ void stat_thread_t::add_latency(uint64_t _latency){
     latency.push_back(_latency);
 }
 
-void stat_thread_t::summary(uint64_t& run_cnt, uint64_t& run_time, uint64_t& abort_cnt, uint64_t& time_commit, uint64_t& time_abort, uint64_t& time_backoff, uint64_t& time_index, uint64_t& time_wait, std::vector<uint64_t>& latency){
+void stat_thread_t::summary(uint64_t& run_cnt, uint64_t& run_time, uint64_t& abort_cnt, uint64_t& retry_cnt, uint64_t& defer_cnt, uint64_t& time_commit, uint64_t& time_abort, uint64_t& time_backoff, uint64_t& time_index, uint64_t& time_wait, std::vector<uint64_t>& latency){
     run_cnt += this->run_cnt;
     run_time += this->run_time;
     abort_cnt += this->abort_cnt;
+    retry_cnt += this->retry_cnt;
+    defer_cnt += this->defer_cnt;
 
     time_commit += this->time_commit;
     time_abort += this->time_abort;
@@ -63,6 +67,8 @@ void stat_t::summary(){
     uint64_t run_cnt = 0;
     uint64_t run_time = 0;
     uint64_t abort_cnt = 0;
+    uint64_t retry_cnt = 0;
+    uint64_t defer_cnt = 0;
 
     // breakdown
     uint64_t time_commit, time_abort, time_index, time_wait, time_backoff;
@@ -70,7 +76,7 @@ void stat_t::summary(){
 
     std::vector<uint64_t> latency;
     for(int i=0; i<g_run_parallelism; i++){
-	_stats[i]->summary(run_cnt, run_time, abort_cnt, time_commit, time_abort, time_backoff, time_index, time_wait, latency);
+	_stats[i]->summary(run_cnt, run_time, abort_cnt, retry_cnt, defer_cnt, time_commit, time_abort, time_backoff, time_index, time_wait, latency);
     }
 
     std::sort(latency.begin(), latency.end());
@@ -81,6 +87,8 @@ void stat_t::summary(){
     std::cout << "Processed           : " << run_cnt << " for " << run_time << " sec" << std::endl;
     std::cout << "Aborted             : " << abort_cnt << " for " << run_time << " sec" << std::endl;
     std::cout << "Abort rate          : " << (double)abort_cnt / (abort_cnt + run_cnt) << std::endl;
+    std::cout << "Retried             : " << retry_cnt << std::endl;
+    std::cout << "Deferred            : " << defer_cnt << std::endl;
     uint64_t total_breakdown = time_commit + time_abort + time_index + time_wait + time_backoff;
     std::cout << "    Total time: " << total_breakdown << std::endl;
     std::cout << "    Index     : " << (double)time_index / total_breakdown * 100 << " %" << std::endl;
@@ -10,12 +10,14 @@ class stat_thread_t{
 	void clear();
 
 	// compute stats
-	void summary(uint64_t& run_cnt, uint64_t& run_time, uint64_t& abort_cnt, uint64_t& time_commit, uint64_t& time_abort, uint64_t& time_backoff, uint64_t& time_index, uint64_t& time_wait, std::vector<uint64_t>& latency);
+	void summary(uint64_t& run_cnt, uint64_t& run_time, uint64_t& abort_cnt, uint64_t& retry_cnt, uint64_t& defer_cnt, uint64_t& time_commit, uint64_t& time_abort, uint64_t& time_backoff, uint64_t& time_index, uint64_t& time_wait, std::vector<uint64_t>& latency);
 
 
 	uint64_t run_cnt;
 	uint64_t run_time;
 	uint64_t abort_cnt;
+	uint64_t retry_cnt; // re-executions of aborted txns
+	uint64_t defer_cnt; // new txns run while an aborted one backs off
 
 	uint64_t time_index;
 	uint64_t time_abort;
@@ -0,0 +1,158 @@
+#include "common/topology.h"
+#include "common/debug.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+
+topology_t topology;
+
+static bool read_line(const std::string& path, std::string& line){
+    std::ifstream ifs(path);
+    if(!ifs.is_open())
+	return false;
+    return (bool)std::getline(ifs, line);
+}
+
+// "0-3,8,10-11"
+static std::vector<int> parse_list(const std::string& line){
+    std::vector<int> ids;
+    std::stringstream ss(line);
+    std::string range;
+    while(std::getline(ss, range, ',')){
+	if(range.empty())
+	    continue;
+	auto dash = range.find('-');
+	int from = std::stoi(range.substr(0, dash));
+	int to = (dash == std::string::npos) ? from : std::stoi(range.substr(dash+1));
+	for(int i=from; i<=to; i++)
+	    ids.push_back(i);
+    }
+    return ids;
+}
+
+// mbind has to cover whole hugepages, the regions are mapped with MAP_HUGETLB
+static size_t huge_page_size(){
+    std::ifstream ifs("/proc/meminfo");
+    std::string key;
+    size_t kb;
+    while(ifs >> key){
+	if(key == "Hugepagesize:" && ifs >> kb)
+	    return kb * 1024;
+	ifs.ignore(256, '\n');
+    }
+    return 2 * 1024 * 1024;
+}
+
+topology_t::topology_t(): nodes(1), nic(0), ready(false){ }
+
+void topology_t::init(const char* ib_dev){
+    if(ready)
+	return;
+    discover(ib_dev);
+    ready = true;
+    print();
+}
+
+void topology_t::discover(const char* ib_dev){
+    std::string line;
+    if(!read_line("/sys/devices/system/cpu/online", line))
+	return;
+    auto ids = parse_list(line);
+    if(ids.empty())
+	return;
+
+    std::vector<int> node_of(ids.back() + 1, 0);
+    if(read_line("/sys/devices/system/node/online", line)){
+	for(auto n: parse_list(line)){
+	    nodes = std::max(nodes, n + 1);
+	    if(read_line("/sys/devices/system/node/node" + std::to_string(n) + "/cpulist", line)){
+		for(auto c: parse_list(line)){
+		    if(c < (int)node_of.size())
+			node_of[c] = n;
+		}
+	    }
+	}
+    }
+
+    std::vector<cpu_t> cpus;
+    for(auto id: ids){
+	bool sibling = false;
+	if(read_line("/sys/devices/system/cpu/cpu" + std::to_string(id) + "/topology/thread_siblings_list", line)){
+	    auto siblings = parse_list(line);
+	    sibling = !siblings.empty() && siblings.front() != id;
+	}
+	cpus.push_back({id, node_of[id], sibling});
+    }
+
+    if(read_line(std::string("/sys/class/infiniband/") + ib_dev + "/device/numa_node", line)){
+	nic = std::stoi(line);
+	if(nic < 0) // no affinity reported, e.g. a single-socket machine
+	    nic = 0;
+    }
+
+    // rank of a cpu among the cpus of its node with the same sibling flag, for interleaving
+    std::vector<int> rank(cpus.size());
+    std::vector<int> cnt(nodes * 2, 0);
+    for(size_t i=0; i<cpus.size(); i++)
+	rank[i] = cnt[cpus[i].node * 2 + cpus[i].sibling]++;
+
+    std::vector<size_t> idx(cpus.size());
+    for(size_t i=0; i<idx.size(); i++)
+	idx[i] = i;
+    std::stable_sort(idx.begin(), idx.end(), [&](size_t a, size_t b){
+	auto& x = cpus[a];
+	auto& y = cpus[b];
+	switch(PLACEMENT_POLICY){
+	    case PLACE_NIC_LOCAL: // physical cores of the NIC's node, its siblings, then the other nodes
+		return std::make_tuple(x.node != nic, x.sibling, x.node, x.id) < std::make_tuple(y.node != nic, y.sibling, y.node, y.id);
+	    case PLACE_INTERLEAVE: // physical cores alternating over the nodes, then the siblings
+		return std::make_tuple(x.sibling, rank[a], x.node) < std::make_tuple(y.sibling, rank[b], y.node);
+	    default:
+		return x.id < y.id;
+	}
+    });
+
+    order.clear();
+    for(auto i: idx)
+	order.push_back(cpus[i].id);
+}
+
+int topology_t::cpu(int tid){
+    if(order.empty())
+	return tid;
+    return order[tid % order.size()];
+}
+
+int topology_t::partition_node(int pid){
+    if(PLACEMENT_POLICY == PLACE_LINEAR || nodes <= 1)
+	return -1;
+    // MR 0 holds the rpc buffers, so the NIC's node comes first
+    return (nic + pid) % nodes;
+}
+
+void topology_t::bind_node(void* addr, size_t size, int node){
+    if(node < 0 || nodes <= 1)
+	return;
+
+    static const size_t page = huge_page_size();
+    size = (size + page - 1) / page * page;
+    unsigned long mask[4] = {0};
+    if(node >= (int)(sizeof(mask) * 8))
+	return;
+    mask[node / 64] |= 1UL << (node % 64);
+    if(syscall(SYS_mbind, addr, size, MPOL_PREFERRED, mask, sizeof(mask) * 8, 0))
+	debug::notify_error("[topology] mbind to node %d failed --- errno(%d) %s", node, errno, std::strerror(errno));
+}
+
+void topology_t::print(){
+    const char* policy = (PLACEMENT_POLICY == PLACE_NIC_LOCAL) ? "nic-local" : (PLACEMENT_POLICY == PLACE_INTERLEAVE) ? "interleave" : "linear";
+    debug::notify_info("[topology] %lu cpus on %d nodes, NIC on node %d, placement %s", order.size(), nodes, nic, policy);
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "common/global.h"
+
+// cpu, numa and NIC locality of the machine, read from sysfs
+// threads are placed by PLACEMENT_POLICY and memory is bound before it is first touched,
+// without sysfs everything falls back to one node with thread i on cpu i
+class topology_t{
+    public:
+	topology_t();
+
+	// ib_dev is the RDMA device the transport opens
+	void init(const char* ib_dev);
+
+	// cpu of the tid-th thread, threads past the cpu count wrap around
+	int cpu(int tid);
+	int nic_node(){ return nic; }
+	int node_num(){ return nodes; }
+
+	// node of an MR partition, -1 leaves it to first touch
+	int partition_node(int pid);
+	// preferred rather than strict, a node out of hugepages falls back to the others
+	void bind_node(void* addr, size_t size, int node);
+	void bind_local(void* addr, size_t size){ bind_node(addr, size, PLACEMENT_POLICY == PLACE_LINEAR ? -1 : nic); }
+
+	void print();
+
+    private:
+	struct cpu_t{
+	    int id;
+	    int node;
+	    bool sibling; // not the first hardware thread of its core
+	};
+
+	void discover(const char* ib_dev);
+
+	std::vector<int> order; // cpus in placement order
+	int nodes;
+	int nic;
+	bool ready;
+};
+
+extern topology_t topology;
@@ -15,27 +15,28 @@ tree_t<Key_t, Value_t>::tree_t(client_mr_t* mem, client_transport_t* transport,
 template <typename Key_t, typename Value_t>
 uint64_t tree_t<Key_t, Value_t>::rpc_alloc(int tid){
     auto send_ptr = mem->request_buffer_pool(tid);
-    auto request = create_message<request_t>((void*)send_ptr, tid, pid, request_type::IDX_ALLOC_NODE);
-    transport->send((uint64_t)request, sizeof(request_t), tid);
+    auto request = create_message<request_t>((void*)send_ptr, tid, PART_TO_MR(pid), request_type::IDX_ALLOC_NODE);
+    transport->send((uint64_t)request, sizeof(request_t), tid, PART_TO_SERVER(pid));
 
     auto recv_ptr = mem->response_buffer_pool(tid);
     auto response = create_message<response_t>((void*)recv_ptr);
-    transport->recv((uint64_t)response, sizeof(response_t), tid);
+    transport->recv((uint64_t)response, sizeof(response_t), tid, PART_TO_SERVER(pid));
     if(response->type != response_type::SUCCESS)
 	debug::notify_error("[INDEX] Memory allocation failed: return type %d", response->type);
 
-    return response->addr;
+    // children and siblings point into the same server as the page that links them
+    return gaddr(PART_TO_SERVER(pid), response->addr);
 }
 
 template <typename Key_t, typename Value_t>
 void tree_t<Key_t, Value_t>::rpc_dealloc(int tid, uint64_t addr){
     auto send_ptr = mem->request_buffer_pool(tid);
-    auto request = create_message<request_t>((void*)send_ptr, tid, pid, request_type::IDX_DEALLOC_NODE, addr);
-    transport->send((uint64_t)request, sizeof(request_t), tid);
+    auto request = create_message<request_t>((void*)send_ptr, tid, PART_TO_MR(pid), request_type::IDX_DEALLOC_NODE, gaddr_offset(addr));
+    transport->send((uint64_t)request, sizeof(request_t), tid, PART_TO_SERVER(pid));
 
     auto recv_ptr = mem->response_buffer_pool(tid);
     auto response = create_message<response_t>((void*)recv_ptr);
-    transport->recv((uint64_t)response, sizeof(response_t), tid);
+    transport->recv((uint64_t)response, sizeof(response_t), tid, PART_TO_SERVER(pid));
     if(response->type != response_type::SUCCESS)
 	debug::notify_error("[INDEX] Memory deletion failed: return type %d", response->type);
 }
@@ -49,17 +50,17 @@ void tree_t<Key_t, Value_t>::initialize_root(){
     transport->write(page_buffer, addr, PAGE_SIZE, tid, pid);
 
     auto send_ptr = mem->request_buffer_pool(tid);
-    auto request = create_message<request_t>((void*)send_ptr, tid, pid, request_type::IDX_UPDATE_ROOT, addr);
-    transport->send((uint64_t)request, sizeof(request_t), tid);
+    auto request = create_message<request_t>((void*)send_ptr, tid, PART_TO_MR(pid), request_type::IDX_UPDATE_ROOT, addr);
+    transport->send((uint64_t)request, sizeof(request_t), tid, PART_TO_SERVER(pid));
 
     auto recv_ptr = mem->response_buffer_pool(tid);
     auto response = create_message<response_t>((void*)recv_ptr);
-    transport->recv((uint64_t)response, sizeof(response_t), tid);
+    transport->recv((uint64_t)response, sizeof(response_t), tid, PART_TO_SERVER(pid));
     if(response->type != response_type::SUCCESS){
 	debug::notify_error("[INDEX] RPC root update failed: return type %d", response->type);
 	exit(0);
     }
-    _root_addr = response->addr;
+    _root_addr = gaddr(PART_TO_SERVER(pid), response->addr);
 }
 
 template <typename Key_t, typename Value_t>
@@ -14,6 +14,7 @@
 
 #define QP_DEPTH 64
 //#define QP_DEPTH 128
+#define IB_DEVICE "mlx5_2"
 #define IB_PORT 1
 #define TCP_PORT 2123
 
@@ -31,6 +32,7 @@ struct server_client_meta{
     union ibv_gid gid;
     uint32_t lid;
     uint32_t rkey[MR_PARTITION_NUM];
+    int qp_num; // QPs in use, the client sizes them from its thread count
     uint32_t qpn[CLIENT_THREAD_NUM];
 };
 
@@ -39,7 +41,9 @@ struct ibv_context* open_device();
 struct ibv_pd* alloc_pd(struct ibv_context* ctx);
 struct ibv_cq* create_cq(struct ibv_context* ctx);
 struct ibv_qp* create_qp(struct ibv_pd* pd, struct ibv_cq* send_cq, struct ibv_cq* recv_cq);
-struct ibv_mr* register_mr(struct ibv_pd* pd, uint64_t mm, uint64_t mm_size);
+// odp registers without pinning, pages are faulted in on the first access of the NIC
+struct ibv_mr* register_mr(struct ibv_pd* pd, uint64_t mm, uint64_t mm_size, bool odp=false);
+bool odp_supported(struct ibv_context* ctx);
 
 bool query_attr(struct ibv_context* ctx, struct ibv_port_attr& attr, int& gid_idx, union ibv_gid& gid);
 bool modify_qp_state_to_init(struct ibv_qp* qp);
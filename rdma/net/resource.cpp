@@ -2,7 +2,7 @@
 
 struct ibv_context* open_device(){
     struct ibv_device** dev_list;
-    struct ibv_device* dev;
+    struct ibv_device* dev = nullptr;
     int flags;
     int dev_num;
 
@@ -13,7 +13,7 @@ struct ibv_context* open_device(){
     }
 
     for(int i=0; i<dev_num; i++){
-	if(ibv_get_device_name(dev_list[i])[5] == '2'){ // open mlx5_2
+	if(strcmp(ibv_get_device_name(dev_list[i]), IB_DEVICE) == 0){
 	    dev = dev_list[i];
 	    debug::notify_info("Opening %s\n", ibv_get_device_name(dev_list[i]));
 	    break;
@@ -89,8 +89,10 @@ struct ibv_qp* create_qp(struct ibv_pd* pd, struct ibv_cq* send_cq, struct ibv_c
     return qp;
 }
 
-struct ibv_mr* register_mr(struct ibv_pd* pd, uint64_t mm, uint64_t mm_size){
+struct ibv_mr* register_mr(struct ibv_pd* pd, uint64_t mm, uint64_t mm_size, bool odp){
     int flags = IBV_ACCESS_LOCAL_WRITE | IBV_ACCESS_REMOTE_READ | IBV_ACCESS_REMOTE_WRITE | IBV_ACCESS_REMOTE_ATOMIC;
+    if(odp)
+	flags |= IBV_ACCESS_ON_DEMAND;
     auto mr = ibv_reg_mr(pd, (void*)mm, mm_size, flags);
     if(!mr){
 	debug::notify_error("Failed to ibv_reg_mr");
@@ -99,6 +101,19 @@ struct ibv_mr* register_mr(struct ibv_pd* pd, uint64_t mm, uint64_t mm_size){
     return mr;
 }
 
+bool odp_supported(struct ibv_context* ctx){
+    struct ibv_device_attr_ex attr;
+    memset(&attr, 0, sizeof(attr));
+    if(ibv_query_device_ex(ctx, nullptr, &attr)){
+	debug::notify_error("Failed to ibv_query_device_ex");
+	return false;
+    }
+
+    // rpcs are sent from and received into MR 0, the rest is accessed with one-sided verbs
+    uint32_t rc_caps = IBV_ODP_SUPPORT_SEND | IBV_ODP_SUPPORT_RECV | IBV_ODP_SUPPORT_WRITE | IBV_ODP_SUPPORT_READ | IBV_ODP_SUPPORT_ATOMIC;
+    return (attr.odp_caps.general_caps & IBV_ODP_SUPPORT) && (attr.odp_caps.per_transport_caps.rc_odp_caps & rc_caps) == rc_caps;
+}
+
 bool modify_qp_state_to_init(struct ibv_qp* qp){
     struct ibv_qp_attr attr;
     memset(&attr, 0, sizeof(attr));
@@ -3,6 +3,8 @@
 #include "server/mr.h"
 #include "server/allocator.h"
 #include "server/transport.h"
+#include "common/timer.h"
+#include "common/topology.h"
 
 server_t::server_t(){
     if(!init_resources())
@@ -17,17 +19,32 @@ server_t::server_t(){
 bool server_t::init_resources(){
     bool ret = false;
 
+    Timer_t total, timer;
+    total.Start();
+    topology.init(IB_DEVICE);
+
     // create memory region
+    timer.Start();
     uint64_t memory_pool[MR_PARTITION_NUM];
     uint64_t memory_size[MR_PARTITION_NUM];
+    std::vector<std::thread> threads;
     for(int i=0; i<MR_PARTITION_NUM; i++){
-	mem[i] = new server_mr_t();
-	memory_pool[i] = mem[i]->get_memory_pool();
-	memory_size[i] = mem[i]->get_memory_size();
+	threads.emplace_back([&, i]{
+	    mem[i] = new server_mr_t();
+	    topology.bind_node((void*)mem[i]->get_memory_pool(), mem[i]->get_memory_size(), topology.partition_node(i));
+	    memory_pool[i] = mem[i]->get_memory_pool();
+	    memory_size[i] = mem[i]->get_memory_size();
+	});
     }
+    for(auto& t: threads) t.join();
+    timer.Stop();
+    debug::notify_info("[startup] allocated %d partitions in %.3f sec", MR_PARTITION_NUM, timer.Get() / 1000000000.0);
 
     // network transport
+    timer.Start();
     transport = new server_transport_t(memory_pool, memory_size);
+    timer.Stop();
+    debug::notify_info("[startup] device, QPs and MRs ready in %.3f sec", timer.Get() / 1000000000.0);
 
     // allocator (MR)
     for(int i=0; i<MR_PARTITION_NUM; i++){
@@ -45,6 +62,8 @@ bool server_t::init_resources(){
 	}
 	allocator[i] = new allocator_t(alloc_offset, memory_size[i] - msg_size - idx_size);
     }
+    total.Stop();
+    debug::notify_info("[startup] ready to accept clients after %.3f sec", total.Get() / 1000000000.0);
 
     ret = transport->setup_connection();
     if(!ret){
@@ -53,7 +72,7 @@ bool server_t::init_resources(){
     }
 
     // pre-post RDMA RECVs
-    for(int i=0; i<CLIENT_THREAD_NUM; i++){
+    for(int i=0; i<transport->get_qp_num(); i++){
 	auto recv_ptr = mem[0]->request_buffer_pool(i);
 	transport->prepost_recv((uint64_t)recv_ptr, sizeof(request_t), i);
     }
@@ -63,60 +82,62 @@ bool server_t::init_resources(){
 
 void server_t::handle_message(int tid){
     debug::notify_info("Running Thread %d", tid);
-    bind_core(CLIENT_THREAD_NUM-1 - tid);
+    // the linear layout keeps the handlers clear of the low cores
+    bind_core(PLACEMENT_POLICY == PLACE_LINEAR ? CLIENT_THREAD_NUM-1 - tid : topology.cpu(tid));
     struct ibv_wc wc[QP_DEPTH];
     while(true){
 	int cnt = transport->poll(wc, QP_DEPTH);
 	for(int i=0; i<cnt; i++){
 	    auto qp_id = wc[i].wr_id;
 	    auto request = mem[0]->request_buffer_pool(qp_id);
-	    handle_request(request);
+	    handle_request(request, qp_id);
 	    transport->prepost_recv((uint64_t)request, sizeof(request_t), qp_id);
 	}
     }
 }
 
-void server_t::handle_request(request_t* request){
-    auto send_ptr = mem[0]->response_buffer_pool(request->qp_id);
+// the reply goes back on the QP the request came in, request->qp_id is the client thread and several threads share a QP
+void server_t::handle_request(request_t* request, int qp_id){
+    auto send_ptr = mem[0]->response_buffer_pool(qp_id);
     response_t* response;
     switch(request->type){
         case request_type::IDX_ALLOC_NODE:{
             auto addr = allocator[request->pid]->alloc(PAGE_SIZE);
             if(addr)
-                response = create_message<response_t>(send_ptr, request->qp_id, response_type::SUCCESS, addr);
+                response = create_message<response_t>(send_ptr, qp_id, response_type::SUCCESS, addr);
             else
-                response = create_message<response_t>(send_ptr, request->qp_id, response_type::FAIL, addr);
+                response = create_message<response_t>(send_ptr, qp_id, response_type::FAIL, addr);
             break;
         }
 	case request_type::IDX_DEALLOC_NODE:{
 	    //idx_allocator->free(request->addr);
-	    response = create_message<response_t>(send_ptr, request->qp_id, response_type::SUCCESS);
+	    response = create_message<response_t>(send_ptr, qp_id, response_type::SUCCESS);
 	    break;
 	}
 	case request_type::IDX_UPDATE_ROOT:{
 	    assert(idx_cnt < MR_PARTITION_NUM);
 	    uint64_t* addr = mem[request->pid]->root_buffer_pool(idx_cnt);
 	    *addr = request->addr;
-	    response = create_message<response_t>(send_ptr, request->qp_id, response_type::SUCCESS, (uint64_t)addr);
+	    response = create_message<response_t>(send_ptr, qp_id, response_type::SUCCESS, (uint64_t)addr);
 	    idx_cnt++;
 	    break;
 	}
 	case request_type::TABLE_ALLOC_ROW:{
 	    auto addr = allocator[request->pid]->alloc(ROW_SIZE);
 	    if(addr)
-		response = create_message<response_t>(send_ptr, request->qp_id, response_type::SUCCESS, addr);
+		response = create_message<response_t>(send_ptr, qp_id, response_type::SUCCESS, addr);
 	    else
-		response = create_message<response_t>(send_ptr, request->qp_id, response_type::FAIL, addr);
+		response = create_message<response_t>(send_ptr, qp_id, response_type::FAIL, addr);
 	    break;
 	}
 	case request_type::TABLE_DEALLOC_ROW:{
 	    //row_allocator->free(request->addr);
-	    response = create_message<response_t>(send_ptr, request->qp_id, response_type::SUCCESS);
+	    response = create_message<response_t>(send_ptr, qp_id, response_type::SUCCESS);
 	    break;
 	}			      
         default:
             debug::notify_error("Unsupported request %d ... Implement me!", request->type);
     }
 
-    transport->send((uint64_t)response, sizeof(response_t), request->qp_id);
+    transport->send((uint64_t)response, sizeof(response_t), qp_id);
 }
@@ -20,7 +20,7 @@ class server_t{
 
     private:
 	void handle_message(int tid);
-        void handle_request(request_t* request);
+        void handle_request(request_t* request, int qp_id);
 
 	bool init_resources();
 
@@ -1,4 +1,8 @@
 #include "server/transport.h"
+#include "common/timer.h"
+
+#include <thread>
+#include <vector>
 
 server_transport_t::server_transport_t(uint64_t* mem_pool, uint64_t* mem_size){
     bool ret = init(mem_pool, mem_size);
@@ -36,9 +40,24 @@ bool server_transport_t::init(uint64_t* mem_pool, uint64_t* mem_size){
 	    goto CLEANUP;
     }
 
-    // create MR
+    // create MR, registration pins and faults in every page so the partitions go in parallel
+    {
+	bool odp = false;
+#ifdef MR_ODP
+	odp = odp_supported(context.ctx);
+	if(!odp)
+	    debug::notify_error("Device does not support on-demand paging for RC --- pinning MRs instead");
+#endif
+	Timer_t timer;
+	timer.Start();
+	std::vector<std::thread> threads;
+	for(int i=0; i<MR_PARTITION_NUM; i++)
+	    threads.emplace_back([&, i]{ mr[i] = register_mr(context.pd, mem_pool[i], mem_size[i], odp); });
+	for(auto& t: threads) t.join();
+	timer.Stop();
+	debug::notify_info("[startup] registered %d MRs%s in %.3f sec", MR_PARTITION_NUM, odp ? " (odp)" : "", timer.Get() / 1000000000.0);
+    }
     for(int i=0; i<MR_PARTITION_NUM; i++){
-	mr[i] = register_mr(context.pd, mem_pool[i], mem_size[i]);
 	if(!mr[i])
 	    goto CLEANUP;
     }
@@ -81,18 +100,30 @@ bool server_transport_t::setup_connection(){
     for(int i=0; i<MR_PARTITION_NUM; i++)
 	local.rkey[i] = mr[i]->rkey;
 
+    local.qp_num = CLIENT_THREAD_NUM;
     for(int i=0; i<CLIENT_THREAD_NUM; i++)
         local.qpn[i] = qp[i]->qp_num;
 
     server_listen(&local, &meta);
-    for(int i=0; i<CLIENT_THREAD_NUM; i++){
+    if(meta.qp_num <= 0 || meta.qp_num > CLIENT_THREAD_NUM){
+	debug::notify_error("Client requested %d QPs (at most %d)", meta.qp_num, CLIENT_THREAD_NUM);
+	return false;
+    }
+    qp_num = meta.qp_num;
+    for(int i=0; i<qp_num; i++){
         if(!modify_qp_state_to_rtr(qp[i], meta.gid, meta.gid_idx, meta.lid, meta.qpn[i]))
             return false;
         if(!modify_qp_state_to_rts(qp[i]))
             return false;
     }
 
-    debug::notify_info("Connected to Client");
+    // unused QPs would only take space in the NIC's context cache
+    for(int i=qp_num; i<CLIENT_THREAD_NUM; i++){
+	ibv_destroy_qp(qp[i]);
+	qp[i] = nullptr;
+    }
+
+    debug::notify_info("Connected to Client with %d QPs", qp_num);
     return true;
 }
 
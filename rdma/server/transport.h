@@ -11,6 +11,8 @@ class server_transport_t{
 	void prepost_recv(uint64_t ptr, int size, int qp_id);
 	void send(uint64_t ptr, int size, int qp_id);
 	int poll(struct ibv_wc* wc, int num);
+	// QPs the client brought up, the rest are released after the connection
+	int get_qp_num(){ return qp_num; }
 
     private:
 	struct rdma_ctx context;
@@ -19,6 +21,7 @@ class server_transport_t{
 	struct ibv_cq* send_cq;
 	struct ibv_cq* recv_cq;
 	struct ibv_mr* mr[MR_PARTITION_NUM];
+	int qp_num = CLIENT_THREAD_NUM;
 };
 
 
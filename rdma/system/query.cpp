@@ -3,6 +3,7 @@
 #include "system/workload.h"
 #include "benchmark/ycsb_query.h"
 #include "benchmark/tpcc_query.h"
+#include "common/topology.h"
 
 #include <vector>
 #include <thread>
@@ -29,7 +30,7 @@ base_query_t* query_queue_t::get_next_query(int tid){
 
 void query_queue_t::thread_init_query(void* This, int tid){
     query_queue_t* query_queue = (query_queue_t*)This;
-    bind_core(tid);
+    bind_core(topology.cpu(tid));
 
     query_queue->init_per_thread(tid);
 }
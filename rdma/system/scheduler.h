@@ -0,0 +1,44 @@
+#pragma once
+#include "common/global.h"
+#include <random>
+
+class base_query_t;
+
+// aborted txn parked until its backoff expires
+struct retry_entry_t{
+    base_query_t* query;
+    uint64_t txn_start;
+    uint64_t deadline;
+    uint32_t abort_cnt;
+};
+
+// per-thread retry scheduler: instead of sleeping on abort, the aborted txn
+// is deferred and the thread keeps running new txns until its backoff expires
+class retry_scheduler_t{
+    public:
+	void init(int tid);
+
+	// backoff (ns) for the given retry, grows with repeated conflicts on the same key
+	uint64_t next_backoff(uint32_t abort_cnt, uint64_t conflict_key);
+	// park an aborted txn, returns false if the retry queue is full
+	bool defer(base_query_t* query, uint64_t txn_start, uint32_t abort_cnt, uint64_t deadline);
+	// pop the deferred txn with the earliest expired deadline
+	bool ready(retry_entry_t& entry, uint64_t now);
+
+	bool empty(){
+	    return deferred_cnt == 0;
+	}
+
+    private:
+	uint32_t conflict_level(uint64_t key);
+	void record_conflict(uint64_t key);
+
+	retry_entry_t deferred[RETRY_QUEUE_SIZE];
+	int deferred_cnt;
+
+	// ring of recently conflicting keys
+	uint64_t conflicts[CONFLICT_HISTORY];
+	uint32_t conflict_idx;
+
+	std::mt19937 rng;
+};
@@ -1,10 +1,12 @@
 #include "system/thread.h"
 #include "system/query.h"
+#include "system/scheduler.h"
 #include "system/txn.h"
 #include "system/workload.h"
 #include "benchmark/ycsb_query.h"
 #include "benchmark/ycsb.h"
 #include "common/stat.h"
+#include "common/topology.h"
 #include <functional>
 #include <random>
 
@@ -18,7 +20,7 @@ int thread_t::get_tid(){
 }
 
 void thread_t::run(){
-    bind_core(tid);
+    bind_core(topology.cpu(tid));
 
     RC rc = RCOK;
     // get txn man from workload
@@ -26,28 +28,52 @@ void thread_t::run(){
     rc = workload->get_txn_man(m_txn, this);
     assert(rc == RCOK);
 
+    // aborted txns are deferred here while the thread runs the next ones
+    retry_scheduler_t scheduler;
+    scheduler.init(tid);
+    retry_entry_t entry;
+
     base_query_t* m_query = nullptr;
     uint64_t txn_cnt = 0;
     uint64_t abort_cnt = 0;
-    uint64_t cur_abort_cnt = 0;
+    uint64_t retry_cnt = 0;
+    uint64_t defer_cnt = 0;
+    uint32_t cur_abort_cnt = 0;
     uint64_t start, end;
     uint64_t txn_start_time = 0;
 
     while(true){
 	uint64_t start_time = asm_rdtsc();
-	if(rc == RCOK){
-	    m_query = query_queue->get_next_query(tid);
-	    m_query->timestamp = start_time;
-	    txn_start_time = start_time;
-	    cur_abort_cnt = 0;
-	}
-	else{ // backoff
+	bool deferred = false;
+	if(rc != RCOK){ // backoff
 	    cur_abort_cnt++;
-	    uint64_t backoff = cur_abort_cnt * BACKOFF;
-	    usleep(backoff / 1000);
+	    uint64_t backoff = scheduler.next_backoff(cur_abort_cnt, m_txn->conflict_key);
+	    deferred = scheduler.defer(m_query, txn_start_time, cur_abort_cnt, start_time + backoff);
+	    if(!deferred){ // retry queue is full, back off in place
+		usleep(backoff / 1000);
+		retry_cnt++;
+	    }
+	}
+
+	if(rc == RCOK || deferred){
+	    if(scheduler.ready(entry, start_time)){ // backoff expired, retry with the original timestamp
+		m_query = entry.query;
+		txn_start_time = entry.txn_start;
+		cur_abort_cnt = entry.abort_cnt;
+		retry_cnt++;
+	    }
+	    else{
+		if(!scheduler.empty())
+		    defer_cnt++;
+		m_query = query_queue->get_next_query(tid);
+		m_query->timestamp = start_time;
+		txn_start_time = start_time;
+		cur_abort_cnt = 0;
+	    }
 	}
 
 	rc = RCOK;
+	m_txn->conflict_key = 0;
 	rc = m_txn->run_txn(m_query);
 
 	uint64_t end_time = asm_rdtsc();
@@ -77,6 +103,8 @@ void thread_t::run(){
 	if(workload->sim_done.load()){
 	    ADD_STAT(tid, run_cnt, txn_cnt);
 	    ADD_STAT(tid, abort_cnt, abort_cnt);
+	    ADD_STAT(tid, retry_cnt, retry_cnt);
+	    ADD_STAT(tid, defer_cnt, defer_cnt);
 	    return;
 	}
     }
@@ -20,6 +20,7 @@ void txn_man_t::init(thread_t* thread, workload_t* workload, int tid){
     lock_ready = false;
     lock_abort = false;
     timestamp = 0;
+    conflict_key = 0;
     insert_cnt = 0;
     wr_cnt = 0;
     row_cnt = 0;
@@ -123,6 +124,7 @@ row_t* txn_man_t::get_row(uint64_t row_addr, int tid, int pid, access_t type){
     //row_t* row = mem->row_buffer_pool(tid, rid);
     rc = row->get_row(type, this, row_addr, tid, pid);
     if(rc == ABORT){
+	conflict_key = row_addr;
 	return nullptr;
     }
 
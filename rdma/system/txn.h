@@ -39,6 +39,8 @@ class txn_man_t{
 	uint64_t insert_cnt;
 	uint64_t txn_id;
 	uint64_t timestamp;
+	// row address that aborted the last run (retry scheduler hint)
+	uint64_t conflict_key;
 
 	bool volatile lock_ready;
 	bool volatile lock_abort;
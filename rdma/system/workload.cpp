@@ -9,20 +9,22 @@
 #include "index/tree.h"
 #include "system/txn.h"
 #include "system/workload.h"
+#include "common/topology.h"
 
 RC workload_t::init(config_t* conf){
     this->conf = conf;
     sim_done.store(false);
 
-    mem = new client_mr_t();
-    uint64_t mem_pool[CLIENT_THREAD_NUM];
-    uint64_t mem_size[CLIENT_THREAD_NUM];
-    for(int i=0; i<CLIENT_THREAD_NUM; i++){
-	mem_pool[i] = mem->get_memory_pool(i);
-	mem_size[i] = mem->get_memory_size(i);
-    }
+    topology.init(IB_DEVICE);
 
-    transport = new client_transport_t(conf, mem_pool, mem_size);
+    // loaders and workers use the same per-thread buffers and QPs, sized by the run threads
+    int thread_num = g_run_parallelism;
+    if(g_init_parallelism > (uint64_t)thread_num){
+	debug::notify_info("Loading with %d threads instead of %lu", thread_num, g_init_parallelism);
+	g_init_parallelism = thread_num;
+    }
+    mem = new client_mr_t(thread_num);
+    transport = new client_transport_t(conf, mem->get_memory_pool(), mem->get_memory_size(), thread_num);
     return RCOK;
 }
 
@@ -90,9 +92,10 @@ RC workload_t::init_schema(std::string path){
 	    }
 
 	    std::string table_name(items[0]);
-	    tree_t<Key, Value>* index = new tree_t<Key, Value>(mem, transport);
+	    // indexes go round-robin over the memory servers, a tree stays within one partition
+	    int pid = (cur_pid % SERVER_NUM) * MR_PARTITION_NUM;
+	    tree_t<Key, Value>* index = new tree_t<Key, Value>(mem, transport, pid);
 	    indexes[index_name] = index;
-	    // TODO pid for TPCC
 	    cur_pid++;
 	}
     }
@@ -7,6 +7,7 @@
 #include "net/config.h"
 #include "index/tree.h"
 #include "index/node.h"
+#include "common/topology.h"
 #include <vector>
 #include <thread>
 #include <algorithm>
@@ -169,7 +170,7 @@ void generate_workload(operation_t* init_ops, operation_t* run_ops){
 
 void load(operation_t* ops){
     auto load = [ops](int tid){
-	bind_core(tid);
+	bind_core(topology.cpu(tid));
 	int chunk = g_synth_table_size / g_run_parallelism;
 	int from = chunk * tid;
 	int to = chunk * (tid + 1);
@@ -183,7 +184,7 @@ void load(operation_t* ops){
 
     int build_thread_num = 64;
     auto fast_load = [ops, build_thread_num](int tid){
-	bind_core(tid);
+	bind_core(topology.cpu(tid));
 	int chunk = g_synth_table_size / build_thread_num;
 	int from = chunk * tid;
 	int to = chunk * (tid + 1);
@@ -216,7 +217,7 @@ void run(operation_t* ops){
     int not_found[g_run_parallelism];
     memset(not_found, 0, sizeof(int) * g_run_parallelism);
     auto func = [ops, &not_found](int tid){
-	bind_core(tid);
+	bind_core(topology.cpu(tid));
 	int chunk = g_synth_table_size / g_run_parallelism;
 	int from = chunk * tid;
 	int to = chunk * (tid + 1);
@@ -259,7 +260,8 @@ int main(int argc, char* argv[]){
     std::string path = "../host.txt";
     config_t* config = new config_t(path);
 
-    idx = new idx_wrapper_t(config);
+    // the fast load runs 64 threads regardless of --threads
+    idx = new idx_wrapper_t(config, std::max<int>(g_run_parallelism, 64));
 
     std::cout << "Creating workload ...";
     auto init_ops = new operation_t[g_synth_table_size];
@@ -52,6 +52,14 @@ uint64_t URand(uint64_t x, uint64_t y, uint64_t thd_id) {
     return x + RAND(y - x + 1, thd_id);
 }
 
+uint64_t NURand_C(uint64_t A) {
+    drand48_data buffer;
+    int64_t rint64 = 0;
+    srand48_r(NURAND_SEED + A, &buffer);
+    lrand48_r(&buffer, &rint64);
+    return rint64 % (A + 1);
+}
+
 uint64_t NURand(uint64_t A, uint64_t x, uint64_t y, uint64_t thd_id) {
     static bool C_255_init = false;
     static bool C_1023_init = false;
@@ -68,14 +76,14 @@ uint64_t NURand(uint64_t A, uint64_t x, uint64_t y, uint64_t thd_id) {
 	    break;
 	case 1023:
 	    if(!C_1023_init) {
-		C_1023 = (uint64_t) URand(0,1023, thd_id);
+		C_1023 = NURand_C(1023);
 		C_1023_init = true;
 	    }
 	    C = C_1023;
 	    break;
 	case 8191:
 	    if(!C_8191_init) {
-		C_8191 = (uint64_t) URand(0,8191, thd_id);
+		C_8191 = NURand_C(8191);
 		C_8191_init = true;
 	    }
 	    C = C_8191;
@@ -117,3 +125,11 @@ uint64_t wh_to_part(uint64_t wid) {
     return wid % g_part_cnt;
 }
 
+int wh_to_node(uint64_t wid) {
+    return (wid - 1) % DPU_NUM;
+}
+
+uint64_t node_wh_num(int node) {
+    return g_num_wh / DPU_NUM + ((uint64_t)node < g_num_wh % DPU_NUM);
+}
+
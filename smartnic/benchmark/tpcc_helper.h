@@ -18,6 +18,8 @@ extern drand48_data ** tpcc_buffer;
 uint64_t RAND(uint64_t max, uint64_t thd_id);
 // random number from [x, y]
 uint64_t URand(uint64_t x, uint64_t y, uint64_t thd_id);
+// fixed run-time constant of NURand for item (8191) and customer (1023) ids
+uint64_t NURand_C(uint64_t A);
 // non-uniform random number
 uint64_t NURand(uint64_t A, uint64_t x, uint64_t y, uint64_t thd_id);
 // random string with random length beteen min and max.
@@ -25,4 +27,7 @@ uint64_t MakeAlphaString(int min, int max, char * str, uint64_t thd_id);
 uint64_t MakeNumberString(int min, int max, char* str, uint64_t thd_id);
 
 uint64_t wh_to_part(uint64_t wid);
+// warehouses are dealt round-robin to the memory nodes, items are replicated on each of them
+int wh_to_node(uint64_t wid);
+uint64_t node_wh_num(int node);
 
@@ -0,0 +1,45 @@
+#include "client/batcher.h"
+#include <algorithm>
+
+#ifdef BATCH
+
+void batch_policy_t::init(){
+    max_size = std::max(1, std::min(g_batch_size, BATCH_THREAD_NUM));
+    adaptive = g_batch_adaptive;
+    size = adaptive ? 1 : max_size; // latency first until the DPU backs up
+    deadline = g_batch_deadline * 1000;
+    oldest = 0;
+    outstanding = 0;
+}
+
+bool batch_policy_t::flush(int pending, uint64_t now){
+    if(pending == 0){
+	oldest = 0;
+	return false;
+    }
+    if(oldest == 0)
+	oldest = now;
+    return pending >= size || now - oldest >= deadline;
+}
+
+void batch_policy_t::sent(int num){
+    adapt();
+    outstanding += num;
+    oldest = 0;
+}
+
+void batch_policy_t::received(int num){
+    outstanding -= num;
+}
+
+// a deep queue at the DPU favors fewer and larger messages, an idle one favors latency
+void batch_policy_t::adapt(){
+    if(!adaptive)
+	return;
+    if(outstanding >= size * 2)
+	size = std::min(size * 2, max_size);
+    else if(outstanding == 0)
+	size = std::max(size / 2, 1);
+}
+
+#endif // end of BATCH
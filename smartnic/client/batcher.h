@@ -0,0 +1,28 @@
+#pragma once
+#include "common/global.h"
+
+// flush policy of a batching network thread (BATCH)
+// the pending requests go out once they reach the size threshold or the oldest of them has
+// waited for the deadline, with feedback the threshold doubles while the DPU still holds
+// more than two batches of the thread and halves once it has drained
+class batch_policy_t{
+    public:
+	void init();
+
+	// pending: requests buffered by the clients of the thread, now in ns
+	bool flush(int pending, uint64_t now);
+	void sent(int num);
+	void received(int num);
+
+	int get_size(){ return size; }
+
+    private:
+	void adapt();
+
+	int size; // current threshold
+	int max_size;
+	uint64_t deadline; // ns
+	bool adaptive;
+	uint64_t oldest; // when the first pending request was seen, 0 if none is pending
+	int outstanding; // sent requests not answered yet, the depth of the thread at the DPU
+};
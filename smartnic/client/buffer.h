@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common/global.h"
+#include "common/rpc.h"
 
 template <typename Key_t>
 struct txn_request_frame_t{
@@ -10,6 +11,8 @@ struct txn_request_frame_t{
     int num; // used for commit
     uint64_t timestamp;
     Key_t key;
+    tpcc_request_type_t tpcc_type; // used for tpcc requests
+    int pid;
     char data[ROW_SIZE * MAX_ROW_PER_TXN];
 
     txn_request_frame_t(): valid(false){ }
@@ -22,6 +25,12 @@ struct txn_request_frame_t{
 	valid.store(true);
     }
 
+    void update(int _tid, access_t _type, tpcc_request_type_t _tpcc_type, int _pid, uint64_t _timestamp, Key_t _key){ // tpcc request
+	tpcc_type = _tpcc_type;
+	pid = _pid;
+	update(_tid, _type, _timestamp, _key);
+    }
+
     void update(int _tid, access_t _type, uint64_t _timestamp){ // commit request (read-only)
 	tid = _tid;
 	type = _type;
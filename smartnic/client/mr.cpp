@@ -54,16 +54,29 @@ client_mr_t::client_mr_t(){
     uint64_t query_msg = sizeof(rpc_request_t<Key>) + sizeof(rpc_response_t) * MAX_ROW_PER_TXN + sizeof(idx_request_t<Key, Value>) + sizeof(idx_response_t<Value>);
 
     uint64_t mem_size_per_thread = query_msg; 
+    #ifdef MULTI_DPU
+    mem_size_per_thread += sizeof(base_response_t) * DPU_NUM;
+    #endif
+    #ifdef RPC_RING
+    mem_size_per_thread += RING_CLIENT_META; // the transport's side of the request ring
+    #endif
     for(int i=0; i<CLIENT_THREAD_NUM; i++){
 	memory_region[i] = new memory_region_t(mem_size_per_thread);
 	memory_size[i] = memory_region[i]->size();
 	memory_pool[i] = reinterpret_cast<uint64_t>(memory_region[i]->ptr());
 
+	#ifdef RPC_RING
+	rpc_request_buffer[i] = reinterpret_cast<rpc_request_t<Key>*>(memory_pool[i] + RING_CLIENT_META);
+	#else
 	rpc_request_buffer[i] = reinterpret_cast<rpc_request_t<Key>*>(memory_pool[i]);
+	#endif
 	rpc_response_buffer[i] = reinterpret_cast<rpc_response_t*>((uint64_t)rpc_request_buffer[i] + sizeof(rpc_request_t<Key>));
 
 	idx_request_buffer[i] = reinterpret_cast<idx_request_t<Key, Value>*>((uint64_t)rpc_response_buffer[i] + sizeof(rpc_response_t));
 	idx_response_buffer[i] = reinterpret_cast<idx_response_t<Value>*>((uint64_t)idx_request_buffer[i] + sizeof(idx_request_t<Key, Value>));
+	#ifdef MULTI_DPU
+	vote_buffer[i] = reinterpret_cast<base_response_t*>((uint64_t)idx_response_buffer[i] + sizeof(idx_response_t<Value>));
+	#endif
     }
     #endif
 }
@@ -153,6 +166,12 @@ rpc_response_t* client_mr_t::rpc_response_buffer_pool(int tid, int rid){
     return reinterpret_cast<rpc_response_t*>((uint64_t)rpc_response_buffer[tid] + sizeof(rpc_response_t) * rid);
 }
 
+#ifdef MULTI_DPU
+base_response_t* client_mr_t::vote_buffer_pool(int tid, int node){
+    return &vote_buffer[tid][node];
+}
+#endif
+
 idx_request_t<Key, Value>* client_mr_t::idx_request_buffer_pool(int tid){
     return idx_request_buffer[tid];
 }
@@ -47,6 +47,9 @@ class client_mr_t{
 	idx_response_t<Value>* idx_response_buffer[CLIENT_THREAD_NUM];
 	rpc_request_t<Key>* rpc_request_buffer[CLIENT_THREAD_NUM];
 	rpc_response_t* rpc_response_buffer[CLIENT_THREAD_NUM];
+	#ifdef MULTI_DPU
+	base_response_t* vote_buffer[CLIENT_THREAD_NUM];
+	#endif
 	#endif
 
     public:
@@ -86,5 +89,9 @@ class client_mr_t{
 	idx_response_t<Value>* idx_response_buffer_pool(int tid);
 	rpc_request_t<Key>* rpc_request_buffer_pool(int tid);
 	rpc_response_t* rpc_response_buffer_pool(int tid, int rid);
+	#ifdef MULTI_DPU
+	// answers to the commit messages of a txn, one per DPU, the response buffers hold its writes
+	base_response_t* vote_buffer_pool(int tid, int node);
+	#endif
 	#endif
 };
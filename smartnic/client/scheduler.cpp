@@ -0,0 +1,78 @@
+#include "client/scheduler.h"
+#include "common/debug.h"
+
+void retry_scheduler_t::init(int tid){
+    deferred_cnt = 0;
+    conflict_idx = 0;
+    memset(conflicts, 0, sizeof(uint64_t) * CONFLICT_HISTORY);
+    rng.seed(tid + 1);
+}
+
+uint32_t retry_scheduler_t::conflict_level(uint64_t key){
+    if(key == 0) // unknown conflict
+	return 0;
+
+    uint32_t level = 0;
+    for(int i=0; i<CONFLICT_HISTORY; i++){
+	if(conflicts[i] == key)
+	    level++;
+    }
+    return level;
+}
+
+void retry_scheduler_t::record_conflict(uint64_t key){
+    if(key == 0)
+	return;
+    conflicts[conflict_idx] = key;
+    conflict_idx = (conflict_idx + 1) % CONFLICT_HISTORY;
+}
+
+uint64_t retry_scheduler_t::next_backoff(uint32_t abort_cnt, uint64_t conflict_key){
+    // a hot key counts as additional aborts
+    uint32_t level = abort_cnt + conflict_level(conflict_key);
+    record_conflict(conflict_key);
+
+#if RETRY_POLICY == RETRY_EXPONENTIAL
+    uint64_t window = BACKOFF;
+    for(uint32_t i=1; i<level && window < MAX_BACKOFF; i++)
+	window <<= 1;
+    if(window > MAX_BACKOFF)
+	window = MAX_BACKOFF;
+
+    // randomize within [window/2, window) to break up txns that keep colliding
+    return window / 2 + rng() % (window / 2);
+#elif RETRY_POLICY == RETRY_LINEAR
+    uint64_t backoff = level * BACKOFF;
+    return backoff < MAX_BACKOFF ? backoff : MAX_BACKOFF;
+#else
+    debug::notify_error("Unknown retry policy %d... Implement me!", RETRY_POLICY);
+    assert(false);
+    return 0;
+#endif
+}
+
+bool retry_scheduler_t::defer(base_query_t* query, uint64_t txn_start, uint32_t abort_cnt, uint64_t deadline){
+    if(deferred_cnt == RETRY_QUEUE_SIZE)
+	return false;
+
+    auto entry = &deferred[deferred_cnt++];
+    entry->query = query;
+    entry->txn_start = txn_start;
+    entry->abort_cnt = abort_cnt;
+    entry->deadline = deadline;
+    return true;
+}
+
+bool retry_scheduler_t::ready(retry_entry_t& entry, uint64_t now){
+    int idx = -1;
+    for(int i=0; i<deferred_cnt; i++){
+	if(deferred[i].deadline <= now && (idx == -1 || deferred[i].deadline < deferred[idx].deadline))
+	    idx = i;
+    }
+    if(idx == -1)
+	return false;
+
+    entry = deferred[idx];
+    deferred[idx] = deferred[--deferred_cnt];
+    return true;
+}
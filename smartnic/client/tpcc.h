@@ -2,6 +2,7 @@
 #include "common/global.h"
 #include "client/worker.h"
 #include "client/txn.h"
+#include "common/rpc.h"
 
 class config_t;
 class base_query_t;
@@ -9,6 +10,10 @@ class thread_t;
 class table_t;
 class txn_man_t;
 class tpcc_query_t;
+class row_t;
+template <typename Key_t>
+struct txn_request_frame_t;
+struct txn_response_frame_t;
 
 class tpcc_worker_t: public worker_t{
     public:
@@ -32,13 +37,6 @@ class tpcc_worker_t: public worker_t{
 
 class tpcc_txn_man_t: public txn_man_t{
     public:
-	#ifdef BATCH
-	void run_network_thread();
-	#elif defined BATCH2
-	void run_send(int tid);
-	void run_recv(int tid);
-	void run_network_thread();
-	#endif
 
 	void init(thread_t* thd, worker_t* worker, int tid);
 	RC run_txn(base_query_t* base_query);
@@ -50,5 +48,18 @@ class tpcc_txn_man_t: public txn_man_t{
         RC run_orderstatus(tpcc_query_t* m_query);
         RC run_delivery(tpcc_query_t* m_query);
         RC run_stocklevel(tpcc_query_t* m_query);
+	#ifdef DETERMINISTIC
+	RC schedule(tpcc_query_t* m_query, size_t request_size);
+	#endif
+	#ifdef STORED_PROC
+	RC run_proc(tpcc_query_t* m_query);
+	#endif
+	#if defined BATCH || defined BATCH2
+	// an access through the frames of the network thread, the granted row is copied to row
+	RC batch_access(tpcc_request_type_t tpcc_type, access_t type, Key key, int pid, uint64_t timestamp, row_t* row);
+	// commits with the num accessed rows in access order, the DPU installs the written ones
+	RC batch_commit(row_t* rows, int num, uint64_t timestamp);
+	void get_frames(txn_request_frame_t<Key>*& request, txn_response_frame_t*& response);
+	#endif
 };
 
@@ -13,6 +13,7 @@
 #include "client/txn.h"
 #include "client/mr.h"
 #include "client/transport.h"
+#include "client/buffer.h"
 
 #include "common/rpc.h"
 #include "common/stat.h"
@@ -43,7 +44,69 @@ RC tpcc_txn_man_t::run_txn(base_query_t* query){
 
 RC tpcc_txn_man_t::run_payment(tpcc_query_t* query){
 #if defined BATCH || defined BATCH2
-    return RCOK;
+    // the accesses go through the network thread, the rows stay in access order and are
+    // shipped back whole with the commit
+    RC rc = RCOK;
+    auto m_wl = worker;
+    uint64_t timestamp = query->timestamp;
+    row_t rows[3];
+    catalog_t* schema;
+    uint64_t key;
+
+    key = query->w_id;
+    rc = batch_access(TPCC_WAREHOUSE, g_wh_update ? WRITE : READ, key, m_wl->key_to_part(key), timestamp, &rows[0]);
+    if(rc != RCOK)
+	return rc;
+    if(g_wh_update){
+	double w_ytd;
+	schema = m_wl->t_warehouse->get_schema();
+	rows[0].get_value(schema, W_YTD, &w_ytd);
+	w_ytd += query->h_amount;
+	rows[0].set_value(schema, W_YTD, &w_ytd);
+    }
+
+    key = distKey(query->d_id, query->d_w_id);
+    rc = batch_access(TPCC_DISTRICT, WRITE, key, m_wl->key_to_part(key), timestamp, &rows[1]);
+    if(rc != RCOK)
+	return rc;
+    double d_ytd;
+    schema = m_wl->t_district->get_schema();
+    rows[1].get_value(schema, D_YTD, &d_ytd);
+    d_ytd += query->h_amount;
+    rows[1].set_value(schema, D_YTD, &d_ytd);
+
+    int pid = m_wl->key_to_part(distKey(query->c_d_id, query->c_w_id));
+    if(query->by_last_name)
+	rc = batch_access(TPCC_CUSTOMER_LASTNAME, WRITE, custNPKey(query->c_last, query->c_d_id, query->c_w_id), pid, timestamp, &rows[2]);
+    else
+	rc = batch_access(TPCC_CUSTOMER_ID, WRITE, custKey(query->c_id, query->c_d_id, query->c_w_id), pid, timestamp, &rows[2]);
+    if(rc != RCOK)
+	return rc;
+    double c_balance;
+    double c_ytd_payment;
+    uint64_t c_payment_cnt;
+    auto r_cust = &rows[2];
+    schema = m_wl->t_customer->get_schema();
+    r_cust->get_value(schema, C_BALANCE, &c_balance);
+    c_balance -= query->h_amount;
+    r_cust->set_value(schema, C_BALANCE, &c_balance);
+    r_cust->get_value(schema, C_YTD_PAYMENT, &c_ytd_payment);
+    c_ytd_payment += query->h_amount;
+    r_cust->set_value(schema, C_YTD_PAYMENT, &c_ytd_payment);
+    r_cust->get_value(schema, C_PAYMENT_CNT, &c_payment_cnt);
+    c_payment_cnt++;
+    r_cust->set_value(schema, C_PAYMENT_CNT, &c_payment_cnt);
+    auto c_credit = r_cust->get_value(schema, C_CREDIT);
+    if(strstr(c_credit, "BC") && !TPCC_SMALL){
+	char c_new_data[501];
+	sprintf(c_new_data, "| %zu %zu %zu %zu %zu $%7.2f",
+		query->c_id, query->c_d_id, query->c_w_id, query->d_id, query->w_id, query->h_amount);
+	r_cust->set_value(schema, "C_DATA", c_new_data);
+    }
+
+    return batch_commit(rows, 3, timestamp);
+#elif defined STORED_PROC
+    return run_proc(query);
 #else
     // declare all variables
     RC rc = RCOK;
@@ -73,7 +136,17 @@ RC tpcc_txn_man_t::run_payment(tpcc_query_t* query){
     rpc_response_t* response;
 
     size_t request_size = sizeof(base_request_t) + sizeof(int)*2 + sizeof(Key);
+#ifdef PROJECTION
+    request_size += sizeof(uint64_t);
+#endif
+#ifdef EARLY_LOCK_RELEASE
+    request_size += sizeof(int) * (MAX_RELEASE_PER_REQUEST + 1);
+    release_num = 0;
+#endif
     size_t response_size = sizeof(rpc_response_t);
+#ifdef DETERMINISTIC
+    schedule(query, request_size); // the accesses below are granted right away
+#endif
 
 #ifdef INTERACTIVE
     int base = 100;
@@ -102,17 +175,37 @@ RC tpcc_txn_man_t::run_payment(tpcc_query_t* query){
     //use index to retrieve that warehouse
     key = query->w_id;
     pid = m_wl->key_to_part(key);
+    route(wh_to_node(query->w_id));
+#ifdef COMMUTATIVE
+    if(g_wh_update){ // w_ytd is only added to, the worker adds it at commit
+	request = create_message<rpc_request_t<Key>>((void*)send_ptr, tid, DELTA, TPCC_WAREHOUSE, pid, key, timestamp);
+	transport->send((uint64_t)request, add_delta(request, m_wl->t_warehouse->get_schema(), W_YTD, query->h_amount), tid);
+    }
+    else{
+	request = create_message<rpc_request_t<Key>>((void*)send_ptr, tid, READ, TPCC_WAREHOUSE, pid, key, timestamp);
+#ifdef PROJECTION
+	request->cols = PROJ_COL(W_YTD) | PROJ_COL(W_NAME);
+#endif
+	transport->send((uint64_t)request, request_size, tid);
+    }
+#else
     if(g_wh_update)
 	request = create_message<rpc_request_t<Key>>((void*)send_ptr, tid, WRITE, TPCC_WAREHOUSE, pid, key, timestamp);
-    else
+    else{
 	request = create_message<rpc_request_t<Key>>((void*)send_ptr, tid, READ, TPCC_WAREHOUSE, pid, key, timestamp);
+#ifdef PROJECTION
+	request->cols = PROJ_COL(W_YTD) | PROJ_COL(W_NAME);
+#endif
+    }
     transport->send((uint64_t)request, request_size, tid);
+#endif
 
     auto recv_ptr = mem->rpc_response_buffer_pool(tid, step);
     response = create_message<rpc_response_t>((void*)recv_ptr);
     transport->recv((uint64_t)response, response_size, tid);
 
     if(response->type == ABORT){
+	conflict_key = key;
 	write_num = 0;
 	return ABORT;
     }
@@ -127,12 +220,17 @@ RC tpcc_txn_man_t::run_payment(tpcc_query_t* query){
     double w_ytd;
     schema = m_wl->t_warehouse->get_schema();
     auto r_wh = (row_t*)response->data;
+#ifdef PROJECTION
+    r_wh->unpack(schema, request->cols);
+#endif
     r_wh->get_value(schema, W_YTD, &w_ytd);
+#ifndef COMMUTATIVE
     if(g_wh_update){
         r_wh->set_value(schema, W_YTD, w_ytd + query->h_amount);
-	write_buf[write_num] = step;
-	write_num++;
+	add_write(step, schema, PROJ_COL(W_YTD));
+	release_early(step); // the hot warehouse row is final
     }
+#endif
     step++;
 
     tmp_str = r_wh->get_value(schema, W_NAME);
@@ -149,14 +247,21 @@ RC tpcc_txn_man_t::run_payment(tpcc_query_t* query){
       +=====================================================*/
     key = distKey(query->d_id, query->d_w_id);
     pid = m_wl->key_to_part(key);
+    route(wh_to_node(query->d_w_id));
+#ifdef COMMUTATIVE // d_ytd is only added to, the worker adds it at commit
+    request = create_message<rpc_request_t<Key>>((void*)send_ptr, tid, DELTA, TPCC_DISTRICT, pid, key, timestamp);
+    transport->send((uint64_t)request, add_delta(request, m_wl->t_district->get_schema(), D_YTD, query->h_amount), tid);
+#else
     request = create_message<rpc_request_t<Key>>((void*)send_ptr, tid, WRITE, TPCC_DISTRICT, pid, key, timestamp);
-    transport->send((uint64_t)request, request_size, tid);
+    transport->send((uint64_t)request, attach_release(request, request_size, tid), tid);
+#endif
 
     recv_ptr = mem->rpc_response_buffer_pool(tid, step);
     response = create_message<rpc_response_t>((void*)recv_ptr);
     transport->recv((uint64_t)response, response_size, tid);
 
     if(response->type == ABORT){
+        conflict_key = key;
         write_num = 0;
         return ABORT;
     }
@@ -172,12 +277,14 @@ RC tpcc_txn_man_t::run_payment(tpcc_query_t* query){
     schema = m_wl->t_district->get_schema();
     auto r_dist = (row_t*)response->data;
     r_dist->get_value(schema, D_YTD, &d_ytd);
-    r_dist->set_value(schema, D_YTD, d_ytd + query->h_amount);
     tmp_str = r_dist->get_value(schema, D_NAME);
     memcpy(d_name, tmp_str, 10);
     d_name[10] = '\0';
-    write_buf[write_num] = step;
-    write_num++;
+#ifndef COMMUTATIVE
+    r_dist->set_value(schema, D_YTD, d_ytd + query->h_amount);
+    add_write(step, schema, PROJ_COL(D_YTD));
+    release_early(step);
+#endif
     step++;
 
     /*====================================================================+
@@ -193,6 +300,7 @@ RC tpcc_txn_man_t::run_payment(tpcc_query_t* query){
 
     pid = m_wl->key_to_part(distKey(query->c_d_id, query->c_w_id));
     //pid = m_wl->key_to_part(query->c_d_id);
+    route(wh_to_node(query->c_w_id)); // a remote customer may live on another DPU
     if (query->by_last_name) {
         /*==========================================================+
           EXEC SQL SELECT count(c_id) INTO :namecnt
@@ -225,13 +333,14 @@ RC tpcc_txn_man_t::run_payment(tpcc_query_t* query){
         key = custKey(query->c_id, query->c_d_id, query->c_w_id);
 	request = create_message<rpc_request_t<Key>>((void*)send_ptr, tid, WRITE, TPCC_CUSTOMER_ID, pid, key, timestamp);
     }
-    transport->send((uint64_t)request, request_size, tid);
+    transport->send((uint64_t)request, attach_release(request, request_size, tid), tid);
 
     recv_ptr = mem->rpc_response_buffer_pool(tid, step);
     response = create_message<rpc_response_t>((void*)recv_ptr);
     transport->recv((uint64_t)response, response_size, tid);
 
     if(response->type == ABORT){
+        conflict_key = key;
         write_num = 0;
         return ABORT;
     }
@@ -256,6 +365,7 @@ RC tpcc_txn_man_t::run_payment(tpcc_query_t* query){
     r_cust->set_value(schema, C_YTD_PAYMENT, c_ytd_payment + query->h_amount);
     r_cust->get_value(schema, C_PAYMENT_CNT, &c_payment_cnt);
     r_cust->set_value(schema, C_PAYMENT_CNT, c_payment_cnt + 1);
+    uint64_t c_cols = PROJ_COL(C_BALANCE) | PROJ_COL(C_YTD_PAYMENT) | PROJ_COL(C_PAYMENT_CNT);
 
     c_credit = r_cust->get_value(schema, C_CREDIT);
     if ( strstr(c_credit, "BC") && !TPCC_SMALL ) {
@@ -273,9 +383,9 @@ RC tpcc_txn_man_t::run_payment(tpcc_query_t* query){
         //strncat(c_new_data, c_data, 500 - strlen(c_new_data));
         //c_new_data[500]='\0';
         r_cust->set_value(schema, "C_DATA", c_new_data);
+        c_cols |= PROJ_COL(C_DATA);
     }
-    write_buf[write_num] = step;
-    write_num++;
+    add_write(step, schema, c_cols);
     step++;
 
 
@@ -315,27 +425,92 @@ RC tpcc_txn_man_t::run_payment(tpcc_query_t* query){
     //END: [HISTORY] - WR
     */
 
-    request = create_message<rpc_request_t<Key>>((void*)send_ptr, tid, COMMIT_DATA);
-    request->num = write_num;
-    for(int i=0; i<write_num; i++){
-	memcpy(&request->data[sizeof(row_t)*i], mem->rpc_response_buffer_pool(tid, write_buf[i])->data, sizeof(row_t));
-    }
-    size_t commit_size = request_size + sizeof(row_t) * write_num;
-    transport->send((uint64_t)request, commit_size, tid);
-
-    recv_ptr = mem->rpc_response_buffer_pool(tid, 0);
-    response = create_message<rpc_response_t>((void*)recv_ptr);
-    transport->recv((uint64_t)response, response_size, tid);
-    rc = response->type;
-    write_num = 0;
-
+    rc = commit(tid);
     return rc;
 #endif
 }
 
 RC tpcc_txn_man_t::run_neworder(tpcc_query_t* query){
 #if defined BATCH || defined BATCH2
-    return RCOK;
+    RC rc = RCOK;
+    auto m_wl = worker;
+    uint64_t timestamp = query->timestamp;
+    uint64_t w_id = query->w_id;
+    uint64_t d_id = query->d_id;
+    assert(query->ol_cnt <= MAX_OL_PER_ORDER);
+    row_t rows[3 + 2 * MAX_OL_PER_ORDER];
+    int step = 0;
+    catalog_t* schema;
+    uint64_t key;
+
+    rc = batch_access(TPCC_WAREHOUSE, READ, w_id, m_wl->key_to_part(w_id), timestamp, &rows[step]);
+    if(rc != RCOK)
+	return rc;
+    double w_tax;
+    rows[step++].get_value(m_wl->t_warehouse->get_schema(), W_TAX, &w_tax);
+
+    key = distKey(d_id, w_id);
+    int pid = m_wl->key_to_part(key);
+    rc = batch_access(TPCC_DISTRICT, WRITE, key, pid, timestamp, &rows[step]);
+    if(rc != RCOK)
+	return rc;
+    int64_t o_id;
+    schema = m_wl->t_district->get_schema();
+    rows[step].get_value(schema, D_NEXT_O_ID, &o_id);
+    o_id++;
+    rows[step++].set_value(schema, D_NEXT_O_ID, &o_id);
+
+    rc = batch_access(TPCC_CUSTOMER_ID, READ, custKey(query->c_id, d_id, w_id), pid, timestamp, &rows[step]);
+    if(rc != RCOK)
+	return rc;
+    uint64_t c_discount;
+    rows[step++].get_value(m_wl->t_customer->get_schema(), C_DISCOUNT, &c_discount);
+
+    for(uint32_t ol_number=0; ol_number<query->ol_cnt; ol_number++){
+	uint64_t ol_i_id = query->items[ol_number].ol_i_id;
+	uint64_t ol_supply_w_id = query->items[ol_number].ol_supply_w_id;
+	int64_t ol_quantity = query->items[ol_number].ol_quantity;
+
+	rc = batch_access(TPCC_ITEM, READ, ol_i_id, m_wl->key_to_part(ol_i_id), timestamp, &rows[step]);
+	if(rc != RCOK)
+	    return rc;
+	int64_t i_price;
+	rows[step++].get_value(m_wl->t_item->get_schema(), I_PRICE, &i_price);
+
+	key = stockKey(ol_i_id, ol_supply_w_id);
+	rc = batch_access(TPCC_STOCK, WRITE, key, m_wl->key_to_part(key), timestamp, &rows[step]);
+	if(rc != RCOK)
+	    return rc;
+	auto r_stock = &rows[step++];
+	schema = m_wl->t_stock->get_schema();
+	int64_t s_quantity;
+	r_stock->get_value(schema, S_QUANTITY, &s_quantity);
+#if !TPCC_SMALL
+	int64_t s_ytd;
+	int64_t s_order_cnt;
+	r_stock->get_value(schema, S_YTD, &s_ytd);
+	s_ytd += ol_quantity;
+	r_stock->set_value(schema, S_YTD, &s_ytd);
+	r_stock->get_value(schema, S_ORDER_CNT, &s_order_cnt);
+	s_order_cnt++;
+	r_stock->set_value(schema, S_ORDER_CNT, &s_order_cnt);
+#endif
+	if(query->remote){
+	    int64_t s_remote_cnt;
+	    r_stock->get_value(schema, S_REMOTE_CNT, &s_remote_cnt);
+	    s_remote_cnt++;
+	    r_stock->set_value(schema, S_REMOTE_CNT, &s_remote_cnt);
+	}
+	if(s_quantity > ol_quantity + 10)
+	    s_quantity -= ol_quantity;
+	else
+	    s_quantity = s_quantity - ol_quantity + 91;
+	r_stock->set_value(schema, S_QUANTITY, &s_quantity);
+    }
+
+    return batch_commit(rows, step, timestamp);
+#elif defined STORED_PROC
+    return run_proc(query);
 #else
     RC rc = RCOK;
     uint64_t key;
@@ -361,7 +536,17 @@ RC tpcc_txn_man_t::run_neworder(tpcc_query_t* query){
 
 
     size_t request_size = sizeof(base_request_t) + sizeof(int)*2 + sizeof(Key);
+#ifdef PROJECTION
+    request_size += sizeof(uint64_t);
+#endif
+#ifdef EARLY_LOCK_RELEASE
+    request_size += sizeof(int) * (MAX_RELEASE_PER_REQUEST + 1);
+    release_num = 0;
+#endif
     size_t response_size = sizeof(rpc_response_t);
+#ifdef DETERMINISTIC
+    schedule(query, request_size); // the accesses below are granted right away
+#endif
 
 #ifdef INTERACTIVE
     int base = 100;
@@ -377,7 +562,11 @@ RC tpcc_txn_man_t::run_neworder(tpcc_query_t* query){
       +========================================================================*/
     key = w_id;
     pid = m_wl->key_to_part(key);
+    route(wh_to_node(w_id));
     request = create_message<rpc_request_t<Key>>((void*)send_ptr, tid, READ, TPCC_WAREHOUSE, pid, key, timestamp);
+#ifdef PROJECTION
+    request->cols = PROJ_COL(W_TAX);
+#endif
     transport->send((uint64_t)request, request_size, tid);
 
     auto recv_ptr = mem->rpc_response_buffer_pool(tid, step);
@@ -385,6 +574,7 @@ RC tpcc_txn_man_t::run_neworder(tpcc_query_t* query){
     transport->recv((uint64_t)response, response_size, tid);
 
     if(response->type == ABORT){
+	conflict_key = key;
 	write_num = 0;
 	return ABORT;
     }
@@ -398,6 +588,9 @@ RC tpcc_txn_man_t::run_neworder(tpcc_query_t* query){
 #endif
     schema = m_wl->t_warehouse->get_schema();
     auto r_wh = (row_t*)response->data;
+#ifdef PROJECTION
+    r_wh->unpack(schema, request->cols);
+#endif
 
     //retrieve the tax of warehouse
     double w_tax;
@@ -416,14 +609,21 @@ RC tpcc_txn_man_t::run_neworder(tpcc_query_t* query){
     +===================================================*/
     key = distKey(d_id, w_id);
     pid = m_wl->key_to_part(key);
+    route(wh_to_node(w_id));
+#ifdef COMMUTATIVE // d_next_o_id is only incremented, the worker hands out the next order id
+    request = create_message<rpc_request_t<Key>>((void*)send_ptr, tid, DELTA, TPCC_DISTRICT, pid, key, timestamp);
+    transport->send((uint64_t)request, add_delta(request, m_wl->t_district->get_schema(), D_NEXT_O_ID, (int64_t)1, true), tid);
+#else
     request = create_message<rpc_request_t<Key>>((void*)send_ptr, tid, WRITE, TPCC_DISTRICT, pid, key, timestamp);
     transport->send((uint64_t)request, request_size, tid);
+#endif
 
     recv_ptr = mem->rpc_response_buffer_pool(tid, step);
     response = create_message<rpc_response_t>((void*)recv_ptr);
     transport->recv((uint64_t)response, response_size, tid);
 
     if(response->type == ABORT){
+        conflict_key = key;
         write_num = 0;
         return ABORT;
     }
@@ -441,11 +641,13 @@ RC tpcc_txn_man_t::run_neworder(tpcc_query_t* query){
     int64_t o_id;
     //d_tax = *(double *) r_dist_local->get_value(D_TAX);
     o_id = *(int64_t *)r_dist->get_value(schema, D_NEXT_O_ID);
+#ifndef COMMUTATIVE
     o_id++;
     r_dist->set_value(schema, D_NEXT_O_ID, o_id);
 
-    write_buf[write_num] = step;
-    write_num++;
+    add_write(step, schema, PROJ_COL(D_NEXT_O_ID));
+    release_early(step); // the hot district row is final
+#endif
     step++;
 
 #ifdef INTERACTIVE
@@ -454,16 +656,21 @@ RC tpcc_txn_man_t::run_neworder(tpcc_query_t* query){
     //select customer
     key = custKey(c_id, d_id, w_id);
     pid = m_wl->key_to_part(distKey(d_id, w_id));
+    route(wh_to_node(w_id));
     //pid = m_wl->key_to_part(d_id);
 
     request = create_message<rpc_request_t<Key>>((void*)send_ptr, tid, READ, TPCC_CUSTOMER_ID, pid, key, timestamp);
-    transport->send((uint64_t)request, request_size, tid);
+#ifdef PROJECTION
+    request->cols = PROJ_COL(C_DISCOUNT) | PROJ_COL(C_LAST) | PROJ_COL(C_CREDIT);
+#endif
+    transport->send((uint64_t)request, attach_release(request, request_size, tid), tid);
 
     recv_ptr = mem->rpc_response_buffer_pool(tid, step);
     response = create_message<rpc_response_t>((void*)recv_ptr);
     transport->recv((uint64_t)response, response_size, tid);
 
     if(response->type == ABORT){
+        conflict_key = key;
         write_num = 0;
         return ABORT;
     }
@@ -477,6 +684,9 @@ RC tpcc_txn_man_t::run_neworder(tpcc_query_t* query){
 #endif
     schema = m_wl->t_customer->get_schema();
     auto r_cust = (row_t*)response->data;
+#ifdef PROJECTION
+    r_cust->unpack(schema, request->cols);
+#endif
 
     //retrieve data
     uint64_t c_discount;
@@ -542,8 +752,12 @@ RC tpcc_txn_man_t::run_neworder(tpcc_query_t* query){
 
         key = ol_i_id;
         pid = m_wl->key_to_part(key);
+        route(wh_to_node(w_id)); // items are replicated, read from the home DPU
 
 	request = create_message<rpc_request_t<Key>>((void*)send_ptr, tid, READ, TPCC_ITEM, pid, key, timestamp);
+#ifdef PROJECTION
+	request->cols = PROJ_COL(I_PRICE) | PROJ_COL(I_NAME) | PROJ_COL(I_DATA);
+#endif
 	transport->send((uint64_t)request, request_size, tid);
 
 	recv_ptr = mem->rpc_response_buffer_pool(tid, step);
@@ -551,6 +765,7 @@ RC tpcc_txn_man_t::run_neworder(tpcc_query_t* query){
 	transport->recv((uint64_t)response, response_size, tid);
 
 	if(response->type == ABORT){
+	    conflict_key = key;
 	    write_num = 0;
 	    return ABORT;
 	}
@@ -564,6 +779,9 @@ RC tpcc_txn_man_t::run_neworder(tpcc_query_t* query){
 #endif
 	auto r_item = (row_t*)response->data;
         schema = m_wl->t_item->get_schema();
+#ifdef PROJECTION
+	r_item->unpack(schema, request->cols);
+#endif
 
         int64_t i_price;
         r_item->get_value(schema, I_PRICE, &i_price);
@@ -591,6 +809,7 @@ RC tpcc_txn_man_t::run_neworder(tpcc_query_t* query){
 
         key = stockKey(ol_i_id, ol_supply_w_id);
         pid = m_wl->key_to_part(key);
+        route(wh_to_node(ol_supply_w_id));
 
 	request = create_message<rpc_request_t<Key>>((void*)send_ptr, tid, WRITE, TPCC_STOCK, pid, key, timestamp);
 	transport->send((uint64_t)request, request_size, tid);
@@ -600,6 +819,7 @@ RC tpcc_txn_man_t::run_neworder(tpcc_query_t* query){
 	transport->recv((uint64_t)response, response_size, tid);
 
 	if(response->type == ABORT){
+	    conflict_key = key;
 	    write_num = 0;
 	    return ABORT;
 	}
@@ -617,6 +837,7 @@ RC tpcc_txn_man_t::run_neworder(tpcc_query_t* query){
         // XXX s_dist_xx are not retrieved.
         int64_t s_remote_cnt;
         int64_t s_quantity = *(int64_t*)r_stock->get_value(schema, S_QUANTITY);
+        uint64_t s_cols = PROJ_COL(S_QUANTITY);
 #if !TPCC_SMALL
         /*
         auto s_dist_01=(char *)r_stock->get_value(S_DIST_01);
@@ -637,12 +858,14 @@ RC tpcc_txn_man_t::run_neworder(tpcc_query_t* query){
         r_stock->set_value(schema, S_YTD, s_ytd + ol_quantity);
         r_stock->get_value(schema, S_ORDER_CNT, &s_order_cnt);
         r_stock->set_value(schema, S_ORDER_CNT, s_order_cnt + 1);
+        s_cols |= PROJ_COL(S_YTD) | PROJ_COL(S_ORDER_CNT);
         //s_data = r_stock->get_value(S_DATA);
 #endif
         if(remote){
             s_remote_cnt = *(int64_t*)r_stock->get_value(schema, S_REMOTE_CNT);
             s_remote_cnt++;
             r_stock->set_value(schema, S_REMOTE_CNT, &s_remote_cnt);
+            s_cols |= PROJ_COL(S_REMOTE_CNT);
 	}
 
         uint64_t quantity;
@@ -654,8 +877,7 @@ RC tpcc_txn_man_t::run_neworder(tpcc_query_t* query){
         }
 
         r_stock->set_value(schema, S_QUANTITY, &quantity);
-	write_buf[write_num] = step;
-	write_num++;
+	add_write(step, schema, s_cols);
 	step++;
 
         /*====================================================+
@@ -719,24 +941,156 @@ RC tpcc_txn_man_t::run_neworder(tpcc_query_t* query){
         //insert_row(r_ol, _wl->t_orderline);
     }
 
-    request = create_message<rpc_request_t<Key>>((void*)send_ptr, tid, COMMIT_DATA);
-    request->num = write_num;
-    for(int i=0; i<write_num; i++){
-	memcpy(&request->data[sizeof(row_t)*i], mem->rpc_response_buffer_pool(tid, write_buf[i])->data, sizeof(row_t));
+    rc = commit(tid);
+    return rc;
+#endif
+}
+
+#ifdef DETERMINISTIC
+// deterministic mode: ship the read/write set before the first access, the DPU answers
+// once every lock of the set has been granted in epoch order
+RC tpcc_txn_man_t::schedule(tpcc_query_t* query, size_t request_size){
+    int tid = thread->get_tid();
+    auto send_ptr = mem->rpc_request_buffer_pool(tid);
+    auto request = create_message<rpc_request_t<Key>>((void*)send_ptr, tid, SCHEDULE, 0);
+    request->timestamp = query->timestamp;
+    auto set = (rpc_schedule_t<Key>*)request->data;
+    int num = 0;
+
+    // same rows in the same order as run_payment/run_neworder access them
+    if(query->type == TPCC_PAYMENT){
+	set[num++] = {TPCC_WAREHOUSE, g_wh_update ? WRITE : READ, query->w_id};
+	set[num++] = {TPCC_DISTRICT, WRITE, distKey(query->d_id, query->d_w_id)};
+	if(query->by_last_name)
+	    set[num++] = {TPCC_CUSTOMER_LASTNAME, WRITE, custNPKey(query->c_last, query->c_d_id, query->c_w_id)};
+	else
+	    set[num++] = {TPCC_CUSTOMER_ID, WRITE, custKey(query->c_id, query->c_d_id, query->c_w_id)};
     }
-    size_t commit_size = request_size + sizeof(row_t) * write_num;
-    transport->send((uint64_t)request, commit_size, tid);
+    else{
+	assert(query->type == TPCC_NEW_ORDER);
+	set[num++] = {TPCC_WAREHOUSE, READ, query->w_id};
+	set[num++] = {TPCC_DISTRICT, WRITE, distKey(query->d_id, query->w_id)};
+	set[num++] = {TPCC_CUSTOMER_ID, READ, custKey(query->c_id, query->d_id, query->w_id)};
+	for(uint32_t i=0; i<query->ol_cnt; i++){
+	    set[num++] = {TPCC_ITEM, READ, query->items[i].ol_i_id};
+	    set[num++] = {TPCC_STOCK, WRITE, stockKey(query->items[i].ol_i_id, query->items[i].ol_supply_w_id)};
+	}
+    }
+    request->num = num;
+    transport->send((uint64_t)request, request_size + sizeof(rpc_schedule_t<Key>) * num, tid);
+
+    auto recv_ptr = mem->rpc_response_buffer_pool(tid, 0);
+    auto response = create_message<rpc_response_t>((void*)recv_ptr);
+    transport->recv((uint64_t)response, sizeof(rpc_response_t), tid);
+    if(response->type == ERROR){
+	debug::notify_error("tid %d -- ERROR for read/write set", tid);
+	exit(0);
+    }
+    assert(response->type == RCOK);
+    return RCOK;
+}
+#endif
 
-    recv_ptr = mem->rpc_response_buffer_pool(tid, 0);
-    response = create_message<rpc_response_t>((void*)recv_ptr);
-    transport->recv((uint64_t)response, response_size, tid);
-    rc = response->type;
-    write_num = 0;
+#ifdef STORED_PROC
+// stored procedure: ship the parameters in one request, the DPU runs the whole txn and
+// only the outcome comes back
+RC tpcc_txn_man_t::run_proc(tpcc_query_t* query){
+    int tid = thread->get_tid();
+    auto send_ptr = mem->rpc_request_buffer_pool(tid);
+    auto request = create_message<rpc_request_t<Key>>((void*)send_ptr, tid, PROC, 0, query->timestamp);
+    auto args = (rpc_proc_t*)request->data;
+    args->type = query->type;
+    args->w_id = query->w_id;
+    args->d_id = query->d_id;
+    args->c_id = query->c_id;
+    args->d_w_id = query->d_w_id;
+    args->c_w_id = query->c_w_id;
+    args->c_d_id = query->c_d_id;
+    memcpy(args->c_last, query->c_last, LASTNAME_LEN);
+    args->h_amount = query->h_amount;
+    args->by_last_name = query->by_last_name;
+    args->remote = query->remote;
+    args->ol_cnt = 0;
+    if(query->type == TPCC_NEW_ORDER){
+	assert(query->ol_cnt <= MAX_OL_PER_ORDER);
+	args->ol_cnt = query->ol_cnt;
+	for(uint32_t i=0; i<query->ol_cnt; i++)
+	    args->items[i] = {query->items[i].ol_i_id, query->items[i].ol_supply_w_id, query->items[i].ol_quantity};
+    }
+    transport->send((uint64_t)request, request->data - (char*)request + sizeof(rpc_proc_t), tid);
 
-    return rc;
+    auto recv_ptr = mem->rpc_response_buffer_pool(tid, 0);
+    auto response = create_message<rpc_response_t>((void*)recv_ptr);
+    transport->recv((uint64_t)response, sizeof(rpc_response_t), tid);
+    if(response->type == ERROR){
+	debug::notify_error("tid %d -- ERROR for procedure %d", tid, query->type);
+	exit(0);
+    }
+    if(response->type == ABORT)
+	conflict_key = ((rpc_proc_result_t*)response->data)->conflict_key;
+    return response->type;
+}
 #endif
+
+#if defined BATCH || defined BATCH2
+void tpcc_txn_man_t::get_frames(txn_request_frame_t<Key>*& request, txn_response_frame_t*& response){
+    int tid = thread->get_tid();
+#ifdef BATCH
+    int net_tid = thread->get_network_tid();
+    request = mem->get_request_buffer(net_tid)->get_frame(tid % BATCH_THREAD_NUM);
+    response = mem->get_response_buffer(net_tid)->get_frame(tid % BATCH_THREAD_NUM);
+#else // BATCH2
+    int client_id = tid % CLIENT_THREAD_NUM;
+#ifdef PER_THREAD_BUFFER
+    request = mem->get_request_buffer(client_id / PER_BATCH_SIZE)->get_frame(client_id % PER_BATCH_SIZE);
+#else
+    request = mem->get_request_buffer()->get_frame(client_id);
+#endif
+    response = mem->get_response_buffer()->get_frame(client_id);
+#endif
+}
+
+RC tpcc_txn_man_t::batch_access(tpcc_request_type_t tpcc_type, access_t type, Key key, int pid, uint64_t timestamp, row_t* row){
+    int tid = thread->get_tid();
+    txn_request_frame_t<Key>* request;
+    txn_response_frame_t* response;
+    get_frames(request, response);
+
+    assert(response->validate() == false);
+    request->update(tid, type, tpcc_type, pid, timestamp, key);
+    response->wait();
+
+    RC rc = response->type;
+    if(rc == ABORT){
+	conflict_key = key;
+	response->reset();
+	return rc;
+    }
+    else if(rc == ERROR){
+	response->reset();
+	debug::notify_error("tid %d -- ERROR for %d access (key %lu)", tid, tpcc_type, key);
+	exit(0);
+    }
+    assert(rc == RCOK);
+    memcpy(row, response->data, sizeof(row_t));
+    response->reset();
+    return rc;
 }
 
+RC tpcc_txn_man_t::batch_commit(row_t* rows, int num, uint64_t timestamp){
+    int tid = thread->get_tid();
+    txn_request_frame_t<Key>* request;
+    txn_response_frame_t* response;
+    get_frames(request, response);
+
+    request->update(tid, COMMIT_DATA, num, timestamp, (char*)rows);
+    response->wait();
+    RC rc = response->type;
+    response->reset();
+    return rc;
+}
+#endif
+
 RC tpcc_txn_man_t::run_orderstatus(tpcc_query_t* query){
     return RCOK;
 }
@@ -749,14 +1103,3 @@ RC tpcc_txn_man_t::run_stocklevel(tpcc_query_t* query){
     return RCOK;
 }
 
-#ifdef BATCH
-void tpcc_txn_man_t::run_network_thread(){
-}
-#elif defined BATCH2
-void tpcc_txn_man_t::run_send(int tid){
-}
-void tpcc_txn_man_t::run_recv(int tid){
-}
-void tpcc_txn_man_t::run_network_thread(){
-}
-#endif
@@ -1,4 +1,5 @@
 #include "client/transport.h"
+#include "common/rpc.h"
 
 client_transport_t::client_transport_t(config_t* conf, uint64_t* mem_pool, uint64_t* mem_size): conf(conf){
     bool ret = init(mem_pool, mem_size);
@@ -81,7 +82,7 @@ bool client_transport_t::init(uint64_t* mem_pool, uint64_t* mem_size){
 
     #else
     // create CQs
-    for(int i=0; i<CLIENT_THREAD_NUM; i++){
+    for(int i=0; i<CLIENT_THREAD_NUM * DPU_NUM; i++){
 	send_cq[i] = create_cq(context.ctx);
         recv_cq[i] = create_cq(context.ctx);
         if(!send_cq[i] || !recv_cq[i])
@@ -89,7 +90,7 @@ bool client_transport_t::init(uint64_t* mem_pool, uint64_t* mem_size){
     }
 
     // create QPs
-    for(int i=0; i<CLIENT_THREAD_NUM; i++){
+    for(int i=0; i<CLIENT_THREAD_NUM * DPU_NUM; i++){
         qp[i] = create_qp(context.pd, send_cq[i], recv_cq[i]);
         if(!qp[i])
             goto CLEANUP;
@@ -103,6 +104,17 @@ bool client_transport_t::init(uint64_t* mem_pool, uint64_t* mem_size){
         if(!mr[i])
             goto CLEANUP;
     }
+    #ifdef MULTI_DPU
+    for(int i=0; i<CLIENT_THREAD_NUM; i++)
+	route_node[i] = 0;
+    #endif
+    #ifdef RPC_RING
+    for(int i=0; i<CLIENT_THREAD_NUM; i++){
+	ring_base[i] = mem_pool[i];
+	ring_tail[i] = 0;
+	ring_seq[i] = 0;
+    }
+    #endif
     #endif
 
     if(!setup_connection())
@@ -151,7 +163,7 @@ CLEANUP:
             ibv_dereg_mr(mr[i]);
     }
 
-    for(int i=0; i<CLIENT_THREAD_NUM; i++){
+    for(int i=0; i<CLIENT_THREAD_NUM * DPU_NUM; i++){
         if(qp[i])
             ibv_destroy_qp(qp[i]);
         if(send_cq[i])
@@ -182,12 +194,17 @@ bool client_transport_t::setup_connection(){
     #elif defined BATCH2
     for(int i=0; i<WORKER_THREAD_NUM; i++)
         local.qpn[i] = qp[i]->qp_num;
-    #else
-    for(int i=0; i<CLIENT_THREAD_NUM; i++)
-        local.qpn[i] = qp[i]->qp_num;
+    #endif
+    #ifdef RPC_RING
+    for(int i=0; i<CLIENT_THREAD_NUM; i++){
+	local.credit_addr[i] = ring_base[i] + RING_CLIENT_CREDIT;
+	local.rkey[i] = mr[i]->rkey;
+    }
     #endif
 
+    #if defined BATCH || defined BATCH2
     client_connect(conf->get_ip(0).c_str(), &local, &meta);
+    #endif
     #ifdef BATCH
     for(int i=0; i<NETWORK_THREAD_NUM; i++){
         if(!modify_qp_state_to_rtr(qp[i], meta.gid, meta.gid_idx, meta.lid, meta.qpn[i]))
@@ -203,11 +220,22 @@ bool client_transport_t::setup_connection(){
             return false;
     }
     #else
-    for(int i=0; i<CLIENT_THREAD_NUM; i++){
-        if(!modify_qp_state_to_rtr(qp[i], meta.gid, meta.gid_idx, meta.lid, meta.qpn[i]))
-            return false;
-        if(!modify_qp_state_to_rts(qp[i]))
-            return false;
+    // the DPUs of dpu.txt in node order, each one with its own set of connections
+    if(conf->get_server_num() < DPU_NUM){
+	debug::notify_error("dpu.txt lists %d DPUs, %d are needed", conf->get_server_num(), DPU_NUM);
+	return false;
+    }
+    for(int node=0; node<DPU_NUM; node++){
+	auto node_qp = &qp[CLIENT_THREAD_NUM * node];
+	for(int i=0; i<CLIENT_THREAD_NUM; i++)
+	    local.qpn[i] = node_qp[i]->qp_num;
+	client_connect(conf->get_ip(node).c_str(), &local, &meta);
+	for(int i=0; i<CLIENT_THREAD_NUM; i++){
+	    if(!modify_qp_state_to_rtr(node_qp[i], meta.gid, meta.gid_idx, meta.lid, meta.qpn[i]))
+		return false;
+	    if(!modify_qp_state_to_rts(node_qp[i]))
+		return false;
+	}
     }
     #endif
 
@@ -251,37 +279,84 @@ int client_transport_t::poll(int num, int qp_id, struct ibv_wc* wc){
 }
 #else
 void client_transport_t::recv(uint64_t ptr, int size, int qp_id){
-    rdma_recv(qp[qp_id], recv_cq[qp_id], ptr, size, mr[qp_id]->lkey);
+    rdma_recv(qp[conn(qp_id)], recv_cq[conn(qp_id)], ptr, size, mr[qp_id]->lkey);
 }
 
 void client_transport_t::prepost_recv(uint64_t ptr, int size, int qp_id, uint64_t wr_id){
-    rdma_recv_prepost(qp[qp_id], ptr, size, mr[qp_id]->lkey, wr_id);
+    rdma_recv_prepost(qp[conn(qp_id)], ptr, size, mr[qp_id]->lkey, wr_id);
 }
 
 void client_transport_t::prepost_recv(uint64_t ptr, int size, int qp_id){
-    rdma_recv_prepost(qp[qp_id], ptr, size, mr[qp_id]->lkey);
+    rdma_recv_prepost(qp[conn(qp_id)], ptr, size, mr[qp_id]->lkey);
+}
+
+#ifdef RPC_RING
+// the request is written as a frame at the tail of the client's ring on the worker, a request
+// too large for a frame leaves a descriptor and must stay untouched until its response arrives
+void client_transport_t::send(uint64_t ptr, int size, int qp_id){
+    auto frame = (char*)(ring_base[qp_id] + RING_CLIENT_FRAME);
+    auto header = (ring_header_t*)frame;
+    uint32_t len = size;
+    if(ring_frame_size(len) > RPC_RING_FRAME_MAX){
+	auto pull = (ring_pull_t*)(header + 1);
+	pull->addr = ptr;
+	pull->size = size;
+	len = sizeof(ring_pull_t);
+	header->len = len | RING_PULL;
+    }
+    else{
+	memcpy(header + 1, (void*)ptr, size);
+	header->len = len;
+    }
+    header->seq = ++ring_seq[qp_id];
+    uint32_t frame_size = ring_frame_size(len);
+    *(uint32_t*)&frame[frame_size - sizeof(uint32_t)] = header->seq;
+
+    // frames do not wrap, the rest of the ring is skipped with a marker
+    uint64_t offset = ring_tail[qp_id] % RPC_RING_SIZE;
+    uint64_t skip = (offset + frame_size > RPC_RING_SIZE) ? RPC_RING_SIZE - offset : 0;
+    auto credit = (volatile uint64_t*)(ring_base[qp_id] + RING_CLIENT_CREDIT);
+    while(ring_tail[qp_id] + skip + frame_size - *credit > RPC_RING_SIZE) // wait for credits
+	asm("nop");
+
+    uint64_t ring = meta.ring_addr + (uint64_t)RPC_RING_SIZE * qp_id;
+    if(skip){
+	auto wrap = (ring_header_t*)(ring_base[qp_id] + RING_CLIENT_WRAP);
+	wrap->len = RING_WRAP;
+	wrap->seq = header->seq;
+	post_write_inline(qp[qp_id], (uint64_t)wrap, ring + offset, sizeof(ring_header_t), meta.ring_rkey);
+	ring_tail[qp_id] += skip;
+	offset = 0;
+    }
+    rdma_write(qp[qp_id], send_cq[qp_id], (uint64_t)frame, ring + offset, frame_size, mr[qp_id]->lkey, meta.ring_rkey);
+    ring_tail[qp_id] += frame_size;
 }
 
+void client_transport_t::send_async(uint64_t ptr, int size, int qp_id){
+    send(ptr, size, qp_id);
+}
+#else
 void client_transport_t::send(uint64_t ptr, int size, int qp_id){
-    rdma_send(qp[qp_id], send_cq[qp_id], ptr, size, mr[qp_id]->lkey);
+    rdma_send(qp[conn(qp_id)], send_cq[conn(qp_id)], ptr, size, mr[qp_id]->lkey);
 }
 
 void client_transport_t::send_async(uint64_t ptr, int size, int qp_id){
-    rdma_send(qp[qp_id], ptr, size, mr[qp_id]->lkey);
+    rdma_send(qp[conn(qp_id)], ptr, size, mr[qp_id]->lkey);
 }
+#endif
 
 int client_transport_t::poll_sendcq(int num, int qp_id){
     struct ibv_wc wc[num];
-    return poll_cq_once(send_cq[qp_id], num, wc);
+    return poll_cq_once(send_cq[conn(qp_id)], num, wc);
 }
 
 int client_transport_t::poll(int num, int qp_id){
     struct ibv_wc wc[num];
-    return poll_cq_once(recv_cq[qp_id], num, wc);
+    return poll_cq_once(recv_cq[conn(qp_id)], num, wc);
 }
 
 int client_transport_t::poll(int num, int qp_id, struct ibv_wc* wc){
-    return poll_cq_once(recv_cq[qp_id], num, wc);
+    return poll_cq_once(recv_cq[conn(qp_id)], num, wc);
 }
 
 #endif
@@ -20,8 +20,21 @@ class client_transport_t{
 	int poll_sendcq(int num, int qp_id);
 	int poll(int num, int qp_id);
 	int poll(int num, int qp_id, struct ibv_wc* wc);
+	#ifdef MULTI_DPU
+	// the DPU the requests of a client thread go to until it is routed elsewhere
+	void route(int qp_id, int node){ route_node[qp_id] = node; }
+	#endif
 
     private:
+	// connection of a client thread to the DPU it is routed to
+	int conn(int qp_id){
+	    #ifdef MULTI_DPU
+	    return route_node[qp_id] * CLIENT_THREAD_NUM + qp_id;
+	    #else
+	    return qp_id;
+	    #endif
+	}
+
         struct rdma_ctx context;
         struct worker_client_meta meta;
 	#ifdef BATCH
@@ -36,11 +49,22 @@ class client_transport_t{
         struct ibv_mr* mr;
         //struct ibv_mr* mr[WORKER_THREAD_NUM];
 	#else
-        struct ibv_qp* qp[CLIENT_THREAD_NUM];
-        struct ibv_cq* send_cq[CLIENT_THREAD_NUM];
-        struct ibv_cq* recv_cq[CLIENT_THREAD_NUM];
+	// a connection per client thread and DPU, the memory of a thread is registered once
+        struct ibv_qp* qp[CLIENT_THREAD_NUM * DPU_NUM];
+        struct ibv_cq* send_cq[CLIENT_THREAD_NUM * DPU_NUM];
+        struct ibv_cq* recv_cq[CLIENT_THREAD_NUM * DPU_NUM];
         struct ibv_mr* mr[CLIENT_THREAD_NUM];
 	#endif
+	#ifdef MULTI_DPU
+	int route_node[CLIENT_THREAD_NUM];
+	#endif
+
+	#ifdef RPC_RING
+	// producer side of the request rings
+	uint64_t ring_base[CLIENT_THREAD_NUM]; // memory region of the client, see RING_CLIENT_*
+	uint64_t ring_tail[CLIENT_THREAD_NUM]; // bytes written into the worker's ring
+	uint32_t ring_seq[CLIENT_THREAD_NUM];
+	#endif
 
 	config_t* conf;
 };
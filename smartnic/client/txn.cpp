@@ -1,10 +1,14 @@
 #include "client/txn.h"
 #include "storage/row.h"
+#include "storage/catalog.h"
 #include "client/mr.h"
 #include "client/transport.h"
 #include "client/worker.h"
 #include "client/thread.h"
+#include "client/buffer.h"
+#include "client/batcher.h"
 #include "common/stat.h"
+#include "common/rpc.h"
 
 void txn_man_t::init(thread_t* thread, worker_t* worker, int tid){
     this->thread = thread;
@@ -13,10 +17,626 @@ void txn_man_t::init(thread_t* thread, worker_t* worker, int tid){
     this->transport = worker->transport;
 
     write_num = 0;
+    conflict_key = 0;
+    #ifdef MULTI_DPU
+    node = 0;
+    participants = 0;
+    #endif
+    #ifdef EARLY_LOCK_RELEASE
+    release_num = 0;
+    #endif
     memset(write_buf, 0, sizeof(int)*MAX_ROW_PER_TXN);
     //memset(write_buf, 0, sizeof(int)*REQUEST_PER_QUERY);
 }
 
+void txn_man_t::add_write(int step, catalog_t* schema, uint64_t cols){
+    write_buf[write_num] = step;
+#ifdef MULTI_DPU
+    write_node[write_num] = node;
+#endif
+#ifdef COLUMN_COMMIT
+    write_schema[write_num] = schema;
+    write_cols[write_num] = cols;
+#endif
+    write_num++;
+}
+
+#if !defined BATCH && !defined BATCH2
+// whole rows, or only the runs of columns each row changed, adjacent columns are merged
+// only the rows of the DPU the request is routed to are attached
+size_t txn_man_t::attach_writes(rpc_request_t<Key>* request, int tid){
+    int num = 0;
+#ifdef COLUMN_COMMIT
+    int col_num = 0;
+    auto ptr = request->data + sizeof(int);
+    commit_col_t* last = nullptr;
+    for(int i=0; i<write_num; i++){
+#ifdef MULTI_DPU
+	if(write_node[i] != node)
+	    continue;
+#endif
+	auto row = (row_t*)mem->rpc_response_buffer_pool(tid, write_buf[i])->data;
+	auto schema = write_schema[i];
+	for(int id=0; id<schema->get_field_cnt(); id++){
+	    if(!(write_cols[i] & PROJ_COL(id)))
+		continue;
+	    int offset = schema->get_field_index(id);
+	    int size = schema->get_field_size(id);
+	    if(last == nullptr || last->row != num || last->offset + last->size != offset){
+		last = (commit_col_t*)ptr;
+		last->row = num;
+		last->size = 0;
+		last->offset = offset;
+		col_num++;
+	    }
+	    memcpy((char*)(last + 1) + last->size, &row->data[offset], size);
+	    last->size += size;
+	    ptr = (char*)last + commit_col_size(last->size);
+	}
+	num++;
+    }
+    request->num = num;
+    *(int*)request->data = col_num;
+    return ptr - (char*)request;
+#else
+    for(int i=0; i<write_num; i++){
+#ifdef MULTI_DPU
+	if(write_node[i] != node)
+	    continue;
+#endif
+	memcpy(&request->data[sizeof(row_t)*num], mem->rpc_response_buffer_pool(tid, write_buf[i])->data, sizeof(row_t));
+	num++;
+    }
+    request->num = num;
+    return request->data - (char*)request + sizeof(row_t) * num;
+#endif
+}
+
+void txn_man_t::route(int node){
+#ifdef MULTI_DPU
+    this->node = node;
+    participants |= 1u << node;
+    transport->route(thread->get_tid(), node);
+#endif
+}
+
+// COMMIT_DATA with the rows written on the routed DPU, COMMIT if there are none
+static size_t commit_request(txn_man_t* txn, rpc_request_t<Key>* request, int tid){
+    request = create_message<rpc_request_t<Key>>((void*)request, tid, COMMIT_DATA);
+    size_t size = txn->attach_writes(request, tid);
+    if(request->num)
+	return size;
+    request->type = COMMIT;
+    return sizeof(base_request_t);
+}
+
+RC txn_man_t::commit(int tid){
+    auto request = mem->rpc_request_buffer_pool(tid);
+    RC rc = RCOK;
+#ifdef MULTI_DPU
+    if(participants & (participants - 1)){ // several DPUs, each of them votes first
+	uint32_t prepared = 0;
+	for(int n=0; n<DPU_NUM; n++){
+	    if(!(participants & (1u << n)))
+		continue;
+	    route(n);
+	    transport->send((uint64_t)create_message<rpc_request_t<Key>>((void*)request, tid, PREPARE), sizeof(base_request_t), tid);
+	}
+	for(int n=0; n<DPU_NUM; n++){
+	    if(!(participants & (1u << n)))
+		continue;
+	    route(n);
+	    auto vote = create_message<base_response_t>((void*)mem->vote_buffer_pool(tid, n));
+	    transport->recv((uint64_t)vote, sizeof(base_response_t), tid);
+	    if(vote->type == RCOK)
+		prepared |= 1u << n;
+	    else // rolled back on its own
+		rc = ABORT;
+	}
+
+	// the decision goes to every DPU that is still prepared
+	for(int n=0; n<DPU_NUM; n++){
+	    if(!(prepared & (1u << n)))
+		continue;
+	    route(n);
+	    if(rc == RCOK)
+		transport->send((uint64_t)request, commit_request(this, request, tid), tid);
+	    else
+		transport->send((uint64_t)create_message<rpc_request_t<Key>>((void*)request, tid, ABORT_ALL), sizeof(base_request_t), tid);
+	}
+	for(int n=0; n<DPU_NUM; n++){
+	    if(!(prepared & (1u << n)))
+		continue;
+	    route(n);
+	    auto ack = create_message<base_response_t>((void*)mem->vote_buffer_pool(tid, n));
+	    transport->recv((uint64_t)ack, sizeof(base_response_t), tid);
+	    assert(rc == ABORT || ack->type == RCOK); // a prepared txn cannot be wounded
+	}
+	participants = 0;
+	write_num = 0;
+	return rc;
+    }
+    if(participants)
+	route(__builtin_ctz(participants));
+#endif
+    transport->send((uint64_t)request, commit_request(this, request, tid), tid);
+
+    auto response = create_message<rpc_response_t>((void*)mem->rpc_response_buffer_pool(tid, 0));
+    transport->recv((uint64_t)response, sizeof(rpc_response_t), tid);
+    rc = response->type;
+#ifdef MULTI_DPU
+    participants = 0;
+#endif
+    write_num = 0;
+    return rc;
+}
+#endif
+
+#ifdef MULTI_DPU
+// the DPU that answered ABORT has rolled back on its own, the others are still holding locks
+void txn_man_t::rollback(int tid){
+    auto request = mem->rpc_request_buffer_pool(tid);
+    participants &= ~(1u << node);
+    for(int n=0; n<DPU_NUM; n++){
+	if(!(participants & (1u << n)))
+	    continue;
+	route(n);
+	transport->send((uint64_t)create_message<rpc_request_t<Key>>((void*)request, tid, ABORT_ALL), sizeof(base_request_t), tid);
+	auto ack = create_message<base_response_t>((void*)mem->vote_buffer_pool(tid, n));
+	transport->recv((uint64_t)ack, sizeof(base_response_t), tid);
+    }
+    participants = 0;
+    write_num = 0;
+}
+#endif
+
+void txn_man_t::release_early(int step){
+#ifdef EARLY_LOCK_RELEASE
+    if(release_num < MAX_RELEASE_PER_REQUEST)
+	release_buf[release_num++] = step;
+#endif
+}
+
+// piggyback the pending early releases on a lock request
+size_t txn_man_t::attach_release(rpc_request_t<Key>* request, size_t request_size, int tid){
+#ifdef EARLY_LOCK_RELEASE
+    request->release_num = release_num;
+    for(int i=0; i<release_num; i++){
+	request->release_idx[i] = release_buf[i];
+	memcpy(&request->data[sizeof(row_t) * i], mem->rpc_response_buffer_pool(tid, release_buf[i])->data, sizeof(row_t));
+    }
+    request_size += sizeof(row_t) * release_num;
+    release_num = 0;
+#endif
+    return request_size;
+}
+
+#ifdef COMMUTATIVE
+size_t txn_man_t::add_delta(rpc_request_t<Key>* request, catalog_t* schema, int col, int64_t value, bool fetch){
+    auto delta = (rpc_delta_t*)request->data;
+    delta->num = 1;
+    delta->ops[0].offset = schema->get_field_index(col);
+    delta->ops[0].type = DELTA_INT64;
+    delta->ops[0].fetch = fetch;
+    delta->ops[0].i = value;
+    return request->data - (char*)request + sizeof(rpc_delta_t);
+}
+
+size_t txn_man_t::add_delta(rpc_request_t<Key>* request, catalog_t* schema, int col, double value){
+    auto delta = (rpc_delta_t*)request->data;
+    delta->num = 1;
+    delta->ops[0].offset = schema->get_field_index(col);
+    delta->ops[0].type = DELTA_DOUBLE;
+    delta->ops[0].fetch = false;
+    delta->ops[0].d = value;
+    return request->data - (char*)request + sizeof(rpc_delta_t);
+}
+#endif
+
+#ifdef BATCH
+// forwards the frames of BATCH_THREAD_NUM client threads to the DPU in batches and hands
+// the responses back, the frames carry the workload fields so any workload can use it
+void txn_man_t::run_network_thread(){
+    auto tid = thread->get_tid();
+    assert(tid < NETWORK_THREAD_NUM);
+    //size_t NETWORK_SLEEP = 10; // sleep for 1 usec
+    size_t NETWORK_SLEEP = 1; // sleep for 1 usec
+    size_t base_size = sizeof(base_request_t) + sizeof(int);
+
+    size_t request_size = sizeof(rpc_request_t<Key>);
+    size_t response_size = sizeof(rpc_response_t);
+    size_t commit_size = sizeof(rpc_commit_t);
+
+    auto request_ptr = mem->rpc_request_pool(tid);
+    auto request = create_message<rpc_request_t<Key>>((void*)request_ptr, buffer_type_t::REQUEST_BUFFER, tid); // initialize request buffer
+
+    //for(int i=0; i<BATCH_THREAD_NUM+1; i++){
+    for(int i=0; i<CLIENT_THREAD_NUM; i++){
+    //for(int i=0; i<WORKER_THREAD_NUM; i++){
+	auto ptr = mem->rpc_response_pool(tid, i);
+	transport->prepost_recv((uint64_t)ptr, response_size, tid, i);
+    }
+    //auto response_ptr = mem->rpc_response_pool(tid);
+    //auto response = create_message<rpc_response_t>((void*)response_ptr, tid); // initialize response buffer
+    //transport->prepost_recv((uint64_t)response, response_size, tid);
+ 
+    auto commit_ptr = mem->rpc_commit_pool(tid);
+    auto commit = create_message<rpc_commit_t>((void*)commit_ptr, buffer_type_t::COMMIT_BUFFER, tid); // initialize commit buffer
+
+    int send_cnt = 0;
+    int recv_cnt = 0;
+    int recv_poll_size = BATCH_THREAD_NUM;
+    //int recv_poll_size = WORKER_THREAD_NUM;
+
+    auto request_buffer = mem->get_request_buffer(tid);
+    auto response_buffer = mem->get_response_buffer(tid);
+    batch_policy_t policy;
+    policy.init();
+
+    struct ibv_wc wc[recv_poll_size];
+    while(true){
+	// wake up
+
+	// check if there is any buffered txn request
+	int pending = 0;
+	for(int i=0; i<BATCH_THREAD_NUM; i++)
+	    pending += request_buffer->get_frame(i)->validate();
+	if(!send_cnt && policy.flush(pending, asm_rdtsc())){ // send next batch if previous batch has been processed
+	    int request_idx = 0;
+	    int commit_idx = 0;
+	    for(int i=0; i<BATCH_THREAD_NUM; i++){
+		auto frame = request_buffer->get_frame(i);
+		if(frame->validate()){
+		    assert(frame->tid % BATCH_THREAD_NUM == i);
+		    if(frame->type != COMMIT_DATA){
+			request->buffer[request_idx].update(frame->tid, frame->type, frame->tpcc_type, frame->pid, frame->timestamp, frame->key);
+			request_idx++;
+		    }
+		    else{ // commit 
+			commit->buffer[commit_idx].update(frame->tid, frame->num, frame->data);
+			commit_idx++;
+		    }
+		    int local_client_id = frame->tid % BATCH_THREAD_NUM;
+		    frame->reset();
+		}
+	    }
+
+	    if(request_idx){
+		request->num = request_idx;
+		//size_t request_size = base_size + sizeof(rpc_request_buffer_t<Key>)*request_idx;
+		//transport->send((uint64_t)request, request_size, tid);
+		transport->send_async((uint64_t)request, request_size, tid);
+		send_cnt++;
+	    }
+	    if(commit_idx){
+		commit->num = commit_idx;
+		//size_t commit_size = base_size + sizeof(rpc_commit_buffer_t)*commit_idx;
+		//transport->send((uint64_t)commit, commit_size, tid);
+		transport->send_async((uint64_t)commit, commit_size, tid);
+		send_cnt++;
+	    }
+	    policy.sent(request_idx + commit_idx);
+	}
+
+	recv_cnt = transport->poll(recv_poll_size, tid, wc);
+	//recv_cnt = transport->poll(recv_poll_size, tid, wc);
+	if(recv_cnt > 0){
+	    for(int i=0; i<recv_cnt; i++){
+		auto wr_id = wc[i].wr_id;
+		auto response = mem->rpc_response_pool(tid, wr_id);
+		int num = response->num;
+		policy.received(num);
+
+		for(int j=0; j<num; j++){
+		    auto res = response->get_buffer(j);
+		    int client_id = res->tid % BATCH_THREAD_NUM; // local tid
+		    auto frame = response_buffer->get_frame(client_id);
+
+		    while(frame->validate())
+			asm("nop");
+
+		    frame->update(res->tid, res->type, res->data);
+		    //frame->update(local_buffer->tid, local_buffer->type, local_buffer->timestamp, local_buffer->data, local_buffer->time_id, local_buffer->rid);
+		    //frame->update(local_buffer->tid, local_buffer->type, local_buffer->timestamp, local_buffer->data, local_buffer->time_id);
+		    //local_buffer->reset(); // debug -- this may not be necessary when correctly implemented
+		}
+
+		//auto _response = create_message<rpc_response_t>((void*)response, tid); // initialize response buffer
+		transport->prepost_recv((uint64_t)response, response_size, tid, wr_id);
+	    }
+	}
+
+	if(send_cnt){
+	    int poll_cnt = transport->poll_sendcq(send_cnt, tid);
+	    send_cnt -= poll_cnt;
+	}
+	//send_cnt = 0;
+
+	if(!pending) // a partial batch is waiting for its deadline
+	    usleep(NETWORK_SLEEP);
+    }
+}
+
+#elif defined BATCH2
+void txn_man_t::run_send(int tid){
+    size_t base_size = sizeof(base_request_t) + sizeof(int);
+
+    size_t request_size = sizeof(rpc_request_t<Key>);
+    size_t commit_size = sizeof(rpc_commit_t);
+
+    auto request_ptr = mem->rpc_request_pool(tid);
+    auto request = create_message<rpc_request_t<Key>>((void*)request_ptr, buffer_type_t::REQUEST_BUFFER, tid);
+    
+    auto commit_ptr = mem->rpc_commit_pool(tid);
+    auto commit = create_message<rpc_commit_t>((void*)commit_ptr, buffer_type_t::COMMIT_BUFFER, tid);
+
+#ifdef PER_THREAD_BUFFER
+    auto buffer = mem->get_request_buffer(tid);
+#else
+    auto buffer = mem->get_request_buffer();
+#endif
+    bool need_send = false;
+
+    //size_t NETWORK_SLEEP = 2; // sleep for X usec
+    //size_t NETWORK_SLEEP = 8; // sleep for X usec
+    size_t NETWORK_SLEEP = 10; // sleep for X usec
+    //size_t NETWORK_SLEEP = 10; // sleep for X usec
+    //size_t NETWORK_SLEEP = 5; // sleep for X usec
+
+    bool send_commit = false;
+    bool send_request = false;
+    int send_cnt = 0;
+    int request_idx = 0;
+    int commit_idx = 0;
+    int iter_commit = 0;
+    int iter_request = 0;
+    //int NUM_ITER = 50;
+    int NUM_ITER = 5;
+    //int NUM_ITER = 10;
+    //int NUM_ITER = 10;
+    //int NUM_ITER = 20;
+    //int NUM_ITER = 10;
+    //
+
+    uint64_t t_buffer, t_send, t_wait;
+    t_buffer = t_send = t_wait = 0;
+
+    uint64_t start, end;
+    start = asm_rdtsc();
+    while(true){
+	// wake up
+
+#ifdef PER_THREAD_BUFFER
+	for(int i=0; i<PER_BATCH_SIZE; i++){
+#else
+	for(int i=0; i<CLIENT_THREAD_NUM; i++){
+#endif
+	    auto frame = buffer->get_frame(i);
+	    if(frame->acquire()){
+		if(frame->type == COMMIT_DATA){
+		    commit->buffer[commit_idx].update(frame->tid, frame->num, frame->data);
+		    commit_idx++;
+//		    send_commit = true;
+#ifdef PER_THREAD_BUFFER
+		    if(commit_idx == PER_BATCH_SIZE){
+#else
+		    if(commit_idx == BATCH_SIZE){
+#endif
+			send_commit = true;
+			break;
+		    }
+		}
+		else{ // regular txn request
+		    request->buffer[request_idx].update(frame->tid, frame->type, frame->tpcc_type, frame->pid, frame->timestamp, frame->key);
+		    request_idx++;
+//		    send_request = true;
+#ifdef PER_THREAD_BUFFER
+		    if(request_idx == PER_BATCH_SIZE){
+#else
+		    if(request_idx == BATCH_SIZE){
+#endif
+			send_request = true;
+			break;
+		    }
+		}
+		// TODO: handle buffer overflow
+	    }
+	}
+
+	end = asm_rdtsc();
+	t_buffer += (end - start);
+	start = end;
+
+	if(send_commit){
+	    commit->num = commit_idx;
+	    size_t send_size = sizeof(rpc_commit_t);
+	    transport->send((uint64_t)commit, send_size, tid);
+	    commit_idx = 0;
+	    iter_commit = 0;
+	    //debug::notify_info("Sending full commits"); 
+	    
+	    end = asm_rdtsc();
+	    t_send += (end - start);
+	    start = end;
+	}
+
+	if(send_request){
+	    request->num = request_idx;
+	    size_t send_size = sizeof(rpc_request_t<Key>);
+	    transport->send((uint64_t)request, send_size, tid);
+	    request_idx = 0;
+	    iter_request = 0;
+	    //debug::notify_info("Sending full requests"); 
+	    
+	    end = asm_rdtsc();
+	    t_send += (end - start);
+	    start = end;
+	}
+	    
+
+	iter_commit++;
+	iter_request++;
+
+	if((commit_idx > 0) && (iter_commit > NUM_ITER)){
+	    commit->num = commit_idx;
+	    size_t send_size = base_size + sizeof(rpc_commit_buffer_t) * commit_idx;
+	    transport->send((uint64_t)commit, send_size, tid);
+	    commit_idx = 0;
+	    iter_commit = 0;
+	    send_commit = true;
+
+	    end = asm_rdtsc();
+	    t_send += (end - start);
+	    start = end;
+	}
+
+	if((request_idx > 0) && (iter_request > NUM_ITER)){
+	    request->num = request_idx;
+	    size_t send_size = base_size + sizeof(rpc_request_buffer_t<Key>) * request_idx;
+	    transport->send((uint64_t)request, send_size, tid);
+	    request_idx = 0;
+	    iter_request = 0;
+	    send_request = true;
+
+	    end = asm_rdtsc();
+	    t_send += (end - start);
+	    start = end;
+	}
+
+	if(send_request){
+#ifdef PER_THREAD_BUFFER
+	    if(request->num == PER_BATCH_SIZE)
+#else
+	    if(request->num == BATCH_SIZE)
+#endif
+		usleep(NETWORK_SLEEP);
+	    send_request = false;
+	    end = asm_rdtsc();
+	    t_wait += (end - start);
+	    start = end;
+
+	}
+	else if(send_commit){
+#ifdef PER_THREAD_BUFFER
+	    if(commit->num == PER_BATCH_SIZE)
+#else
+	    if(commit->num == BATCH_SIZE)
+#endif
+		usleep(NETWORK_SLEEP);
+	    send_commit = false;
+	    end = asm_rdtsc();
+	    t_wait += (end - start);
+	    start = end;
+
+	}
+	/*
+	if(send_request || send_commit){
+	    usleep(NETWORK_SLEEP);
+	    send_request = false;
+	    send_commit = false;
+
+	    end = asm_rdtsc();
+	    t_wait += (end - start);
+	    start = end;
+	}
+	*/
+
+	if(g_run_finish)
+	    break;
+    }
+
+    ADD_STAT(tid, time_send, t_send);
+    ADD_STAT(tid, time_wait_send, t_wait);
+    ADD_STAT(tid, time_buffer_send, t_buffer);
+}
+
+void txn_man_t::run_recv(int tid){
+    //debug::notify_info("tid %d running recv", tid);
+
+    auto buffer = mem->get_response_buffer();
+    //size_t NETWORK_SLEEP = 2;
+    //size_t NETWORK_SLEEP = 8;
+    size_t NETWORK_SLEEP = 10;
+    //size_t NETWORK_SLEEP = 10;
+
+    //auto ptr = mem->rpc_response_pool(tid);
+    //transport->prepost_recv((uint64_t)ptr, sizeof(rpc_response_t), tid, tid);
+
+    int recv_poll_size = 4;
+    //int recv_poll_size = 1;
+    struct ibv_wc wc[recv_poll_size];
+
+    uint64_t t_buffer, t_recv, t_wait;
+    t_buffer = t_recv = t_wait = 0;
+
+    uint64_t start, end;
+    start = asm_rdtsc();
+    while(true){
+	int cnt = transport->poll(recv_poll_size, tid, wc);
+
+	end = asm_rdtsc();
+	t_recv += (end - start);
+	start = end;
+
+	for(int i=0; i<cnt; i++){
+	    auto wr_id = wc[i].wr_id;
+	    auto response = mem->rpc_response_pool(wr_id);
+	    int num = response->num;
+
+	    for(int j=0; j<num; j++){
+		auto res = response->get_buffer(j);
+		int client_id = res->tid % CLIENT_THREAD_NUM;
+		auto frame = buffer->get_frame(client_id);
+
+		//assert(frame->validate() == false);
+		while(frame->validate())
+		    asm("nop");
+
+		frame->update(res->tid, res->type, res->data);
+	    }
+	    end = asm_rdtsc();
+	    t_buffer += (end - start);
+	    start = end;
+
+	    transport->prepost_recv((uint64_t)response, sizeof(rpc_response_t), wr_id%WORKER_THREAD_NUM, wr_id);
+	    //transport->prepost_recv((uint64_t)response, sizeof(rpc_response_t), tid, wr_id);
+	    //
+	    end = asm_rdtsc();
+	    t_recv += (end - start);
+	    start = end;
+	}
+
+
+	if(cnt){
+	    //usleep(NETWORK_SLEEP * cnt);
+	    usleep(NETWORK_SLEEP);
+
+	    end = asm_rdtsc();
+	    t_wait += (end - start);
+	    start = end;
+	}
+
+
+	if(g_run_finish)
+	    break;
+    }
+
+    ADD_STAT(tid, time_wait_recv, t_wait);
+    ADD_STAT(tid, time_recv, t_recv);
+    ADD_STAT(tid, time_buffer_recv, t_buffer);
+}
+
+void txn_man_t::run_network_thread(){
+    auto tid = thread->get_tid();
+    if(tid < WORKER_THREAD_NUM){ // producer
+	run_send(tid);
+    }
+    else{ // consumer
+	run_recv(tid % WORKER_THREAD_NUM);
+    }
+}
+#endif
+
 int txn_man_t::get_tid(){
     return thread->get_tid();
 }
@@ -8,6 +8,9 @@ class base_query_t;
 class row_t;
 class client_mr_t;
 class client_transport_t;
+class catalog_t;
+template <typename Key_t>
+struct rpc_request_t;
 
 class txn_man_t{
     public:
@@ -19,15 +22,59 @@ class txn_man_t{
 
 	int write_num;
 	int write_buf[MAX_ROW_PER_TXN];
+	#ifdef COLUMN_COMMIT
+	catalog_t* write_schema[MAX_ROW_PER_TXN];
+	uint64_t write_cols[MAX_ROW_PER_TXN]; // PROJ_COL bits set by the txn
+	#endif
+	// key of the request that aborted the last run (retry scheduler hint)
+	uint64_t conflict_key;
+	#ifdef MULTI_DPU
+	// DPU the requests go to, and the DPUs holding locks of the running txn, a bit per node
+	int node;
+	uint32_t participants;
+	int write_node[MAX_ROW_PER_TXN];
+	#endif
+	#ifdef EARLY_LOCK_RELEASE
+	// writes whose final image is known, shipped with the next request
+	int release_num;
+	int release_buf[MAX_RELEASE_PER_REQUEST];
+	#endif
 
 	// main functions
 	virtual void init(thread_t* thread, worker_t* worker, int tid);
 	void release();
-	#if defined BATCH || defined BATCH2
-	virtual void run_network_thread() = 0;
-	virtual RC run_txn(base_query_t* query) = 0;
-	#else
+	#ifdef BATCH
+	void run_network_thread();
+	#elif defined BATCH2
+	void run_send(int tid);
+	void run_recv(int tid);
+	void run_network_thread();
+	#endif
 	virtual RC run_txn(base_query_t* query) = 0;
+
+	// a row changed in the response buffer of step, cols are the columns it set
+	void add_write(int step, catalog_t* schema, uint64_t cols);
+	#if !defined BATCH && !defined BATCH2
+	// fills a COMMIT_DATA request with the written rows, returns the size to send
+	size_t attach_writes(rpc_request_t<Key>* request, int tid);
+	// the requests that follow go to the DPU holding the partition, no-op with a single DPU
+	void route(int node);
+	// commits on the DPU the txn ran on, or with two-phase commit on all the DPUs it touched
+	RC commit(int tid);
+	#endif
+	#ifdef MULTI_DPU
+	// releases the locks an aborted txn still holds on the other DPUs
+	void rollback(int tid);
+	#endif
+
+	// early lock release, no-ops unless EARLY_LOCK_RELEASE
+	void release_early(int step);
+	size_t attach_release(rpc_request_t<Key>* request, size_t request_size, int tid);
+
+	#ifdef COMMUTATIVE
+	// an add to a column carried by a DELTA request, returns the size to send
+	size_t add_delta(rpc_request_t<Key>* request, catalog_t* schema, int col, int64_t value, bool fetch);
+	size_t add_delta(rpc_request_t<Key>* request, catalog_t* schema, int col, double value);
 	#endif
 
 	int get_tid();
@@ -24,13 +24,6 @@ class ycsb_request_t;
 class ycsb_txn_man_t: public txn_man_t{
     public:
 	void init(thread_t* thd, worker_t* worker, int tid);
-	#ifdef BATCH
-	void run_network_thread();
-	#elif defined BATCH2
-	void run_send(int tid);
-	void run_recv(int tid);
-	void run_network_thread();
-	#endif
 	RC run_txn(base_query_t* base_query);
 
     private:
@@ -83,7 +83,7 @@ void ycsb_query_t::generate_request(){
             }
         }
         else{
-            req->scan_len = 20;
+            req->scan_len = SCAN_LEN;
             bool conflict = false;
             for(uint32_t i=0; i<req->scan_len; i++){
                 uint64_t primary_key = key + i;
@@ -9,7 +9,13 @@ uint64_t g_init_parallelism = DEFAULT_INIT_THREADS;
 uint64_t g_run_parallelism = DEFAULT_RUN_THREADS;
 double g_sampling_rate = DEFAULT_SAMPLING_RATE;
 bool g_measure_latency = true;
+int g_batch_size = BATCH_THREAD_NUM;
+uint64_t g_batch_deadline = 0;
+bool g_batch_adaptive = false;
+int g_node_id = 0;
 stat_t* stat;
+arena_t* dpu_arena;
+reclaimer_t* dpu_reclaimer;
 bool warmup_finish = false;
 bool g_run_finish = false;
 query_queue_t* query_queue;
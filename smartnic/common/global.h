@@ -25,6 +25,8 @@ using Value = uint32_t;
 
 class query_queue_t;
 class stat_t;
+class arena_t;
+class reclaimer_t;
 class ycsb_txn_man_t;
 class tpcc_txn_man_t;
 
@@ -118,7 +120,11 @@ enum access_t{
     CM,
     COMMIT,
     COMMIT_DATA,
-    ABORT_ALL,
+    ABORT_ALL, // rolls the txn back on a DPU it did not abort on (MULTI_DPU)
+    SCHEDULE, // read/write set of a deterministic txn
+    DELTA, // commutative update of a row (COMMUTATIVE), locked shared
+    PROC, // a whole txn run on the worker (STORED_PROC)
+    PREPARE, // first phase of a commit across DPUs (MULTI_DPU)
 };
 
 enum lock_type_t{
@@ -131,6 +137,7 @@ enum lock_status_t{
     LOCK_READY,
     LOCK_WAIT,
     LOCK_DROPPED,
+    LOCK_RELEASED, // early released write, undone if the txn aborts
 };
 
 enum txn_status_t{
@@ -196,6 +203,14 @@ enum ycsb_workload_type_t{
 //#define BACKOFF 30000
 #define TIME
 
+// retry scheduler config
+#define RETRY_LINEAR 		1
+#define RETRY_EXPONENTIAL 	2
+#define RETRY_POLICY 		RETRY_EXPONENTIAL
+#define MAX_BACKOFF 		(BACKOFF * 64)
+#define RETRY_QUEUE_SIZE 	4
+#define CONFLICT_HISTORY 	16
+
 // client config
 #define CLIENT_THREAD_NUM 	128
 //#define CLIENT_THREAD_NUM 	2
@@ -209,6 +224,26 @@ enum ycsb_workload_type_t{
 #define PER_BATCH_SIZE 		(CLIENT_THREAD_NUM / WORKER_THREAD_NUM)
 //#define BATCH_SIZE 		16
 //#define BATCH
+// requests carried by one batched rpc, rows of a batch are prefetched together
+#ifdef BATCH2
+#ifdef PER_THREAD_BUFFER
+#define REQUEST_BATCH_SIZE 	PER_BATCH_SIZE
+#else
+#define REQUEST_BATCH_SIZE 	BATCH_SIZE
+#endif
+#else
+#define REQUEST_BATCH_SIZE 	BATCH_THREAD_NUM
+#endif
+// request rings (non-batch): a client RDMA-writes length-prefixed requests into its ring in
+// DPU memory instead of sending into a receive buffer sized for the largest request, larger
+// requests leave a descriptor and are pulled by the DPU, consumed bytes return as credits
+//#define RPC_RING
+#define RPC_RING_SIZE 		4096 	// per client
+#define RPC_RING_FRAME_MAX 	1024 	// larger requests are pulled
+#define RPC_RING_CREDIT_BATCH 	(RPC_RING_SIZE / 4)
+#if defined RPC_RING && (defined BATCH || defined BATCH2)
+#undef RPC_RING
+#endif
 
 // server config
 #define SERVER_NUM 		1
@@ -219,6 +254,26 @@ enum ycsb_workload_type_t{
 #define WORKER_THREAD_NUM	8
 #define LOCKTABLE
 #define BUFFER
+// DPU memory for buffered rows and cached index pages, overridden at worker startup
+#define DPU_MEMORY_BUDGET 	(12 * 1024) 	// MB, leaves room for the OS on a 16GB BF-2
+// epoch-based reclamation of evicted index pages and rows
+#define RECLAIM_BATCH 		64 	// retired objects between two reclamation attempts
+// interleaved request processing: a worker thread runs CORO_NUM coroutines that yield on
+// host-memory verbs and are resumed from the completions on the thread's CQ
+//#define INTERLEAVE
+// the index cache keeps the evicted entry locked across its write-back, which yields under INTERLEAVE
+// and would deadlock a sibling coroutine looking the page up
+#if defined INTERLEAVE && defined CACHE
+#undef INTERLEAVE
+#endif
+#ifdef INTERLEAVE
+#define CORO_NUM 		4
+#define RECLAIM_THREAD_NUM 	(DEFAULT_INIT_THREADS + WORKER_THREAD_NUM * CORO_NUM) // plus a slot per coroutine
+#else
+#define CORO_NUM 		1
+#define RECLAIM_THREAD_NUM 	DEFAULT_INIT_THREADS // loader threads may outnumber the workers
+#endif
+#define CORO_STACK_SIZE 	(256 * 1024)
 
 // benchmark config
 #define DEFAULT_INIT_THREADS 	128
@@ -228,6 +283,12 @@ extern uint64_t g_init_parallelism;
 extern uint64_t g_run_parallelism;
 extern double g_sampling_rate;
 extern bool g_measure_latency;
+// runtime batching of the network threads (BATCH), set from the command line
+extern int g_batch_size; // flush threshold, the upper bound when adaptive
+extern uint64_t g_batch_deadline; // us a partial batch waits, 0 sends right away
+extern bool g_batch_adaptive;
+// memory node a worker serves (MULTI_DPU), its entry in host.txt, set from the command line
+extern int g_node_id;
 extern bool g_run_finish;
 extern double zipfian;
 extern std::atomic<uint32_t> warmup_cnt;
@@ -236,21 +297,27 @@ extern query_queue_t* query_queue;
 
 extern char* output_file;
 extern stat_t* stat;
+extern arena_t* dpu_arena;
+extern reclaimer_t* dpu_reclaimer;
 
 #ifdef YCSB
 #define WORKLOAD 		YCSB
 #define MAX_ROW_PER_TXN		REQUEST_PER_QUERY
+#define MAX_ACCESS_PER_TXN 	(REQUEST_PER_QUERY * SCAN_LEN) // every row of a scan is locked
 #elif defined TPCC
 #define WORKLOAD 		TPCC
 #define MAX_ROW_PER_TXN		100
+#define MAX_ACCESS_PER_TXN 	MAX_ROW_PER_TXN
 #else
 #define MAX_ROW_PER_TXN 	100
+#define MAX_ACCESS_PER_TXN 	MAX_ROW_PER_TXN
 #endif
 
 // YCSB config
 #define SYNTH_TABLE_SIZE 	(10000000)
 #define YCSB_KEY_SIZE		(10000000) // 10M
 #define ZIPFIAN_THETA		(0.9)
+#define SCAN_LEN 		20 	// rows of a YCSB-E scan
 //#define YCSB_PAGE_NUM 		10000000 // 1GB
 #if YCSB
 #define DEFAULT_BUFFER_SIZE 	(9000000) // 8GB
@@ -260,7 +327,23 @@ extern stat_t* stat;
 //#define DEFAULT_BUFFER_SIZE 	(10000000) // 10GB
 #endif
 #define PROBE_DISTANCE 		4
-#define VICTIM_SIZE 		4
+// DPU buffer eviction (LOCKTABLE, BUFFER): the last worker thread runs a CLOCK sweep over
+// the resident rows, a migration to the DPU only takes a frame the sweep has freed
+#define EVICT_LOW_WATERMARK	1024 	// free frames below which a sweep starts
+#define EVICT_HIGH_WATERMARK	4096 	// free frames a sweep refills up to
+#define EVICT_BATCH_SIZE	16 	// dirty rows per batch of RDMA WRITEs
+#define EVICT_TID		(WORKER_THREAD_NUM - 1)
+// admission of rows and index pages to the DPU (TinyLFU), a count-min sketch per cache
+#define SKETCH_DEPTH 		4
+#define SKETCH_MAX_COUNT 	15 	// 4-bit counters
+#define SKETCH_SAMPLE_RATIO 	10 	// accesses per counter between two agings
+#define ROW_SKETCH_SIZE 	(1 << 22)
+// load-time placement: rows the workload's profile ranks hottest start in DPU memory
+#define PLACEMENT_SAMPLES 	(1 << 22) // draws from the query distributions per ranked table
+#define PLACEMENT_SEED 		7
+#if defined BUFFER && WORKER_THREAD_NUM < 2
+#error "BUFFER needs a worker thread for eviction besides the request workers"
+#endif
 //#define REQUEST_PER_QUERY 	64
 //#define REQUEST_PER_QUERY 	32
 //#define REQUEST_PER_QUERY 	16
@@ -287,6 +370,9 @@ extern ycsb_txn_man_t* global_ycsb_txn_man;
 #define PERC_ORDERSTATUS	0
 #define PERC_STOCKLEVEL		0
 // PERC_NEWORDER = 1 - PERC_PAYMENT - PERC_DELIVERY - PERC_ORDERSTATUS - PERC_STOCKLEVEL
+// NURand constants for item and customer ids are fixed instead of drawn per process,
+// so the DPU plans placement on the distribution the clients run
+#define NURAND_SEED 		20061
 
 #define FIRST_PART_LOCAL	true
 #define FIRSTNAME_MIN_LEN	8
@@ -320,6 +406,87 @@ extern tpcc_txn_man_t* global_tpcc_txn_man;
 //#define NOWAIT
 //#define WAITDIE
 #define WOUNDWAIT
+//#define DETERMINISTIC
+
+// deterministic mode (non-batch, non-interleaved TPC-C, LOCKTABLE): clients submit their read/write sets,
+// the DPU orders them in epochs and grants locks in that order, so no txn aborts
+#define EPOCH_SIZE		16 	// txns per epoch
+#define EPOCH_TIMEOUT		10000 	// ns an open epoch waits for more txns
+#if defined DETERMINISTIC && (defined BATCH || defined BATCH2 || defined INTERLEAVE || !defined LOCKTABLE || !defined TPCC)
+#undef DETERMINISTIC
+#endif
+#ifdef DETERMINISTIC // replaces the wound-wait lock manager
+#undef WOUNDWAIT
+#endif
+
+// early lock release (non-batch, LOCKTABLE, WOUNDWAIT)
+// the client ships the final image of a hot write with its next request and the lock is
+// handed to the next txn right away, which then commits only after its predecessors
+//#define EARLY_LOCK_RELEASE
+#define MAX_RELEASE_PER_REQUEST	3
+#if defined EARLY_LOCK_RELEASE && (defined BATCH || defined BATCH2 || !defined LOCKTABLE || !defined WOUNDWAIT)
+#undef EARLY_LOCK_RELEASE
+#endif
+
+// near-data scans (non-batch, non-interleaved, LOCKTABLE)
+// a scan is a single request, the DPU locks its rows and hands the host-resident ones to a pool
+// of memory-server threads if there are enough of them, only the qualifying values cross PCIe
+//#define NEAR_DATA
+#define NEAR_DATA_THREAD_NUM 	4 	// memory-server threads running delegated scans
+#define NEAR_DATA_THRESHOLD 	8 	// host-resident rows from which a scan is delegated
+#if defined NEAR_DATA && (defined BATCH || defined BATCH2 || defined INTERLEAVE || !defined LOCKTABLE)
+#undef NEAR_DATA
+#endif
+
+// commutative deltas (non-batch, LOCKTABLE, BUFFER)
+// counters that are only added to (W_YTD, D_YTD, D_NEXT_O_ID) are updated on the DPU under a
+// shared lock, concurrent deltas to a row are applied by one thread at a time (flat combining)
+//#define COMMUTATIVE
+#define MAX_DELTA_PER_REQUEST 	2
+#define COMBINER_LANES 		1024 	// rows hashed to a lane share its combiner
+#if defined COMMUTATIVE && (defined BATCH || defined BATCH2 || !defined LOCKTABLE || !defined BUFFER || defined EARLY_LOCK_RELEASE || defined DETERMINISTIC)
+#undef COMMUTATIVE
+#endif
+
+// stored procedures (non-batch TPC-C, LOCKTABLE)
+// the client ships the parameters of a Payment or NewOrder in one request, the worker runs
+// it to the end and answers with the outcome, a lock wait resumes it on the granting thread
+//#define STORED_PROC
+#define MAX_OL_PER_ORDER 	15
+#if defined STORED_PROC && (defined BATCH || defined BATCH2 || !defined LOCKTABLE || defined EARLY_LOCK_RELEASE || defined DETERMINISTIC || defined COMMUTATIVE)
+#undef STORED_PROC
+#endif
+
+// column projection (non-batch)
+// a read names the columns it uses and is answered with only those, packed back to back,
+// writes still move whole rows since the client sends the full image back at commit
+//#define PROJECTION
+#define PROJ_COL(id) 		(1ull << (id)) 	// a column of a READ, schemas have fewer than 64
+#if defined PROJECTION && (defined BATCH || defined BATCH2)
+#undef PROJECTION
+#endif
+
+// column commits (non-batch, LOCKTABLE)
+// COMMIT_DATA carries only the columns each written row changed instead of whole rows,
+// installed in place in DPU memory or as small writes to host memory
+//#define COLUMN_COMMIT
+#if defined COLUMN_COMMIT && (defined BATCH || defined BATCH2 || !defined LOCKTABLE || defined EARLY_LOCK_RELEASE)
+#undef COLUMN_COMMIT
+#endif
+
+// multi-DPU scale-out (non-batch, LOCKTABLE, WOUNDWAIT)
+// DPU_NUM memory nodes, each behind its own DPU, hold a partition of the tables: TPC-C by
+// warehouse (items are replicated), YCSB by key range. The client routes each request to the
+// DPU owning its partition and commits a txn that touched several DPUs with two-phase commit
+//#define MULTI_DPU
+#define DPU_NUM 		2 	// entries of dpu.txt and host.txt, a worker is started with its node id
+#if defined MULTI_DPU && (defined BATCH || defined BATCH2 || defined RPC_RING || !defined LOCKTABLE || !defined WOUNDWAIT || defined EARLY_LOCK_RELEASE || defined STORED_PROC || defined NEAR_DATA)
+#undef MULTI_DPU
+#endif
+#ifndef MULTI_DPU
+#undef DPU_NUM
+#define DPU_NUM 		1
+#endif
 
 
 //#define INTERACTIVE
@@ -47,6 +47,14 @@ uint64_t merge_idx_key(uint64_t key1, uint64_t key2, uint64_t key3) {
     return key1 << 42 | key2 << 21 | key3;
 }
 
+int key_to_node(uint64_t key) {
+    return (key * DPU_NUM + g_synth_table_size - 1) / g_synth_table_size - 1;
+}
+
+uint64_t node_first_key(int node) {
+    return g_synth_table_size * node / DPU_NUM + 1;
+}
+
 /****************************************************/
 // Global Clock!
 /****************************************************/
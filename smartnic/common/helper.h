@@ -221,6 +221,9 @@ int get_thdid_from_txnid(uint64_t txnid);
 
 // key_to_part() is only for ycsb
 uint64_t key_to_part(uint64_t key);
+// ycsb keys [1, g_synth_table_size] are split into DPU_NUM ranges, one per memory node
+int key_to_node(uint64_t key);
+uint64_t node_first_key(int node); // the range of a node ends at node_first_key(node + 1)
 uint64_t get_part_id(void * addr);
 // TODO can the following two functions be merged?
 uint64_t merge_idx_key(uint64_t key_cnt, uint64_t * keys);
@@ -7,6 +7,9 @@ struct options_t{
     uint64_t num = 10000000;
     bool latency = false;
     double zipfian = 0.0;
+    uint64_t batch = 0; // 0 keeps BATCH_THREAD_NUM
+    uint64_t batch_deadline = 0;
+    bool adaptive_batch = false;
 };
 
 std::ostream& operator<<(std::ostream& os, const options_t& opt){
@@ -15,7 +18,10 @@ std::ostream& operator<<(std::ostream& os, const options_t& opt){
        << "\tWorkload size: " << opt.num << " records\n"
        << "\tNumber of Client Threads: " << opt.threads << "\n"
        << "\tZipfian Factor: " << opt.zipfian << "\n"
-       << "\tMeasure latency: " << opt.latency << std::endl;
+       << "\tMeasure latency: " << opt.latency << "\n"
+       << "\tBatch size: " << opt.batch << "\n"
+       << "\tBatch deadline: " << opt.batch_deadline << " us\n"
+       << "\tAdaptive batching: " << opt.adaptive_batch << std::endl;
     return os;
 }
 
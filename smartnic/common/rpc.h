@@ -4,6 +4,7 @@
 #include "common/debug.h"
 
 #define MAX_SCAN_NUM (50)
+static_assert(SCAN_LEN <= MAX_SCAN_NUM, "a scan must fit in a single response");
 
 enum request_type{
     // rpc requests that workers send to servers
@@ -13,6 +14,7 @@ enum request_type{
     IDX_GET_ROOT_ADDR,
     TABLE_ALLOC_ROW,
     TABLE_DEALLOC_ROW,
+    NEAR_DATA_SCAN,
     // requests that clients send to workers
     OP_READ,
     OP_WRITE,
@@ -66,6 +68,9 @@ struct rpc_request_buffer_t{
     access_t type;
     uint64_t timestamp;
     Key_t key;
+    // table and partition of the key (TPCC)
+    tpcc_request_type_t tpcc_type;
+    int pid;
 
     rpc_request_buffer_t(): valid(valid_t::INVALID) { }
 
@@ -78,6 +83,13 @@ struct rpc_request_buffer_t{
 	valid = valid_t::VALID;
     }
 
+    // worker thread function --- update local buffer data
+    void update(int _tid, access_t _type, tpcc_request_type_t _tpcc_type, int _pid, uint64_t _timestamp, Key_t _key){
+	tpcc_type = _tpcc_type;
+	pid = _pid;
+	update(_tid, _type, _timestamp, _key);
+    }
+
     // worker thread function --- update local buffer data
     void update(int _tid, access_t _type, uint64_t _timestamp){
 	tid = _tid;
@@ -360,6 +372,14 @@ struct rpc_request_t: base_request_t{
 	};
     };
     Key_t key;
+    #ifdef PROJECTION
+    uint64_t cols = 0; // columns a READ returns, PROJ_COL bits, 0 for the whole row
+    #endif
+    #ifdef EARLY_LOCK_RELEASE
+    // early released writes piggybacked on a lock request, their rows lead data
+    int release_num = 0;
+    int release_idx[MAX_RELEASE_PER_REQUEST];
+    #endif
     char data[ROW_SIZE * MAX_ROW_PER_TXN];
 
     rpc_request_t(int qp_id, access_t type): base_request_t(qp_id, type){ }
@@ -371,6 +391,14 @@ struct rpc_request_t: base_request_t{
     rpc_request_t(int qp_id, access_t type, Key_t key, int num, uint64_t timestamp): base_request_t(qp_id, type, timestamp), num(num), key(key){ }
 };
 
+// one row of the read/write set a client submits with SCHEDULE (DETERMINISTIC)
+template <typename Key_t>
+struct rpc_schedule_t{
+    tpcc_request_type_t tpcc_type;
+    access_t type;
+    Key_t key;
+};
+
 // rpc response worker sends to client
 struct rpc_response_t: base_response_t{
     char data[ROW_SIZE];
@@ -412,6 +440,123 @@ struct response_t{
     response_t(int qp_id, response_type type, uint64_t addr): qp_id(qp_id), type(type), addr(addr) { }
 };
 
+// filter of a scan, a row qualifies if the 8-byte field at offset lies in [lo, hi]
+struct scan_filter_t{
+    uint32_t offset; // into the row data, into the whole row once handed to the server
+    uint64_t lo;
+    uint64_t hi;
+};
+
+// scan response worker sends to client, the filtered field of each qualifying row
+struct scan_result_t{
+    int cnt;
+    uint64_t values[MAX_SCAN_NUM];
+};
+
+// a scan delegated to the server, lives in host memory (one per worker thread)
+// the worker writes filter, num and addr, the server fills values and returns their count
+struct near_data_scan_t{
+    scan_filter_t filter;
+    int num;
+    uint64_t addr[MAX_SCAN_NUM];
+    uint64_t values[MAX_SCAN_NUM];
+};
+static_assert(sizeof(near_data_scan_t) <= ROW_SIZE, "a delegated scan takes a row-sized host block");
+
+enum delta_type_t{
+    DELTA_INT64 = 0,
+    DELTA_DOUBLE
+};
+
+// an add to the 8-byte field at offset, a fetch delta returns the value after the add
+struct delta_t{
+    uint32_t offset; // into the row data
+    delta_type_t type;
+    bool fetch;
+    union{
+	int64_t i;
+	double d;
+    };
+};
+
+// deltas of a DELTA request, carried in its data
+struct rpc_delta_t{
+    int num;
+    delta_t ops[MAX_DELTA_PER_REQUEST];
+};
+
+// one order line of a NewOrder procedure
+struct rpc_proc_item_t{
+    uint64_t ol_i_id;
+    uint64_t ol_supply_w_id;
+    uint64_t ol_quantity;
+};
+
+// parameters of a Payment or NewOrder run on the worker (STORED_PROC), carried in the data of a PROC request
+struct rpc_proc_t{
+    tpcc_txn_type_t type;
+    uint64_t w_id;
+    uint64_t d_id;
+    uint64_t c_id;
+    // payment
+    uint64_t d_w_id;
+    uint64_t c_w_id;
+    uint64_t c_d_id;
+    char c_last[LASTNAME_LEN];
+    double h_amount;
+    bool by_last_name;
+    // new order
+    bool remote;
+    uint64_t ol_cnt;
+    rpc_proc_item_t items[MAX_OL_PER_ORDER];
+};
+
+// outcome of a procedure, follows the response header
+struct rpc_proc_result_t{
+    uint64_t conflict_key; // of the access that aborted
+    int64_t o_id; // of a committed new order
+};
+
+// a changed column run of a written row (COLUMN_COMMIT), its bytes follow padded to 4
+// the data of COMMIT_DATA is the number of runs and then the runs ordered by row
+struct commit_col_t{
+    uint16_t row; // among the written rows, in access order
+    uint16_t size;
+    uint32_t offset; // into the row data
+};
+
+static inline size_t commit_col_size(uint32_t size){
+    return sizeof(commit_col_t) + ((size + 3) & ~3u);
+}
+
+// frame of a request ring (RPC_RING), cacheline aligned, the footer after the payload repeats
+// seq so a frame is only taken once all of it landed, consumed frames are zeroed
+struct ring_header_t{
+    uint32_t len; // of the payload, 0 while nothing was written
+    uint32_t seq;
+};
+#define RING_WRAP 		0xffffffff 	// len of a marker, the frame follows at the ring start
+#define RING_PULL 		0x80000000 	// the payload is a ring_pull_t
+
+// a request too large for a frame, the DPU reads it from the client's request buffer
+struct ring_pull_t{
+    uint64_t addr;
+    uint32_t size;
+};
+
+static inline uint32_t ring_frame_size(uint32_t len){
+    uint32_t size = sizeof(ring_header_t) + len + sizeof(uint32_t);
+    return (size + CACHELINE_SIZE - 1) / CACHELINE_SIZE * CACHELINE_SIZE;
+}
+
+// client side of a ring, at the start of each client's memory region: the credit word the
+// worker writes and a wrap marker, then the frame being written
+#define RING_CLIENT_CREDIT 	0
+#define RING_CLIENT_WRAP 	sizeof(uint64_t)
+#define RING_CLIENT_FRAME 	CACHELINE_SIZE
+#define RING_CLIENT_META 	(CACHELINE_SIZE + RPC_RING_FRAME_MAX)
+static_assert(RPC_RING_SIZE - RPC_RING_CREDIT_BATCH >= 2 * RPC_RING_FRAME_MAX, "a ring with uncredited bytes must still take a frame and its wrap");
+
 template <typename T, class... Args>
 static T* create_message(void* buf, Args&&... args){
     return new (buf) T(args...);
@@ -2,7 +2,7 @@
 #include <algorithm>
 #include <fstream>
 
-stat_thread_t::stat_thread_t(): run_cnt(0), run_time(0), abort_cnt(0){
+stat_thread_t::stat_thread_t(): run_cnt(0), run_time(0), abort_cnt(0), retry_cnt(0), defer_cnt(0){
 #ifdef __x86_64__ // host stat feature
     latency.clear();
     latency.resize(MAX_TRANSACTION);
@@ -14,6 +14,19 @@ stat_thread_t::stat_thread_t(): run_cnt(0), run_time(0), abort_cnt(0){
     time_wait = 0;
     time_backoff = 0;
 
+    buffer_hit = 0;
+    buffer_miss = 0;
+    index_hit = 0;
+    index_miss = 0;
+    admit_cnt = 0;
+    reject_cnt = 0;
+
+    time_send = 0;
+    time_wait_send = 0;
+    time_buffer_send = 0;
+    time_recv = 0;
+    time_wait_recv = 0;
+    time_buffer_recv = 0;
 
     // debug
     time_lock_critical_section = 0;
@@ -29,6 +42,8 @@ void stat_thread_t::clear(){
     run_cnt = 0;
     run_time = 0;
     abort_cnt = 0;
+    retry_cnt = 0;
+    defer_cnt = 0;
 
     time_abort = 0;
     time_commit = 0;
@@ -36,6 +51,20 @@ void stat_thread_t::clear(){
     time_wait = 0;
     time_backoff = 0;
 
+    buffer_hit = 0;
+    buffer_miss = 0;
+    index_hit = 0;
+    index_miss = 0;
+    admit_cnt = 0;
+    reject_cnt = 0;
+
+    time_send = 0;
+    time_wait_send = 0;
+    time_buffer_send = 0;
+    time_recv = 0;
+    time_wait_recv = 0;
+    time_buffer_recv = 0;
+
     // debug
     time_lock_critical_section = 0;
     time_unlock_critical_section = 0;
@@ -48,11 +77,13 @@ void stat_thread_t::add_latency(uint64_t _latency){
     latency.push_back(_latency);
 }
 
-void stat_thread_t::summary(uint64_t& run_cnt, uint64_t& run_time, uint64_t& abort_cnt, uint64_t& time_commit, uint64_t& time_abort, uint64_t& time_backoff, uint64_t& time_index, uint64_t& time_wait, uint64_t& time_lock_critical_section, uint64_t& count_lock_critical_section, uint64_t& time_unlock_critical_section, uint64_t& count_unlock_critical_section, uint64_t& time_notification, std::vector<uint64_t>& latency){
-//void stat_thread_t::summary(uint64_t& run_cnt, uint64_t& run_time, uint64_t& abort_cnt, uint64_t& time_commit, uint64_t& time_abort, uint64_t& time_backoff, uint64_t& time_index, uint64_t& time_wait, std::vector<uint64_t>& latency){
+void stat_thread_t::summary(uint64_t& run_cnt, uint64_t& run_time, uint64_t& abort_cnt, uint64_t& retry_cnt, uint64_t& defer_cnt, uint64_t& time_commit, uint64_t& time_abort, uint64_t& time_backoff, uint64_t& time_index, uint64_t& time_wait, uint64_t& time_lock_critical_section, uint64_t& count_lock_critical_section, uint64_t& time_unlock_critical_section, uint64_t& count_unlock_critical_section, uint64_t& time_notification, std::vector<uint64_t>& latency){
+//void stat_thread_t::summary(uint64_t& run_cnt, uint64_t& run_time, uint64_t& abort_cnt, uint64_t& retry_cnt, uint64_t& defer_cnt, uint64_t& time_commit, uint64_t& time_abort, uint64_t& time_backoff, uint64_t& time_index, uint64_t& time_wait, std::vector<uint64_t>& latency){
     run_cnt += this->run_cnt;
     run_time += this->run_time;
     abort_cnt += this->abort_cnt;
+    retry_cnt += this->retry_cnt;
+    defer_cnt += this->defer_cnt;
 
     time_commit += this->time_commit;
     time_abort += this->time_abort;
@@ -74,6 +105,15 @@ void stat_thread_t::summary(uint64_t& run_cnt, uint64_t& run_time, uint64_t& abo
 #endif
 }
 
+void stat_thread_t::cache_summary(uint64_t& buffer_hit, uint64_t& buffer_miss, uint64_t& index_hit, uint64_t& index_miss, uint64_t& admit_cnt, uint64_t& reject_cnt){
+    buffer_hit += this->buffer_hit;
+    buffer_miss += this->buffer_miss;
+    index_hit += this->index_hit;
+    index_miss += this->index_miss;
+    admit_cnt += this->admit_cnt;
+    reject_cnt += this->reject_cnt;
+}
+
 stat_t::stat_t(){
     _stats = new stat_thread_t*[CLIENT_THREAD_NUM];
     for(int i=0; i<CLIENT_THREAD_NUM; i++)
@@ -93,6 +133,8 @@ void stat_t::summary(){
     uint64_t run_cnt = 0;
     uint64_t run_time = 0;
     uint64_t abort_cnt = 0;
+    uint64_t retry_cnt = 0;
+    uint64_t defer_cnt = 0;
 
     // breakdown debug
     uint64_t time_commit, time_abort, time_index, time_wait, time_backoff, time_lock_critical_section, time_unlock_critical_section, time_notification, count_lock_critical_section, count_unlock_critical_section;
@@ -101,11 +143,15 @@ void stat_t::summary(){
     //uint64_t time_commit, time_abort, time_index, time_wait, time_backoff;
     //time_commit = time_abort = time_index = time_wait = time_backoff = 0;
 
+    uint64_t buffer_hit, buffer_miss, index_hit, index_miss, admit_cnt, reject_cnt;
+    buffer_hit = buffer_miss = index_hit = index_miss = admit_cnt = reject_cnt = 0;
+
     std::vector<uint64_t> latency;
     for(int i=0; i<g_run_parallelism; i++){
+	_stats[i]->cache_summary(buffer_hit, buffer_miss, index_hit, index_miss, admit_cnt, reject_cnt);
         // debug
-	_stats[i]->summary(run_cnt, run_time, abort_cnt, time_commit, time_abort, time_backoff, time_index, time_wait, time_lock_critical_section, count_lock_critical_section, time_unlock_critical_section, count_unlock_critical_section, time_notification, latency);
-        //_stats[i]->summary(run_cnt, run_time, abort_cnt, time_commit, time_abort, time_backoff, time_index, time_wait, latency);
+	_stats[i]->summary(run_cnt, run_time, abort_cnt, retry_cnt, defer_cnt, time_commit, time_abort, time_backoff, time_index, time_wait, time_lock_critical_section, count_lock_critical_section, time_unlock_critical_section, count_unlock_critical_section, time_notification, latency);
+        //_stats[i]->summary(run_cnt, run_time, abort_cnt, retry_cnt, defer_cnt, time_commit, time_abort, time_backoff, time_index, time_wait, latency);
     }
 
     run_time = run_time / 1000000000.0 / g_run_parallelism;
@@ -114,6 +160,8 @@ void stat_t::summary(){
     std::cout << "Processed           : " << run_cnt << " for " << run_time << " sec" << std::endl;
     std::cout << "Aborted             : " << abort_cnt << " for " << run_time << " sec" << std::endl;
     std::cout << "Abort rate          : " << (double)abort_cnt / (abort_cnt + run_cnt) << std::endl;
+    std::cout << "Retried             : " << retry_cnt << std::endl;
+    std::cout << "Deferred            : " << defer_cnt << std::endl;
     uint64_t total_breakdown = time_commit + time_abort + time_index + time_wait + time_backoff;
     std::cout << "    Total time: " << total_breakdown << std::endl;
     std::cout << "    Index     : " << (double)time_index / total_breakdown * 100 << " %" << std::endl;
@@ -122,6 +170,13 @@ void stat_t::summary(){
     std::cout << "    Wait      : " << (double)time_wait / total_breakdown * 100 << " %" << std::endl;
     std::cout << "    Backoff   : " << (double)time_backoff / total_breakdown * 100 << " %" << std::endl;
 
+    if(buffer_hit + buffer_miss + index_hit + index_miss){
+	std::cout << "Buffer hit ratio    : " << (double)buffer_hit / (buffer_hit + buffer_miss) << std::endl;
+	std::cout << "Index hit ratio     : " << (double)index_hit / (index_hit + index_miss) << std::endl;
+	std::cout << "Admitted            : " << admit_cnt << " (" << (double)admit_cnt / (admit_cnt + reject_cnt) * 100 << " %)" << std::endl;
+	std::cout << "Rejected            : " << reject_cnt << std::endl;
+    }
+
     // debug
     std::cout << "\nCritical seciton time LOCK   (msec): " << (double)time_lock_critical_section/1000000.0 << std::endl;
     std::cout << "Critical seciton time UNLOCK (msec): " << (double)time_unlock_critical_section/1000000.0 << std::endl;
@@ -11,12 +11,15 @@ class stat_thread_t{
 	void print();
 
 	// debug
-	void summary(uint64_t& run_cnt, uint64_t& run_time, uint64_t& abort_cnt, uint64_t& time_commit, uint64_t& time_abort, uint64_t& time_backoff, uint64_t& time_index, uint64_t& time_wait, uint64_t& time_lock_critical_section, uint64_t& count_critical_section, uint64_t& time_unlock_critical_section, uint64_t& count_unlock_critical_section, uint64_t& time_notification, std::vector<uint64_t>& latency);
-	//void summary(uint64_t& run_cnt, uint64_t& run_time, uint64_t& abort_cnt, uint64_t& time_commit, uint64_t& time_abort, uint64_t& time_backoff, uint64_t& time_index, uint64_t& time_wait, std::vector<uint64_t>& latency);
+	void summary(uint64_t& run_cnt, uint64_t& run_time, uint64_t& abort_cnt, uint64_t& retry_cnt, uint64_t& defer_cnt, uint64_t& time_commit, uint64_t& time_abort, uint64_t& time_backoff, uint64_t& time_index, uint64_t& time_wait, uint64_t& time_lock_critical_section, uint64_t& count_critical_section, uint64_t& time_unlock_critical_section, uint64_t& count_unlock_critical_section, uint64_t& time_notification, std::vector<uint64_t>& latency);
+	//void summary(uint64_t& run_cnt, uint64_t& run_time, uint64_t& abort_cnt, uint64_t& retry_cnt, uint64_t& defer_cnt, uint64_t& time_commit, uint64_t& time_abort, uint64_t& time_backoff, uint64_t& time_index, uint64_t& time_wait, std::vector<uint64_t>& latency);
+	void cache_summary(uint64_t& buffer_hit, uint64_t& buffer_miss, uint64_t& index_hit, uint64_t& index_miss, uint64_t& admit_cnt, uint64_t& reject_cnt);
 
 	uint64_t run_cnt;
 	uint64_t run_time;
 	uint64_t abort_cnt;
+	uint64_t retry_cnt; // re-executions of aborted txns
+	uint64_t defer_cnt; // new txns run while an aborted one backs off
 
 	uint64_t time_index;
         uint64_t time_abort;
@@ -24,6 +27,22 @@ class stat_thread_t{
         uint64_t time_wait;
         uint64_t time_backoff;
 
+	// DPU row buffer and index cache
+	uint64_t buffer_hit;
+	uint64_t buffer_miss;
+	uint64_t index_hit;
+	uint64_t index_miss;
+	uint64_t admit_cnt; // remote rows/pages the admission filter let in
+	uint64_t reject_cnt;
+
+	// network threads of the client (BATCH2)
+	uint64_t time_send;
+	uint64_t time_wait_send;
+	uint64_t time_buffer_send;
+	uint64_t time_recv;
+	uint64_t time_wait_recv;
+	uint64_t time_buffer_recv;
+
 	// debug
 	uint64_t time_lock_critical_section;
 	uint64_t count_lock_critical_section;
@@ -0,0 +1,121 @@
+#include "concurrency/deterministic.h"
+#include "concurrency/entry.h"
+#include "worker/txn.h"
+#include "common/helper.h"
+
+#ifdef DETERMINISTIC
+
+deterministic_t::deterministic_t(): owner_cnt(0), waiter_cnt(0), lock_type(LOCK_NONE), owners(nullptr), waiters_head(nullptr), waiters_tail(nullptr){ }
+
+RC deterministic_t::lock_get(lock_type_t type, txn_man_t* txn, Access* access, int tid){
+    RC rc = RCOK;
+    auto entry = get_entry();
+    entry->type = type;
+    entry->client_id = access->client_id;
+    entry->access = access;
+
+    if(word.try_acquire(entry)) // uncontended, single owner
+	return rc;
+    word.latch(owners, owner_cnt, lock_type);
+
+    // earlier txns go first, even if this request is compatible with the owners
+    if(waiter_cnt == 0 && !lock_conflict(lock_type, type)){
+	STACK_PUSH(owners, entry);
+	owner_cnt++;
+	lock_type = type;
+    }
+    else{
+	LIST_PUT_TAIL(waiters_head, waiters_tail, entry);
+	waiter_cnt++;
+	access->lock_status = lock_status_t::LOCK_WAIT;
+	rc = WAIT;
+    }
+
+    word.unlatch(owners, owner_cnt, lock_type, waiter_cnt);
+    return rc;
+}
+
+// lock for DPU to host migration
+RC deterministic_t::lock_get(int tid){
+    auto entry = get_entry();
+    entry->type = LOCK_EX;
+    entry->client_id = tid;
+    entry->access = nullptr;
+
+    // only an idle row is taken, the evictor skips rows in use
+    if(word.try_acquire(entry))
+	return RCOK;
+    return_entry(entry);
+    return ABORT;
+}
+
+void deterministic_t::lock_release(txn_man_t* txn, int client_id, int tid){
+    lock_entry_t* en = nullptr;
+    lock_entry_t* prev = nullptr;
+    std::vector<Access*> buffer;
+
+    en = word.try_release(client_id);
+    if(en){ // uncontended, single owner
+	return_entry(en);
+	return;
+    }
+    word.latch(owners, owner_cnt, lock_type);
+    en = owners;
+
+    // find the entry in the owners list
+    while(en && en->client_id != client_id){
+	prev = en;
+	en = en->next;
+    }
+    assert(en); // locks are never dropped in this mode
+
+    if(prev)
+	prev->next = en->next;
+    else
+	owners = en->next;
+    owner_cnt--;
+    if(owner_cnt == 0)
+	lock_type = LOCK_NONE;
+
+    bring_next(buffer);
+    word.unlatch(owners, owner_cnt, lock_type, waiter_cnt);
+
+    return_entry(en);
+    for(auto it=buffer.begin(); it!=buffer.end(); it++){
+	txn->granted(*it, tid);
+    }
+}
+
+// grant the head of the queue and every compatible request right behind it
+void deterministic_t::bring_next(std::vector<Access*>& buffer){
+    lock_entry_t* entry = nullptr;
+    while(waiters_head && !lock_conflict(lock_type, waiters_head->type)){
+	LIST_GET_HEAD(waiters_head, waiters_tail, entry);
+	waiter_cnt--;
+
+	STACK_PUSH(owners, entry);
+	owner_cnt++;
+	lock_type = entry->type;
+
+	entry->access->lock_status = lock_status_t::LOCK_READY;
+	buffer.push_back(entry->access);
+	entry = nullptr;
+    }
+}
+
+bool deterministic_t::lock_conflict(lock_type_t l1, lock_type_t l2){
+    if(l1 == LOCK_NONE || l2 == LOCK_NONE)
+	return false;
+    else if(l1 == LOCK_EX || l2 == LOCK_EX)
+	return true;
+    return false;
+}
+
+lock_entry_t* deterministic_t::get_entry(){
+    return get_lock_entry();
+}
+
+void deterministic_t::return_entry(lock_entry_t* entry){
+    return_lock_entry(entry);
+}
+#endif
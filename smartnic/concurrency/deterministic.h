@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include <vector>
+#include "common/global.h"
+#include "concurrency/lock_word.h"
+
+class txn_man_t;
+struct lock_entry_t;
+class Access;
+
+// lock manager of the deterministic mode
+// requests arrive in the global order of the sequencer and are granted strictly
+// in that order, so a txn never aborts and never deadlocks
+class deterministic_t{
+    public:
+	deterministic_t();
+	RC lock_get(lock_type_t type, txn_man_t* txn, Access* access, int tid);
+	RC lock_get(int tid);
+	void lock_release(txn_man_t* txn, int client_id, int tid);
+
+    private:
+	bool lock_conflict(lock_type_t l1, lock_type_t l2);
+	lock_entry_t* get_entry();
+	void return_entry(lock_entry_t* entry);
+	void bring_next(std::vector<Access*>& buffer);
+
+	// owner/mode word, the lists below are only valid while latched
+	lock_word_t word;
+
+	lock_type_t lock_type;
+	uint32_t owner_cnt;
+	uint32_t waiter_cnt;
+
+	// owners is a single linked list
+	lock_entry_t* owners; 
+
+	// waiters is a double linked list in sequencer order (FIFO)
+	lock_entry_t* waiters_head; 
+	lock_entry_t* waiters_tail;
+};
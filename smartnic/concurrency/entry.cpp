@@ -0,0 +1,25 @@
+#include "concurrency/entry.h"
+#include <vector>
+
+#define LOCK_ENTRY_CHUNK 	1024
+
+static thread_local std::vector<lock_entry_t*> entry_pool;
+
+lock_entry_t* get_lock_entry(){
+    if(entry_pool.empty()){
+	auto chunk = new lock_entry_t[LOCK_ENTRY_CHUNK];
+	for(int i=0; i<LOCK_ENTRY_CHUNK; i++)
+	    entry_pool.push_back(&chunk[i]);
+    }
+
+    auto entry = entry_pool.back();
+    entry_pool.pop_back();
+    entry->access = nullptr;
+    entry->next = nullptr;
+    entry->prev = nullptr;
+    return entry;
+}
+
+void return_lock_entry(lock_entry_t* entry){
+    entry_pool.push_back(entry);
+}
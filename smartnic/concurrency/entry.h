@@ -2,14 +2,21 @@
 #include "common/global.h"
 
 class txn_man_t;
-class Acess;
+class Access;
 
 struct lock_entry_t{
     lock_type_t type;
     int client_id;
     Access* access;
+    #ifdef EARLY_LOCK_RELEASE
+    uint64_t seq; // grant order while early released writes are pending, 0 otherwise
+    #endif
     lock_entry_t* next;
     lock_entry_t* prev;
 };
 
+// per-worker lock entry pool
+// entries are never freed, an entry returned by another worker joins its pool
+lock_entry_t* get_lock_entry();
+void return_lock_entry(lock_entry_t* entry);
 
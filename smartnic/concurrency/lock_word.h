@@ -0,0 +1,103 @@
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include "common/global.h"
+#include "common/helper.h"
+#include "concurrency/entry.h"
+
+// lock word layout
+//   [63]    latch -- a slow path is updating the owner/waiter lists
+//   [62]    slow  -- owners/waiters are kept in the lists of the lock manager
+//   [61:60] mode of the single fast path owner
+//   [47:0]  lock entry of the single fast path owner
+#define LOCK_WORD_LATCH 	(1UL << 63)
+#define LOCK_WORD_SLOW 		(1UL << 62)
+#define LOCK_WORD_SH 		(1UL << 60)
+#define LOCK_WORD_EX 		(2UL << 60)
+#define LOCK_WORD_MODE 		(3UL << 60)
+#define LOCK_WORD_ENTRY 	((1UL << 48) - 1)
+
+static inline void cpu_relax(){
+#ifdef __x86_64__
+    asm volatile("pause" ::: "memory");
+#elif __aarch64__
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+// atomic owner/mode word shared by the lock managers
+// an uncontended acquire or release is a single CAS, everything else
+// (sharing, waiting, wounding) takes the latch and works on the lists
+class lock_word_t{
+    public:
+	lock_word_t(): word(0){ }
+
+	// empty lock -> single owner
+	bool try_acquire(lock_entry_t* entry){
+	    uint64_t expected = 0;
+	    return word.compare_exchange_strong(expected, encode(entry));
+	}
+
+	// single owner -> empty lock, returns the released entry
+	lock_entry_t* try_release(int client_id){
+	    uint64_t cur = word.load();
+	    if(cur & (LOCK_WORD_LATCH | LOCK_WORD_SLOW))
+		return nullptr;
+
+	    auto entry = reinterpret_cast<lock_entry_t*>(cur & LOCK_WORD_ENTRY);
+	    if(!entry || entry->client_id != client_id)
+		return nullptr;
+
+	    if(word.compare_exchange_strong(cur, 0))
+		return entry;
+	    return nullptr;
+	}
+
+	// take the slow path, a fast path owner is moved to the owner list
+	void latch(lock_entry_t*& owners, uint32_t& owner_cnt, lock_type_t& lock_type){
+	    uint64_t cur = word.load();
+	    while(true){
+		if(cur & LOCK_WORD_LATCH){
+		    cpu_relax();
+		    cur = word.load();
+		    continue;
+		}
+		if(word.compare_exchange_weak(cur, cur | LOCK_WORD_LATCH))
+		    break;
+	    }
+
+	    if(!(cur & LOCK_WORD_SLOW)){
+		owners = nullptr;
+		owner_cnt = 0;
+		lock_type = LOCK_NONE;
+
+		auto entry = reinterpret_cast<lock_entry_t*>(cur & LOCK_WORD_ENTRY);
+		if(entry){
+		    STACK_PUSH(owners, entry);
+		    owner_cnt = 1;
+		    lock_type = entry->type;
+		}
+	    }
+	}
+
+	// leave the slow path, a single owner without waiters goes back to the fast path
+	void unlatch(lock_entry_t*& owners, uint32_t& owner_cnt, lock_type_t& lock_type, uint32_t waiter_cnt){
+	    uint64_t next = LOCK_WORD_SLOW;
+	    if(waiter_cnt == 0 && owner_cnt <= 1){
+		next = owner_cnt ? encode(owners) : 0;
+		owners = nullptr;
+		owner_cnt = 0;
+		lock_type = LOCK_NONE;
+	    }
+	    word.store(next, std::memory_order_release);
+	}
+
+    private:
+	uint64_t encode(lock_entry_t* entry){
+	    uint64_t addr = reinterpret_cast<uint64_t>(entry);
+	    assert((addr & ~LOCK_WORD_ENTRY) == 0);
+	    return addr | (entry->type == LOCK_EX ? LOCK_WORD_EX : LOCK_WORD_SH);
+	}
+
+	std::atomic<uint64_t> word;
+};
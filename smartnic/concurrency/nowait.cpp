@@ -3,64 +3,58 @@
 #include "common/helper.h"
 #include "worker/txn.h"
 
-nowait_t::nowait_t(): owner_cnt(0), waiter_cnt(0), lock_type(LOCK_NONE), owners(nullptr), waiters_head(nullptr), waiters_tail(nullptr){
-    latch = new pthread_mutex_t;
-    pthread_mutex_init(latch, NULL);
-}
+nowait_t::nowait_t(): owner_cnt(0), waiter_cnt(0), lock_type(LOCK_NONE), owners(nullptr), waiters_head(nullptr), waiters_tail(nullptr){ }
 
 RC nowait_t::lock_get(lock_type_t type, txn_man_t* txn, Access* access, int tid){
     RC rc = RCOK;
-    pthread_mutex_lock(latch);
+    auto entry = get_entry();
+    entry->type = type;
+    entry->client_id = access->client_id;
+    entry->access = access;
+    if(word.try_acquire(entry)) // uncontended, single owner
+	return rc;
+    word.latch(owners, owner_cnt, lock_type);
 
     bool conflict = lock_conflict(lock_type, type);
     if(conflict){ // lock conflicts -- cannot be added to the owner list
-	pthread_mutex_unlock(latch);
+	word.unlatch(owners, owner_cnt, lock_type, waiter_cnt);
+	return_entry(entry);
 	return ABORT;
     }
      // no conflict -- add it to owners list
-    auto entry = get_entry();
-    entry->type = type;
-    entry->client_id = access->client_id;
-    entry->access = access;
     STACK_PUSH(owners, entry);
     owner_cnt++;
     lock_type = type;
 
-    pthread_mutex_unlock(latch);
+    word.unlatch(owners, owner_cnt, lock_type, waiter_cnt);
     return rc;
 }
 
 // lock for DPU to host migration
 RC nowait_t::lock_get(int tid){
-    RC rc = RCOK;
     auto entry = get_entry();
     entry->type = LOCK_EX;
     entry->client_id = tid;
     entry->access = nullptr;
 
-    pthread_mutex_lock(latch);
-
-    bool conflict = lock_conflict(lock_type, entry->type);
-    if(conflict){ // lock conflicts -- cannot be added to the owner list
-	pthread_mutex_unlock(latch);
-	return_entry(entry);
-	return ABORT;
-    }
-     // no conflict -- add it to owners list
-    STACK_PUSH(owners, entry);
-    owner_cnt++;
-    lock_type = entry->type;
-
-    pthread_mutex_unlock(latch);
-    return rc;
+    // only an idle row is taken, the evictor skips rows in use
+    if(word.try_acquire(entry))
+	return RCOK;
+    return_entry(entry);
+    return ABORT;
 }
 
 
 void nowait_t::lock_release(txn_man_t* txn, int client_id, int tid){
     RC rc = RCOK;
     lock_entry_t* prev = nullptr;
-    pthread_mutex_lock(latch);
-    auto en = owners;
+    auto en = word.try_release(client_id);
+    if(en){ // uncontended, single owner
+	return_entry(en);
+	return;
+    }
+    word.latch(owners, owner_cnt, lock_type);
+    en = owners;
 
     // find the entry in the owners list
     while(en && en->client_id != client_id){
@@ -77,7 +71,7 @@ void nowait_t::lock_release(txn_man_t* txn, int client_id, int tid){
     if(owner_cnt == 0)
 	lock_type = LOCK_NONE;
 
-    pthread_mutex_unlock(latch);
+    word.unlatch(owners, owner_cnt, lock_type, waiter_cnt);
 }
 
 bool nowait_t::lock_conflict(lock_type_t l1, lock_type_t l2){
@@ -89,10 +83,9 @@ bool nowait_t::lock_conflict(lock_type_t l1, lock_type_t l2){
 }
 
 lock_entry_t* nowait_t::get_entry(){
-    lock_entry_t* entry = new lock_entry_t;
-    return entry;
+    return get_lock_entry();
 }
 
 void nowait_t::return_entry(lock_entry_t* entry){
-    delete entry;
+    return_lock_entry(entry);
 }
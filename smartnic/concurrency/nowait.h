@@ -1,8 +1,8 @@
 #pragma once
 #include <cstdint>
 #include <atomic>
-#include <pthread.h>
 #include "common/global.h"
+#include "concurrency/lock_word.h"
 
 class txn_man_t;
 struct lock_entry_t;
@@ -20,7 +20,8 @@ class nowait_t{
 	lock_entry_t* get_entry();
 	void return_entry(lock_entry_t* entry);
 
-	pthread_mutex_t* latch;
+	// owner/mode word, the lists below are only valid while latched
+	lock_word_t word;
 
 	lock_type_t lock_type;
 	uint32_t owner_cnt;
@@ -5,10 +5,7 @@
 #include "common/stat.h"
 #include "common/debug.h"
 
-waitdie_t::waitdie_t(): owner_cnt(0), waiter_cnt(0), lock_type(LOCK_NONE), owners(nullptr), waiters_head(nullptr), waiters_tail(nullptr){
-    latch = new pthread_mutex_t;
-    pthread_mutex_init(latch, NULL);
-}
+waitdie_t::waitdie_t(): owner_cnt(0), waiter_cnt(0), lock_type(LOCK_NONE), owners(nullptr), waiters_head(nullptr), waiters_tail(nullptr){ }
 
 RC waitdie_t::lock_get(lock_type_t type, txn_man_t* txn, Access* access, int tid){
     RC rc = RCOK;
@@ -26,7 +23,9 @@ RC waitdie_t::lock_get(lock_type_t type, txn_man_t* txn, Access* access, int tid
 #ifdef BREAKDOWN
     uint64_t start = asm_rdtsc();
 #endif
-    pthread_mutex_lock(latch);
+    if(word.try_acquire(entry)) // uncontended, single owner
+	goto done;
+    word.latch(owners, owner_cnt, lock_type);
 
 #if 1
     if(waiter_cnt == 0){ // no waiters
@@ -129,7 +128,8 @@ RC waitdie_t::lock_get(lock_type_t type, txn_man_t* txn, Access* access, int tid
     }
 #endif
 final:
-    pthread_mutex_unlock(latch);
+    word.unlatch(owners, owner_cnt, lock_type, waiter_cnt);
+done:
 #ifdef BREAKDOWN
     uint64_t end = asm_rdtsc();
     uint64_t t_lock_critical_section = end - start;
@@ -146,32 +146,22 @@ final:
 
 // lock for DPU to host migration
 RC waitdie_t::lock_get(int tid){
-    //debug::notify_info("LOCKGET for DPU to host migration");
-    RC rc = RCOK;
-
     auto entry = get_entry();
-    entry->type = LOCK_SH;
+    entry->type = LOCK_EX;
     entry->client_id = tid;
+    entry->access = nullptr;
 
-    pthread_mutex_lock(latch);
-    bool conflict = lock_conflict(lock_type, entry->type);
-    if(!conflict){ // lock conflicts -- cannot be added to the owner list
-	pthread_mutex_unlock(latch);
-	return_entry(entry);
-	return ABORT;
-    }
-    // no conflict -- add it to owners list
-    STACK_PUSH(owners, entry);
-    owner_cnt++;
-    lock_type = entry->type;
-
-    pthread_mutex_unlock(latch);
-    return rc;
+    // only an idle row is taken, the evictor skips rows in use
+    if(word.try_acquire(entry))
+	return RCOK;
+    return_entry(entry);
+    return ABORT;
 }
 
 
 void waitdie_t::lock_release(txn_man_t* txn, int client_id, int tid){
     RC rc = RCOK;
+    lock_entry_t* en = nullptr;
     lock_entry_t* prev = nullptr;
     lock_entry_t* temp = nullptr;
     std::vector<Access*> buffer;
@@ -179,8 +169,11 @@ void waitdie_t::lock_release(txn_man_t* txn, int client_id, int tid){
 #ifdef BREAKDOWN
     uint64_t start = asm_rdtsc();
 #endif
-    pthread_mutex_lock(latch);
-    auto en = owners;
+    temp = word.try_release(client_id);
+    if(temp) // uncontended, single owner
+	goto done;
+    word.latch(owners, owner_cnt, lock_type);
+    en = owners;
 
     // find the entry in the owners list
     while(en && en->client_id != client_id){
@@ -221,7 +214,8 @@ void waitdie_t::lock_release(txn_man_t* txn, int client_id, int tid){
     bring_next(txn, buffer, tid);
     //bring_next(txn, tid);
 
-    pthread_mutex_unlock(latch);
+    word.unlatch(owners, owner_cnt, lock_type, waiter_cnt);
+done:
 #ifdef BREAKDOWN
     uint64_t end = asm_rdtsc();
     uint64_t t_unlock_critical_section = end - start;
@@ -255,12 +249,11 @@ bool waitdie_t::lock_conflict(lock_type_t l1, lock_type_t l2){
 }
 
 lock_entry_t* waitdie_t::get_entry(){
-    lock_entry_t* entry = new lock_entry_t;
-    return entry;
+    return get_lock_entry();
 }
 
 void waitdie_t::return_entry(lock_entry_t* entry){
-    delete entry;
+    return_lock_entry(entry);
 }
 
 void waitdie_t::bring_next(txn_man_t* txn, std::vector<Access*>& buffer, int tid){
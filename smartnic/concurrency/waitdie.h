@@ -1,9 +1,9 @@
 #pragma once
 #include <cstdint>
 #include <atomic>
-#include <pthread.h>
 #include <vector>
 #include "common/global.h"
+#include "concurrency/lock_word.h"
 
 class txn_man_t;
 struct lock_entry_t;
@@ -23,7 +23,8 @@ class waitdie_t{
 	void bring_next(txn_man_t* txn, int tid);
 	void bring_next(txn_man_t* txn, std::vector<Access*>& buffer, int tid);
 
-	pthread_mutex_t* latch;
+	// owner/mode word, the lists below are only valid while latched
+	lock_word_t word;
 
 	lock_type_t lock_type;
 	uint32_t owner_cnt;
@@ -4,11 +4,16 @@
 #include "common/helper.h"
 #include "common/stat.h"
 #include "common/debug.h"
+#ifdef EARLY_LOCK_RELEASE
+#include "storage/row.h"
+#include "worker/page_table.h"
+#endif
 
-woundwait_t::woundwait_t(): owner_cnt(0), waiter_cnt(0), lock_type(LOCK_NONE), owners(nullptr), waiters_head(nullptr), waiters_tail(nullptr){
-    latch = new pthread_mutex_t;
-    pthread_mutex_init(latch, NULL);
-}
+woundwait_t::woundwait_t(): owner_cnt(0), waiter_cnt(0), lock_type(LOCK_NONE), owners(nullptr), waiters_head(nullptr), waiters_tail(nullptr)
+#ifdef EARLY_LOCK_RELEASE
+    , violators(nullptr), violator_cnt(0), grant_seq(0)
+#endif
+{ }
 
 RC woundwait_t::lock_get(lock_type_t type, txn_man_t* txn, Access* access, int tid){
     RC rc = RCOK;
@@ -20,6 +25,9 @@ RC woundwait_t::lock_get(lock_type_t type, txn_man_t* txn, Access* access, int t
     entry->type = type;
     entry->client_id = access->client_id;
     entry->access = access;
+    #ifdef EARLY_LOCK_RELEASE
+    entry->seq = 0;
+    #endif
 
     lock_entry_t* en = nullptr;
     lock_entry_t* prev = nullptr;
@@ -27,7 +35,16 @@ RC woundwait_t::lock_get(lock_type_t type, txn_man_t* txn, Access* access, int t
 #ifdef BREAKDOWN
     uint64_t start = asm_rdtsc();
 #endif
-    pthread_mutex_lock(latch);
+    if(word.try_acquire(entry)) // uncontended, single owner
+	goto done;
+    word.latch(owners, owner_cnt, lock_type);
+
+    #ifdef EARLY_LOCK_RELEASE
+    if(violator_cnt && !wound_violators(txn, timestamp)){
+	rc = ABORT;
+	goto final;
+    }
+    #endif
 
     if(waiter_cnt == 0){ // no waiters
 	bool conflict = lock_conflict(lock_type, type); // shared locks or empty
@@ -35,6 +52,9 @@ RC woundwait_t::lock_get(lock_type_t type, txn_man_t* txn, Access* access, int t
 	    STACK_PUSH(owners, entry);
 	    owner_cnt++;
 	    lock_type = type;
+	    #ifdef EARLY_LOCK_RELEASE
+	    depend(txn, entry);
+	    #endif
 	    goto final;
 	}
     }
@@ -77,6 +97,9 @@ RC woundwait_t::lock_get(lock_type_t type, txn_man_t* txn, Access* access, int t
 	STACK_PUSH(owners, entry);
 	owner_cnt++;
 	lock_type = type;
+	#ifdef EARLY_LOCK_RELEASE
+	depend(txn, entry);
+	#endif
 	assert(rc == RCOK);
     }
     else{ // some txns are running, insert to wait list
@@ -164,7 +187,8 @@ RC woundwait_t::lock_get(lock_type_t type, txn_man_t* txn, Access* access, int t
     //bring_next(txn, tid);
 
  final:
-    pthread_mutex_unlock(latch);
+    word.unlatch(owners, owner_cnt, lock_type, queued());
+ done:
 #ifdef BREAKDOWN
     uint64_t end = asm_rdtsc();
     uint64_t t_lock_critical_section = (end - start);
@@ -177,6 +201,9 @@ RC woundwait_t::lock_get(lock_type_t type, txn_man_t* txn, Access* access, int t
 	    txn->notify(*it, tid);
 	}
     }
+    #ifdef EARLY_LOCK_RELEASE
+    finish_deferred(txn, tid);
+    #endif
 
 #ifdef BREAKDOWN
     end = asm_rdtsc();
@@ -195,32 +222,25 @@ RC woundwait_t::lock_get(lock_type_t type, txn_man_t* txn, Access* access, int t
 
 // lock for DPU to host migration
 RC woundwait_t::lock_get(int tid){
-    //debug::notify_info("LOCKGET for DPU to host migration");
-    RC rc = RCOK;
-
     auto entry = get_entry();
-    entry->type = LOCK_SH;
+    entry->type = LOCK_EX;
     entry->client_id = tid;
-
-    pthread_mutex_lock(latch);
-    bool conflict = lock_conflict(lock_type, entry->type);
-    if(!conflict){ // lock conflicts -- cannot be added to the owner list
-	pthread_mutex_unlock(latch);
-	return_entry(entry);
-	return ABORT;
-    }
-    // no conflict -- add it to owners list
-    STACK_PUSH(owners, entry);
-    owner_cnt++;
-    lock_type = entry->type;
-
-    pthread_mutex_unlock(latch);
-    return rc;
+    entry->access = nullptr;
+    #ifdef EARLY_LOCK_RELEASE
+    entry->seq = 0;
+    #endif
+
+    // only an idle row is taken, the evictor skips rows in use
+    if(word.try_acquire(entry))
+	return RCOK;
+    return_entry(entry);
+    return ABORT;
 }
 
 
 void woundwait_t::lock_release(txn_man_t* txn, int client_id, int tid){
     RC rc = RCOK;
+    lock_entry_t* en = nullptr;
     lock_entry_t* prev = nullptr;
     lock_entry_t* temp = nullptr;
     std::vector<Access*> buffer;
@@ -228,8 +248,11 @@ void woundwait_t::lock_release(txn_man_t* txn, int client_id, int tid){
 #ifdef BREAKDOWN
     uint64_t start = asm_rdtsc();
 #endif
-    pthread_mutex_lock(latch);
-    auto en = owners;
+    temp = word.try_release(client_id);
+    if(temp) // uncontended, single owner
+	goto done;
+    word.latch(owners, owner_cnt, lock_type);
+    en = owners;
 
     // find the entry in the owners list
     while(en && en->client_id != client_id){
@@ -251,6 +274,15 @@ void woundwait_t::lock_release(txn_man_t* txn, int client_id, int tid){
 	if(owner_cnt == 0)
 	    lock_type = LOCK_NONE;
     }
+    #ifdef EARLY_LOCK_RELEASE
+    else{ // an early released write
+	en = violators;
+	while(en && en->client_id != client_id)
+	    en = en->next;
+	if(en) // else, it has been undone along with an aborted predecessor
+	    finish_violator(txn, en, en->access->txn_status->load() == txn_status_t::ABORTING);
+    }
+    #endif
     // else, it has already been removed
 
     if(owner_cnt == 0){
@@ -260,7 +292,8 @@ void woundwait_t::lock_release(txn_man_t* txn, int client_id, int tid){
     bring_next(txn, buffer, tid);
     //bring_next(txn, tid);
 
-    pthread_mutex_unlock(latch);
+    word.unlatch(owners, owner_cnt, lock_type, queued());
+ done:
 #ifdef BREAKDOWN
     uint64_t end = asm_rdtsc();
     uint64_t t_unlock_critical_section = end - start;
@@ -273,6 +306,9 @@ void woundwait_t::lock_release(txn_man_t* txn, int client_id, int tid){
 	    txn->notify(*it, tid);
 	}
     }
+    #ifdef EARLY_LOCK_RELEASE
+    finish_deferred(txn, tid);
+    #endif
 
 #ifdef BREAKDOWN
     end = asm_rdtsc();
@@ -292,6 +328,10 @@ void woundwait_t::bring_next(txn_man_t* txn, std::vector<Access*>& buffer, int t
     lock_entry_t* entry = nullptr;
     // if any waiter can join the owners, just do it
     while(waiters_head && !lock_conflict(lock_type, waiters_head->type)){
+	#ifdef EARLY_LOCK_RELEASE
+	if(violator_cnt && !wound_violators(txn, waiters_head->access->timestamp))
+	    break; // a younger early released write is committing, retried once it finishes
+	#endif
 	LIST_GET_HEAD(waiters_head, waiters_tail, entry);
 	waiter_cnt--;
 
@@ -300,6 +340,9 @@ void woundwait_t::bring_next(txn_man_t* txn, std::vector<Access*>& buffer, int t
 	owner_cnt++;
 
 	lock_type = entry->type;
+	#ifdef EARLY_LOCK_RELEASE
+	depend(txn, entry);
+	#endif
 	buffer.push_back(entry->access);
 	entry = nullptr;
     }
@@ -309,6 +352,10 @@ void woundwait_t::bring_next(txn_man_t* txn, int tid){
     lock_entry_t* entry = nullptr;
     // if any waiter can join the owners, just do it
     while(waiters_head && !lock_conflict(lock_type, waiters_head->type)){
+	#ifdef EARLY_LOCK_RELEASE
+	if(violator_cnt && !wound_violators(txn, waiters_head->access->timestamp))
+	    break; // a younger early released write is committing, retried once it finishes
+	#endif
 	LIST_GET_HEAD(waiters_head, waiters_tail, entry);
 	waiter_cnt--;
 
@@ -317,11 +364,157 @@ void woundwait_t::bring_next(txn_man_t* txn, int tid){
 	owner_cnt++;
 
 	lock_type = entry->type;
+	#ifdef EARLY_LOCK_RELEASE
+	depend(txn, entry);
+	#endif
 	txn->notify(entry->access, tid);
 	entry = nullptr;
     }
 }
  
+#ifdef EARLY_LOCK_RELEASE
+// commits and lock entries handed back once the latch is released
+static thread_local std::vector<Access*> parked_commits;
+static thread_local std::vector<lock_entry_t*> dropped_entries;
+
+RC woundwait_t::lock_release_early(txn_man_t* txn, Access* access, row_t* row, row_t* new_row, int tid){
+    lock_entry_t* en = nullptr;
+    lock_entry_t* prev = nullptr;
+    std::vector<Access*> buffer;
+
+    word.latch(owners, owner_cnt, lock_type);
+    en = owners;
+    while(en && en->client_id != access->client_id){
+	prev = en;
+	en = en->next;
+    }
+
+    // wounded meanwhile, the txn aborts with its next request
+    if(!en || access->txn_status->load() != txn_status_t::RUNNING){
+	word.unlatch(owners, owner_cnt, lock_type, queued());
+	return ABORT;
+    }
+
+    if(prev)
+	prev->next = en->next;
+    else
+	owners = en->next;
+    owner_cnt--;
+    if(owner_cnt == 0)
+	lock_type = LOCK_NONE;
+
+    // the before image is kept until the txn finishes
+    memcpy(access->undo, row, sizeof(row_t));
+    row->copy(new_row);
+    access->lock_status = lock_status_t::LOCK_RELEASED;
+
+    en->seq = grant_seq;
+    STACK_PUSH(violators, en);
+    violator_cnt++;
+
+    bring_next(txn, buffer, tid);
+    word.unlatch(owners, owner_cnt, lock_type, queued());
+
+    for(auto it=buffer.begin(); it!=buffer.end(); it++){
+	txn->notify(*it, tid);
+    }
+    finish_deferred(txn, tid);
+    return RCOK;
+}
+
+// a txn granted while early released writes are pending commits after all of them
+void woundwait_t::depend(txn_man_t* txn, lock_entry_t* entry){
+    if(violator_cnt == 0)
+	return;
+    entry->seq = ++grant_seq;
+    txn->add_dependency(entry->access, violator_cnt);
+}
+
+// dirty rows are only passed on to younger txns, so a commit never waits for a younger
+// txn and dependencies cannot close a cycle with the waits of wound-wait
+bool woundwait_t::wound_violators(txn_man_t* txn, uint64_t timestamp){
+    lock_entry_t* oldest = nullptr;
+    for(auto en = violators; en; en = en->next){
+	if(timestamp < en->access->timestamp && (!oldest || en->seq < oldest->seq))
+	    oldest = en;
+    }
+    if(!oldest)
+	return true;
+
+    if(!txn->wound(oldest->access)) // this txn has already entered commit phase
+	return false;
+    finish_violator(txn, oldest, true);
+    return true;
+}
+
+// an early released write leaves with its txn, the txns granted after it lose a
+// predecessor or, if it aborted, see the write undone and abort as well
+void woundwait_t::finish_violator(txn_man_t* txn, lock_entry_t* violator, bool abort){
+    lock_entry_t* en = violators;
+    lock_entry_t* prev = nullptr;
+    while(en != violator){
+	prev = en;
+	en = en->next;
+    }
+    if(prev)
+	prev->next = violator->next;
+    else
+	violators = violator->next;
+    violator_cnt--;
+    dropped_entries.push_back(violator);
+
+    if(abort){
+	auto access = violator->access;
+	((row_t*)access->entry->local_addr)->copy(access->undo);
+    }
+
+    prev = nullptr;
+    en = violators;
+    while(en){
+	auto next = en->next;
+	if(en->seq > violator->seq){
+	    if(txn->resolve_dependency(en->access, abort))
+		parked_commits.push_back(en->access);
+	    if(abort){ // its write has been undone with the predecessor's
+		if(prev)
+		    prev->next = next;
+		else
+		    violators = next;
+		violator_cnt--;
+		en->access->lock_status = lock_status_t::LOCK_DROPPED;
+		dropped_entries.push_back(en);
+		en = next;
+		continue;
+	    }
+	}
+	prev = en;
+	en = next;
+    }
+
+    for(en = owners; en; en = en->next){
+	if(en->seq > violator->seq && txn->resolve_dependency(en->access, abort))
+	    parked_commits.push_back(en->access);
+    }
+}
+
+void woundwait_t::finish_deferred(txn_man_t* txn, int tid){
+    if(!dropped_entries.empty()){
+	std::vector<lock_entry_t*> dropped;
+	dropped.swap(dropped_entries);
+	for(auto it=dropped.begin(); it!=dropped.end(); it++)
+	    return_entry(*it);
+    }
+
+    // finishing a parked commit releases other locks, so the list is taken first
+    if(!parked_commits.empty()){
+	std::vector<Access*> parked;
+	parked.swap(parked_commits);
+	for(auto it=parked.begin(); it!=parked.end(); it++)
+	    txn->commit_parked(*it, tid);
+    }
+}
+#endif
+
 bool woundwait_t::lock_conflict(lock_type_t l1, lock_type_t l2){
     if(l1 == LOCK_NONE || l2 == LOCK_NONE)
 	return false;
@@ -331,10 +524,9 @@ bool woundwait_t::lock_conflict(lock_type_t l1, lock_type_t l2){
 }
 
 lock_entry_t* woundwait_t::get_entry(){
-    lock_entry_t* entry = new lock_entry_t;
-    return entry;
+    return get_lock_entry();
 }
 
 void woundwait_t::return_entry(lock_entry_t* entry){
-    delete entry;
+    return_lock_entry(entry);
 }
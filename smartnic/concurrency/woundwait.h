@@ -1,13 +1,14 @@
 #pragma once
 #include <cstdint>
 #include <atomic>
-#include <pthread.h>
 #include <vector>
 #include "common/global.h"
+#include "concurrency/lock_word.h"
 
 class txn_man_t;
 struct lock_entry_t;
 class Access;
+class row_t;
 
 class woundwait_t{
     public:
@@ -15,6 +16,10 @@ class woundwait_t{
 	RC lock_get(lock_type_t type, txn_man_t* txn, Access* access, int tid);
 	RC lock_get(int tid);
 	void lock_release(txn_man_t* txn, int client_id, int tid);
+	#ifdef EARLY_LOCK_RELEASE
+	// install the final image of a write and pass the lock on before commit
+	RC lock_release_early(txn_man_t* txn, Access* access, row_t* row, row_t* new_row, int tid);
+	#endif
 
     private:
 	bool lock_conflict(lock_type_t l1, lock_type_t l2);
@@ -22,8 +27,24 @@ class woundwait_t{
 	void return_entry(lock_entry_t* entry);
 	void bring_next(txn_man_t* txn, std::vector<Access*>& buffer, int tid);
 	void bring_next(txn_man_t* txn, int tid);
+	#ifdef EARLY_LOCK_RELEASE
+	void depend(txn_man_t* txn, lock_entry_t* entry);
+	bool wound_violators(txn_man_t* txn, uint64_t timestamp);
+	void finish_violator(txn_man_t* txn, lock_entry_t* violator, bool abort);
+	void finish_deferred(txn_man_t* txn, int tid);
+	#endif
 
-	pthread_mutex_t* latch;
+	// entries that keep the lock word on the slow path besides the owners
+	uint32_t queued(){
+	    #ifdef EARLY_LOCK_RELEASE
+	    return waiter_cnt + violator_cnt;
+	    #else
+	    return waiter_cnt;
+	    #endif
+	}
+
+	// owner/mode word, the lists below are only valid while latched
+	lock_word_t word;
 
 	lock_type_t lock_type;
 	uint32_t owner_cnt;
@@ -35,5 +56,13 @@ class woundwait_t{
 	// waiters is a double linked list that is maintained in timestamp order
 	lock_entry_t* waiters_head; 
 	lock_entry_t* waiters_tail;
+
+	#ifdef EARLY_LOCK_RELEASE
+	// early released writes of unfinished txns, a single linked list
+	// every txn granted while they are pending commits after them
+	lock_entry_t* violators;
+	uint32_t violator_cnt;
+	uint64_t grant_seq;
+	#endif
 };
 
@@ -3,6 +3,9 @@
 #include "common/global.h"
 #include "common/debug.h"
 #include "common/key.h"
+#ifdef INTERLEAVE
+#include "worker/coroutine.h"
+#endif
 
 #define LATCH_BIT (0b10)
 #define INITIAL_BIT (0b100)
@@ -34,8 +37,12 @@ class node_t{
 
 	uint64_t get_version(bool& need_restart){
 	    auto v = version.load();
-	    if(is_locked(v))
+	    if(is_locked(v)){
 		need_restart = true;
+		#ifdef INTERLEAVE
+		coro_yield(); // the latch holder may be a coroutine of this thread waiting on the host
+		#endif
+	    }
 	    return v;
 	}
 
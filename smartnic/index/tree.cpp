@@ -5,6 +5,9 @@
 #include "index/indirection.h"
 #include "worker/transport.h"
 #include "worker/mr.h"
+#include "worker/admission.h"
+#include "worker/arena.h"
+#include "worker/reclaim.h"
 
 static thread_local uint32_t path_stack[MAX_TREE_LEVEL];
 static thread_local uint64_t t_traversal;
@@ -21,15 +24,13 @@ static thread_local uint64_t start, end;
 template <typename Key_t, typename Value_t>
 tree_t<Key_t, Value_t>::tree_t(worker_mr_t* mem, worker_transport_t* transport, int pid): mem(mem), transport(transport), pid(pid){
     set_key<Key_t>();
-    //free_pages.store(0);
-    free_pages.store((uint64_t)(INDEX_PAGE_SIZE));
-    //free_pages.store(INDEX_PAGE_SIZE);
     tab = new indirection_table_t();
     //tab = new indirection_table_t(free_pages.load());
     _root_id.store(0);
 
 #ifdef CACHE
     cache = new tstarling::ThreadSafeScalableCache<uint32_t, uint64_t>(INDEX_CACHE_SIZE);
+    admission = new admission_t(INDEX_CACHE_SIZE);
 #endif
     initialize_root();
 }
@@ -80,14 +81,15 @@ void tree_t<Key_t, Value_t>::initialize_root(){
 #ifdef CACHE 
     auto page_buffer = mem->page_buffer_pool(tid);
     uint64_t remote_addr = rpc_alloc(tid);
-    if(free_pages.load()){ // local cache
-	free_pages.fetch_sub(1);
-	root = new lnode_t<Key_t, Value_t>();
+    auto local_page = dpu_arena->alloc(ARENA_PAGE);
+    if(local_page){ // local cache
+	root = new (local_page) lnode_t<Key_t, Value_t>();
 	root_addr = (uint64_t)root;
 	bool cached = cache->insert(root_id, root_addr);
 	if(!cached){ // cannot be cached, do a remote write
 	    memcpy((void*)page_buffer, root, sizeof(lnode_t<Key_t, Value_t>));
 	    transport->write(page_buffer, remote_addr, PAGE_SIZE, tid, pid);
+	    dpu_arena->free(ARENA_PAGE, local_page);
 	}
     }
     else{
@@ -97,9 +99,9 @@ void tree_t<Key_t, Value_t>::initialize_root(){
     tab->set(root_id, remote_addr);
 #else // static allocation
     uint64_t remote_addr = rpc_alloc(tid);
-    if(free_pages.load()){ // local alloc
-	free_pages.fetch_sub(1);
-	root = new lnode_t<Key_t, Value_t>();
+    auto local_page = dpu_arena->alloc(ARENA_PAGE);
+    if(local_page){ // local alloc
+	root = new (local_page) lnode_t<Key_t, Value_t>();
 	root_addr = (uint64_t)root;
     }
     else{ // remote alloc
@@ -123,6 +125,19 @@ bool tree_t<Key_t, Value_t>::update_root(uint32_t old_id, uint32_t new_id){
     return _root_id.compare_exchange_strong(old_id, new_id);
 }
 
+// a remote page is cached only if it is hotter than the page the cache would evict for it
+template <typename Key_t, typename Value_t>
+bool tree_t<Key_t, Value_t>::admit(uint32_t page_id, int tid){
+#ifdef CACHE
+    uint32_t victim_id;
+    if(!cache->victim(page_id, victim_id))
+	return admission->admit(page_id, ADMIT_NO_VICTIM, tid);
+    return admission->admit(page_id, victim_id, tid);
+#else
+    return false;
+#endif
+}
+
 template <typename Key_t, typename Value_t>
 bool tree_t<Key_t, Value_t>::insert_to_cache(uint32_t node_id, uint64_t node_addr, int tid){
 #ifdef CACHE
@@ -148,7 +163,8 @@ bool tree_t<Key_t, Value_t>::insert_to_cache(uint32_t node_id, uint64_t node_add
 	((node_t<Key_t>*)page_buffer)->write_unlock(); // latch is only released in the copy buffer, not the actual page structure
 	transport->write(page_buffer, evict_remote_addr, PAGE_SIZE, tid, pid);
 	cache->remove(ac);
-	delete local_page;
+	// readers may still be on the page, it stays latched until it is reclaimed
+	dpu_reclaimer->retire(ARENA_PAGE, local_page, tid);
     }
 #endif
     return true;
@@ -162,15 +178,13 @@ bool tree_t<Key_t, Value_t>::update_new_root(uint32_t left, const Key_t& key, ui
     bool cached = false;
     auto page_buffer = mem->page_buffer_pool(tid);
     uint64_t remote_addr = rpc_alloc(tid);
-    bool local = free_pages.load();
-    if(local){ // cache it
-	free_pages.fetch_sub(1);
-	new_root = new inode_t<Key_t, Value_t>(left, key, right, level);
+    auto local_page = dpu_arena->alloc(ARENA_PAGE);
+    if(local_page){ // cache it
+	new_root = new (local_page) inode_t<Key_t, Value_t>(left, key, right, level);
 	cached = insert_to_cache(new_root_id, (uint64_t)new_root, tid);
 	if(!cached){
-	    free_pages.fetch_add(1);
 	    memcpy((void*)page_buffer, new_root, sizeof(inode_t<Key_t, Value_t>));
-	    delete new_root;
+	    dpu_arena->free(ARENA_PAGE, local_page);
 	    new_root = (inode_t<Key_t, Value_t>*)page_buffer;
 	    transport->write(page_buffer, remote_addr, PAGE_SIZE, tid, pid);
 	}
@@ -184,22 +198,20 @@ bool tree_t<Key_t, Value_t>::update_new_root(uint32_t left, const Key_t& key, ui
     if(!update_root(old_root, new_root_id)){ // failed to update root, cleanup
 	tab->clear_addr(new_root_id);
 	rpc_dealloc(tid, remote_addr);
-	if(cached){
-	    free_pages.fetch_add(1);
-	    delete new_root;
-	}
+	if(cached)
+	    dpu_reclaimer->retire(ARENA_PAGE, new_root, tid);
 	return false;
     }
 #else
     uint64_t addr = 0;
-    if(free_pages.load()){ // local alloc
-	free_pages.fetch_sub(1);
-	new_root = new inode_t<Key_t, Value_t>(left, key, right, level);
+    auto local_page = dpu_arena->alloc(ARENA_PAGE);
+    if(local_page){ // local alloc
+	new_root = new (local_page) inode_t<Key_t, Value_t>(left, key, right, level);
 	addr = (uint64_t)new_root;
 	tab->set(new_root_id, addr);
 	if(!update_root(old_root, new_root_id)){
 	    tab->clear_addr(new_root_id);
-	    delete new_root;
+	    dpu_arena->free(ARENA_PAGE, local_page);
 	    return false;
 	}
     }
@@ -505,12 +517,10 @@ RETRY:
     memset(&result, 0, sizeof(result_t<Value_t>));
     bool need_restart = false;
 #if CACHE
-    tstarling::ThreadSafeScalableCache<uint32_t, uint64_t>::ConstAccessor ac;
     uint64_t page_addr, unmasked_addr;
     bool is_remote = false;
-    bool cached = cache->find(ac, page_id);
+    bool cached = cache->find(page_id, page_addr);
     if(cached){
-	page_addr = *ac.get();
 	node = (node_t<Key_t>*)page_addr;
     }
     else{
@@ -671,15 +681,21 @@ RETRY:
     #endif
 
 #ifdef CACHE
+    admission->record(page_id);
     if(is_remote){
-	if(test_probability()){
-	    auto new_addr = new char[PAGE_SIZE];
-	    memcpy(new_addr, (char*)page_buffer, PAGE_SIZE);
-	    if(!insert_to_cache(page_id, (uint64_t)new_addr, tid)){
-		delete new_addr;
+	ADD_STAT(tid, index_miss, 1);
+	if(admit(page_id, tid)){
+	    auto new_addr = dpu_arena->alloc(ARENA_PAGE);
+	    if(new_addr){
+		memcpy(new_addr, (char*)page_buffer, PAGE_SIZE);
+		if(!insert_to_cache(page_id, (uint64_t)new_addr, tid))
+		    dpu_arena->free(ARENA_PAGE, new_addr);
 	    }
 	}
     }
+    else{
+	ADD_STAT(tid, index_hit, 1);
+    }
 #endif
 
     return true;
@@ -698,12 +714,10 @@ RETRY:
     memset(&result, 0, sizeof(result_t<Value_t>));
     bool need_restart = false;
 #if CACHE
-    tstarling::ThreadSafeScalableCache<uint32_t, uint64_t>::ConstAccessor ac;
-    bool cached = cache->find(ac, page_id);
     uint64_t page_addr, unmasked_addr;
     bool is_remote = false;
+    bool cached = cache->find(page_id, page_addr);
     if(cached){
-	page_addr = *ac.get();
 	node = (node_t<Key_t>*)page_addr;
     }
     else{
@@ -806,15 +820,21 @@ RETRY:
 	else t_traversal += (end - start);
 	#endif
 #ifdef CACHE
+	admission->record(page_id);
 	if(is_remote){
-	    if(test_probability()){
-	        auto new_addr = new char[PAGE_SIZE];
-	        memcpy(new_addr, page, PAGE_SIZE);
-	        if(!insert_to_cache(page_id, (uint64_t)new_addr, tid)){
-		    delete new_addr;
-	        }
+	    ADD_STAT(tid, index_miss, 1);
+	    if(admit(page_id, tid)){
+		auto new_addr = dpu_arena->alloc(ARENA_PAGE);
+		if(new_addr){
+		    memcpy(new_addr, page, PAGE_SIZE);
+		    if(!insert_to_cache(page_id, (uint64_t)new_addr, tid))
+			dpu_arena->free(ARENA_PAGE, new_addr);
+		}
 	    }
 	}
+	else{
+	    ADD_STAT(tid, index_hit, 1);
+	}
 #endif
 	// proceed to scan
 	return true;
@@ -885,15 +905,21 @@ RETRY:
     else t_traversal += (end - start);
     #endif
 #ifdef CACHE
+    admission->record(page_id);
     if(is_remote){
-	if(test_probability()){
-	    auto new_addr = new char[PAGE_SIZE];
-	    memcpy(new_addr, (char*)page_buffer, PAGE_SIZE);
-	    if(!insert_to_cache(page_id, (uint64_t)new_addr, tid)){
-	        delete new_addr;
+	ADD_STAT(tid, index_miss, 1);
+	if(admit(page_id, tid)){
+	    auto new_addr = dpu_arena->alloc(ARENA_PAGE);
+	    if(new_addr){
+		memcpy(new_addr, (char*)page_buffer, PAGE_SIZE);
+		if(!insert_to_cache(page_id, (uint64_t)new_addr, tid))
+		    dpu_arena->free(ARENA_PAGE, new_addr);
 	    }
 	}
     }
+    else{
+	ADD_STAT(tid, index_hit, 1);
+    }
 #endif
     return true;
 }
@@ -909,12 +935,10 @@ bool tree_t<Key_t, Value_t>::scan(uint32_t page_id, const Key_t& key, Value_t*&
 RETRY:
     bool need_restart = false;
 #if CACHE
-    tstarling::ThreadSafeScalableCache<uint32_t, uint64_t>::ConstAccessor ac;
-    bool cached = cache->find(ac, page_id);
     uint64_t page_addr, unmasked_addr;
     bool is_remote = false;
+    bool cached = cache->find(page_id, page_addr);
     if(cached){
-	page_addr = *ac.get();
 	page = (lnode_t<Key_t, Value_t>*)page_addr;
     }
     else{
@@ -1013,10 +1037,11 @@ RETRY:
     if((num != cnt) && (page->sibling_ptr != 0)){
 #ifdef CACHE
 	if(is_remote){
-	    auto new_addr = new char[PAGE_SIZE];
-	    memcpy(new_addr, (char*)page_buffer, PAGE_SIZE);
-	    if(!insert_to_cache(page_id, (uint64_t)new_addr, tid)){
-		delete new_addr;
+	    auto new_addr = dpu_arena->alloc(ARENA_PAGE);
+	    if(new_addr){
+		memcpy(new_addr, (char*)page_buffer, PAGE_SIZE);
+		if(!insert_to_cache(page_id, (uint64_t)new_addr, tid))
+		    dpu_arena->free(ARENA_PAGE, new_addr);
 	    }
 	}
 #endif
@@ -1024,10 +1049,11 @@ RETRY:
     }
 #ifdef CACHE
     if(is_remote){
-	auto new_addr = new char[PAGE_SIZE];
-	memcpy(new_addr, (char*)page_buffer, PAGE_SIZE);
-	if(!insert_to_cache(page_id, (uint64_t)new_addr, tid)){
-	    delete new_addr;
+	auto new_addr = dpu_arena->alloc(ARENA_PAGE);
+	if(new_addr){
+	    memcpy(new_addr, (char*)page_buffer, PAGE_SIZE);
+	    if(!insert_to_cache(page_id, (uint64_t)new_addr, tid))
+		dpu_arena->free(ARENA_PAGE, new_addr);
 	}
     }
 #endif
@@ -1044,12 +1070,10 @@ bool tree_t<Key_t, Value_t>::store(uint32_t page_id, const Key_t& key, const Val
 RETRY:
     bool need_restart = false;
 #ifdef CACHE
-    tstarling::ThreadSafeScalableCache<uint32_t, uint64_t>::ConstAccessor ac;
-    bool cached = cache->find(ac, page_id);
     uint64_t page_addr, unmasked_addr;
     bool is_remote = false;
+    bool cached = cache->find(page_id, page_addr);
     if(cached){
-	page_addr = *ac.get();
 	page = (lnode_t<Key_t, Value_t>*)page_addr;
     }
     else{
@@ -1152,15 +1176,15 @@ RETRY:
 #ifdef CACHE
     auto sibling_buffer = mem->sibling_buffer_pool(tid);
     uint64_t remote_addr = rpc_alloc(tid);
-    if(free_pages.load()){ // local cache
-	free_pages.fetch_sub(1);
-	sibling = page->split(split_key);
+    auto local_page = dpu_arena->alloc(ARENA_PAGE);
+    if(local_page){ // local cache
+	sibling = new (local_page) lnode_t<Key_t, Value_t>();
+	page->split(split_key, sibling);
 	sibling_addr = remote_addr;
 	bool cached = insert_to_cache(sibling_id, (uint64_t)sibling, tid);
 	if(!cached){
-	    free_pages.fetch_add(1);
 	    memcpy((void*)sibling_buffer, sibling, sizeof(lnode_t<Key_t, Value_t>));
-	    delete sibling;
+	    dpu_arena->free(ARENA_PAGE, local_page);
 	    transport->write(sibling_buffer, remote_addr, PAGE_SIZE, tid, pid);
 	}
     }
@@ -1171,9 +1195,10 @@ RETRY:
 	transport->write(sibling_buffer, remote_addr, PAGE_SIZE, tid, pid);
     }
 #else
-    if(free_pages.load()){ // local alloc
-	free_pages.fetch_sub(1);
-	sibling = page->split(split_key);
+    auto local_page = dpu_arena->alloc(ARENA_PAGE);
+    if(local_page){ // local alloc
+	sibling = new (local_page) lnode_t<Key_t, Value_t>();
+	page->split(split_key, sibling);
 	sibling_addr = (uint64_t)sibling;
     }
     else{ // remote alloc
@@ -1262,12 +1287,10 @@ RETRY:
     bool need_restart = false;
     inode_t<Key_t, Value_t>* page;
 #if CACHE
-    tstarling::ThreadSafeScalableCache<uint32_t, uint64_t>::ConstAccessor ac;
     uint64_t page_addr, unmasked_addr;
     bool is_remote = false;
-    bool cached = cache->find(ac, page_id);
+    bool cached = cache->find(page_id, page_addr);
     if(cached){
-        page_addr = *ac.get();
         page = (inode_t<Key_t, Value_t>*)page_addr;
     }
     else{
@@ -1366,15 +1389,15 @@ RETRY:
 #ifdef CACHE
     auto sibling_buffer = mem->sibling_buffer_pool(tid);
     uint64_t remote_addr = rpc_alloc(tid);
-    if(free_pages.load()){ // local cache
-        free_pages.fetch_sub(1);
-        sibling = page->split(split_key);
+    auto local_page = dpu_arena->alloc(ARENA_PAGE);
+    if(local_page){ // local cache
+        sibling = new (local_page) inode_t<Key_t, Value_t>(level);
+        page->split(split_key, sibling);
         sibling_addr = remote_addr;
         bool cached = insert_to_cache(sibling_id, (uint64_t)sibling, tid);
 	if(!cached){
-	    free_pages.fetch_add(1);
 	    memcpy((void*)sibling_buffer, sibling, sizeof(inode_t<Key_t, Value_t>));
-	    delete sibling;
+	    dpu_arena->free(ARENA_PAGE, local_page);
 	    transport->write(sibling_buffer, remote_addr, PAGE_SIZE, tid, pid);
 	    transport->write(sibling_buffer, remote_addr, PAGE_SIZE, tid, pid);
         }
@@ -1386,9 +1409,10 @@ RETRY:
 	transport->write(sibling_buffer, remote_addr, PAGE_SIZE, tid, pid);
     }
 #else
-    if(free_pages.load()){ // local alloc
-	free_pages.fetch_sub(1);
-	sibling = page->split(split_key);
+    auto local_page = dpu_arena->alloc(ARENA_PAGE);
+    if(local_page){ // local alloc
+	sibling = new (local_page) inode_t<Key_t, Value_t>(level);
+	page->split(split_key, sibling);
 	sibling_addr = (uint64_t)sibling;
     }
     else{ // remote alloc
@@ -12,6 +12,7 @@
 
 class worker_mr_t;
 class worker_transport_t;
+class admission_t;
 
 template <typename Key_t, typename Value_t>
 class tree_t{
@@ -39,6 +40,7 @@ class tree_t{
         void internal_insert(const Key_t& key, uint32_t value, uint8_t level, int tid);
         void internal_store(uint32_t page_id, const Key_t& key, uint32_t value, uint32_t root_id, uint8_t level, int tid);
 
+	bool admit(uint32_t page_id, int tid);
 	bool insert_to_cache(uint32_t node_id, uint64_t node_addr, int tid);
 	bool update_new_root(uint32_t left, const Key_t& key, uint32_t right, uint8_t level, uint32_t old_root, int tid);
 	bool update_root(uint32_t old_root, uint32_t new_root);
@@ -60,10 +62,9 @@ class tree_t{
 
 	// indirection table (node_id <-> node_addr)
 	indirection_table_t* tab;
-	// # of free index pages
-	std::atomic<int64_t> free_pages;
 #ifdef CACHE
 	tstarling::ThreadSafeScalableCache<uint32_t, uint64_t>* cache;
+	admission_t* admission; // access frequency of the index pages
 #endif
 
 	worker_mr_t* mem;
@@ -46,6 +46,14 @@ struct worker_client_meta{
     #else
     uint32_t qpn[CLIENT_THREAD_NUM];
     #endif
+    #ifdef RPC_RING
+    // worker: the request rings, RPC_RING_SIZE per client
+    uint64_t ring_addr;
+    uint32_t ring_rkey;
+    // client: where credits are returned and oversized requests are pulled from
+    uint64_t credit_addr[CLIENT_THREAD_NUM];
+    uint32_t rkey[CLIENT_THREAD_NUM];
+    #endif
 };
 
 // src/net/resource.cpp
@@ -73,7 +81,7 @@ int socket_data_sync(int sock, int size, char* local, char* remote);
 int socket_connect(const char* ip);
 
 // src/net/operation.cpp
-bool post_send(struct ibv_qp* qp, uint64_t src, int size, uint32_t lkey);
+bool post_send(struct ibv_qp* qp, uint64_t src, int size, uint32_t lkey, uint64_t wr_id=0);
 bool post_send_(struct ibv_qp* qp, uint64_t src, int size, uint32_t lkey);
 bool post_send_batch(struct ibv_qp* qp, uint64_t src, int size, uint32_t lkey, int batch_size);
 bool post_send_imm(struct ibv_qp* qp, uint64_t src, int size, uint32_t lkey, uint32_t imm_data);
@@ -84,11 +92,14 @@ bool post_recv_batch(struct ibv_qp* qp, uint64_t src, int size, uint32_t lkey, u
 
 bool post_read(struct ibv_qp* qp, uint64_t src, uint64_t dest, int size, uint32_t lkey, uint32_t rkey);
 bool post_read(struct ibv_qp* qp, uint64_t src, uint64_t dest, int size, uint32_t lkey, uint32_t rkey, int batch_size);
+bool post_read(struct ibv_qp* qp, uint64_t* src, uint64_t* dest, int size, uint32_t lkey, uint32_t* rkey, int batch_size, uint64_t wr_id=0);
 
 bool post_write(struct ibv_qp* qp, uint64_t src, uint64_t dest, int size, uint32_t lkey, uint32_t rkey);
 bool post_write(struct ibv_qp* qp, uint64_t src, uint64_t dest, int size, uint32_t lkey, uint32_t rkey, int batch_size);
+bool post_write(struct ibv_qp* qp, uint64_t* src, uint64_t* dest, int size, uint32_t lkey, uint32_t* rkey, int batch_size, uint64_t wr_id=0);
+bool post_write_inline(struct ibv_qp* qp, uint64_t src, uint64_t dest, int size, uint32_t rkey); // unsignaled
 
-bool post_cas(struct ibv_qp* qp, uint64_t src, uint64_t dest, uint64_t cmp, uint64_t swp, int size, uint32_t lkey, uint32_t rkey);
+bool post_cas(struct ibv_qp* qp, uint64_t src, uint64_t dest, uint64_t cmp, uint64_t swp, int size, uint32_t lkey, uint32_t rkey, uint64_t wr_id=0);
 
 int poll_cq(struct ibv_cq* cq, int num, struct ibv_wc* wc);
 int poll_cq_(struct ibv_cq* cq, int num, struct ibv_wc* wc);
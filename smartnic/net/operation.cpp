@@ -1,7 +1,7 @@
 #include "net/net.h"
 #include <string.h>
 
-bool post_send(struct ibv_qp* qp, uint64_t src, int size, uint32_t lkey){
+bool post_send(struct ibv_qp* qp, uint64_t src, int size, uint32_t lkey, uint64_t wr_id){
     struct ibv_sge list;
     struct ibv_send_wr wr;
     struct ibv_send_wr *wr_bad;
@@ -13,6 +13,7 @@ bool post_send(struct ibv_qp* qp, uint64_t src, int size, uint32_t lkey){
     list.length = size;
     list.lkey = lkey;
 
+    wr.wr_id = wr_id;
     wr.sg_list = &list;
     wr.num_sge = 1;
     wr.opcode     = IBV_WR_SEND;
@@ -192,7 +193,7 @@ bool post_recv_batch(struct ibv_qp* qp, uint64_t src, int size, uint32_t lkey, u
     return true;
 }
 
-bool post_cas(struct ibv_qp* qp, uint64_t src, uint64_t dest, uint64_t cmp, uint64_t swp, int size, uint32_t lkey, uint32_t rkey){
+bool post_cas(struct ibv_qp* qp, uint64_t src, uint64_t dest, uint64_t cmp, uint64_t swp, int size, uint32_t lkey, uint32_t rkey, uint64_t wr_id){
     struct ibv_sge list;
     struct ibv_send_wr wr;
     struct ibv_send_wr* wr_bad;
@@ -204,7 +205,7 @@ bool post_cas(struct ibv_qp* qp, uint64_t src, uint64_t dest, uint64_t cmp, uint
     list.length = size;
     list.lkey = lkey;
 
-    wr.wr_id = 0;
+    wr.wr_id = wr_id;
     wr.sg_list = &list;
     wr.num_sge = 1;
     wr.opcode = IBV_WR_ATOMIC_CMP_AND_SWP;
@@ -279,6 +280,36 @@ bool post_read(struct ibv_qp* qp, uint64_t src, uint64_t dest, int size, uint32_
     return true;
 }
 
+bool post_read(struct ibv_qp* qp, uint64_t* src, uint64_t* dest, int size, uint32_t lkey, uint32_t* rkey, int batch_size, uint64_t wr_id){
+    struct ibv_sge list[batch_size];
+    struct ibv_send_wr wr[batch_size];
+    struct ibv_send_wr* wr_bad;
+
+    memset(list, 0, sizeof(struct ibv_sge) * batch_size);
+    memset(wr, 0, sizeof(struct ibv_send_wr) * batch_size);
+
+    for(int i=0; i<batch_size; i++){
+        list[i].addr = (uintptr_t)src[i];
+        list[i].length = size;
+        list[i].lkey = lkey;
+
+        wr[i].wr_id = wr_id;
+        wr[i].sg_list = &list[i];
+        wr[i].num_sge = 1;
+        wr[i].opcode = IBV_WR_RDMA_READ;
+        wr[i].next = (i == batch_size-1) ? NULL : &wr[i+1];
+        wr[i].send_flags = (i == batch_size-1) ? IBV_SEND_SIGNALED : 0;
+        wr[i].wr.rdma.remote_addr = dest[i];
+        wr[i].wr.rdma.rkey = rkey[i];
+    }
+
+    if(ibv_post_send(qp, &wr[0], &wr_bad)){
+        debug::notify_error("Failed to ibv_post_send (RDMA READ SCATTER)"); 
+        return false;
+    }
+    return true;
+}
+
 bool post_write(struct ibv_qp* qp, uint64_t src, uint64_t dest, int size, uint32_t lkey, uint32_t rkey){
     struct ibv_sge list;
     struct ibv_send_wr wr;
@@ -307,6 +338,34 @@ bool post_write(struct ibv_qp* qp, uint64_t src, uint64_t dest, int size, uint32
     return true;
 }
 
+// small writes whose completion nobody waits for, the payload is copied at post time and
+// the slot is reclaimed with the next signaled request on the qp
+bool post_write_inline(struct ibv_qp* qp, uint64_t src, uint64_t dest, int size, uint32_t rkey){
+    struct ibv_sge list;
+    struct ibv_send_wr wr;
+    struct ibv_send_wr* wr_bad;
+
+    memset(&list, 0, sizeof(list));
+    memset(&wr, 0, sizeof(wr));
+
+    list.addr = (uintptr_t)src;
+    list.length = size;
+
+    wr.wr_id = 0;
+    wr.sg_list = &list;
+    wr.num_sge = 1;
+    wr.opcode = IBV_WR_RDMA_WRITE;
+    wr.send_flags = IBV_SEND_INLINE;
+    wr.wr.rdma.remote_addr = dest;
+    wr.wr.rdma.rkey = rkey;
+
+    if(ibv_post_send(qp, &wr, &wr_bad)){
+        debug::notify_error("Failed to ibv_post_send (RDMA WRITE INLINE)");
+        return false;
+    }
+    return true;
+}
+
 bool post_write(struct ibv_qp* qp, uint64_t src, uint64_t dest, int size, uint32_t lkey, uint32_t rkey, int batch_size){
     struct ibv_sge list[batch_size];
     struct ibv_send_wr wr[batch_size];
@@ -336,6 +395,37 @@ bool post_write(struct ibv_qp* qp, uint64_t src, uint64_t dest, int size, uint32
     return true;
 }
 
+// scattered rows in one chain, only the last write is signaled
+bool post_write(struct ibv_qp* qp, uint64_t* src, uint64_t* dest, int size, uint32_t lkey, uint32_t* rkey, int batch_size, uint64_t wr_id){
+    struct ibv_sge list[batch_size];
+    struct ibv_send_wr wr[batch_size];
+    struct ibv_send_wr* wr_bad;
+
+    memset(list, 0, sizeof(struct ibv_sge) * batch_size);
+    memset(wr, 0, sizeof(struct ibv_send_wr) * batch_size);
+
+    for(int i=0; i<batch_size; i++){
+        list[i].addr = (uintptr_t)src[i];
+        list[i].length = size;
+        list[i].lkey = lkey;
+
+        wr[i].wr_id = wr_id;
+        wr[i].sg_list = &list[i];
+        wr[i].num_sge = 1;
+        wr[i].opcode = IBV_WR_RDMA_WRITE;
+        wr[i].next = (i == batch_size-1) ? NULL : &wr[i+1];
+        wr[i].send_flags = (i == batch_size-1) ? IBV_SEND_SIGNALED : 0;
+        wr[i].wr.rdma.remote_addr = dest[i];
+        wr[i].wr.rdma.rkey = rkey[i];
+    }
+
+    if(ibv_post_send(qp, &wr[0], &wr_bad)){
+        debug::notify_error("Failed to ibv_post_send (RDMA WRITE SCATTER)"); 
+        return false;
+    }
+    return true;
+}
+
 int poll_cq(struct ibv_cq* cq, int num, struct ibv_wc* wc){
     int cnt = 0;
     while(cnt < num)
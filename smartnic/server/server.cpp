@@ -11,6 +11,12 @@ server_t::server_t(){
     // initiate worker thread
     for(int i=0; i<SERVER_THREAD_NUM; i++)
 	workers.emplace_back(&server_t::handle_message, this, i);
+    #ifdef NEAR_DATA
+    for(int i=0; i<WORKER_THREAD_NUM; i++)
+	scan_jobs[i].store(nullptr);
+    for(int i=0; i<NEAR_DATA_THREAD_NUM; i++)
+	workers.emplace_back(&server_t::run_near_data, this, i);
+    #endif
 
 }
 
@@ -114,9 +120,48 @@ void server_t::handle_request(request_t* request){
 	    response = create_message<response_t>(send_ptr, request->qp_id, response_type::SUCCESS);
 	    break;
 	}			      
+	#ifdef NEAR_DATA
+	case request_type::NEAR_DATA_SCAN:{
+	    // the worker waits for the response, so the request buffer stays intact until then
+	    scan_jobs[request->qp_id].store(request);
+	    return;
+	}
+	#endif
         default:
             debug::notify_error("Unsupported request %d ... Implement me!", request->type);
     }
 
     transport->send((uint64_t)response, sizeof(response_t), request->qp_id);
 }
+
+#ifdef NEAR_DATA
+void server_t::run_near_data(int tid){
+    debug::notify_info("Running Near-Data Thread %d", tid);
+    bind_core_worker(SERVER_THREAD_NUM + tid);
+    while(true){
+	for(int i=0; i<WORKER_THREAD_NUM; i++){
+	    if(!scan_jobs[i].load(std::memory_order_relaxed))
+		continue;
+	    auto request = scan_jobs[i].exchange(nullptr);
+	    if(request)
+		near_data_scan(request);
+	}
+    }
+}
+
+// the rows are read in place, the worker holds their locks for the whole scan
+void server_t::near_data_scan(request_t* request){
+    auto scan = reinterpret_cast<near_data_scan_t*>(request->addr);
+    auto filter = scan->filter;
+    int cnt = 0;
+    for(int i=0; i<scan->num; i++){
+	auto value = *reinterpret_cast<uint64_t*>(scan->addr[i] + filter.offset);
+	if(value >= filter.lo && value <= filter.hi)
+	    scan->values[cnt++] = value;
+    }
+
+    auto send_ptr = mem[0]->response_buffer_pool(request->qp_id);
+    auto response = create_message<response_t>(send_ptr, request->qp_id, response_type::SUCCESS, (uint64_t)cnt);
+    transport->send((uint64_t)response, sizeof(response_t), request->qp_id);
+}
+#endif
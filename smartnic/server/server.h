@@ -21,6 +21,10 @@ class server_t{
     private:
 	void handle_message(int tid);
         void handle_request(request_t* request);
+	#ifdef NEAR_DATA
+	void run_near_data(int tid);
+	void near_data_scan(request_t* request);
+	#endif
 
 	bool init_resources();
 
@@ -39,6 +43,11 @@ class server_t{
 	// thread worker
         std::vector<std::thread> workers;
 
+	#ifdef NEAR_DATA
+	// delegated scan of each worker QP, claimed by the near-data threads
+	std::atomic<request_t*> scan_jobs[WORKER_THREAD_NUM];
+	#endif
+
 
 };
 
@@ -22,14 +22,18 @@ bool server_transport_t::init(uint64_t* mem_pool, uint64_t* mem_size){
 	goto CLEANUP;
 
     // create CQs
-    send_cq = create_cq(context.ctx);
     recv_cq = create_cq(context.ctx);
-    if(!send_cq || !recv_cq)
+    if(!recv_cq)
 	goto CLEANUP;
+    for(int i=0; i<WORKER_THREAD_NUM; i++){
+	send_cq[i] = create_cq(context.ctx);
+	if(!send_cq[i])
+	    goto CLEANUP;
+    }
 
     // create QPs
     for(int i=0; i<WORKER_THREAD_NUM; i++){
-	qp[i] = create_qp(context.pd, send_cq, recv_cq);
+	qp[i] = create_qp(context.pd, send_cq[i], recv_cq);
 	if(!qp[i])
 	    goto CLEANUP;
 	if(!modify_qp_state_to_init(qp[i]))
@@ -56,10 +60,10 @@ CLEANUP:
     for(int i=0; i<WORKER_THREAD_NUM; i++){
         if(qp[i])
             ibv_destroy_qp(qp[i]);
+        if(send_cq[i])
+            ibv_destroy_cq(send_cq[i]);
     }
 
-    if(send_cq)
-        ibv_destroy_cq(send_cq);
     if(recv_cq)
         ibv_destroy_cq(recv_cq);
 
@@ -102,7 +106,7 @@ void server_transport_t::prepost_recv(uint64_t ptr, int size, int qp_id){
 }
 
 void server_transport_t::send(uint64_t ptr, int size, int qp_id){
-    rdma_send(qp[qp_id], send_cq, ptr, size, mr[0]->lkey);
+    rdma_send(qp[qp_id], send_cq[qp_id], ptr, size, mr[0]->lkey);
 }
 
 int server_transport_t::poll(struct ibv_wc* wc, int num){
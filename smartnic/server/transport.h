@@ -16,7 +16,8 @@ class server_transport_t{
 	struct rdma_ctx context;
 	struct server_worker_meta meta;
 	struct ibv_qp* qp[WORKER_THREAD_NUM];
-	struct ibv_cq* send_cq;
+	// one per QP, the near-data threads send responses next to the message handler
+	struct ibv_cq* send_cq[WORKER_THREAD_NUM];
 	struct ibv_cq* recv_cq;
 	struct ibv_mr* mr[MR_PARTITION_NUM];
 };
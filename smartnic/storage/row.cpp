@@ -103,6 +103,39 @@ void row_t::copy(catalog_t* schema, row_t* src){
     set_data(src->get_data(), src->get_tuple_size(schema));
 }
 
+#ifdef PROJECTION
+int row_t::pack(catalog_t* schema, uint64_t cols, char* dst){
+    int size = 0;
+    for(int id=0; id<schema->get_field_cnt(); id++){
+	if(!(cols & PROJ_COL(id)))
+	    continue;
+	int data_size = schema->get_field_size(id);
+	memcpy(&dst[size], &data[schema->get_field_index(id)], data_size);
+	size += data_size;
+    }
+    return size;
+}
+
+// a column never lands before where it was packed, so moving the last one first is safe in place
+void row_t::unpack(catalog_t* schema, uint64_t cols){
+    if(cols == 0) // a whole row came back
+	return;
+    int size = 0;
+    for(int id=0; id<schema->get_field_cnt(); id++){
+	if(cols & PROJ_COL(id))
+	    size += schema->get_field_size(id);
+    }
+    auto packed = (char*)this;
+    for(int id=schema->get_field_cnt()-1; id>=0; id--){
+	if(!(cols & PROJ_COL(id)))
+	    continue;
+	int data_size = schema->get_field_size(id);
+	size -= data_size;
+	memmove(&data[schema->get_field_index(id)], &packed[size], data_size);
+    }
+}
+#endif
+
 void row_t::free_row(){
 }
 
@@ -30,6 +30,13 @@ class row_t{
 	void copy(catalog_t* schema, row_t* src, int idx);
 	void copy(row_t* src);
 
+	#ifdef PROJECTION
+	// the columns in cols back to back into dst, returns their size
+	int pack(catalog_t* schema, uint64_t cols, char* dst);
+	// spreads columns packed at the start of this image back to their offsets
+	void unpack(catalog_t* schema, uint64_t cols);
+	#endif
+
 	int get_table_idx() { return table_idx; }
 	void set_primary_key(uint64_t key) { primary_key = key; }
 	uint64_t get_primary_key() { return primary_key; }
@@ -18,6 +18,7 @@
 #include <memory>
 
 thread_t** threads;
+thread_t** net_threads;
 
 void parse_args(int argc, char* argv[]){
     options_t opt;
@@ -26,6 +27,9 @@ void parse_args(int argc, char* argv[]){
         options.add_options()
             ("threads", "Number of client threads in a compute server to run", cxxopts::value<uint64_t>()->default_value(std::to_string(opt.threads)))
             ("latency", "Enable latency measurement", cxxopts::value<bool>()->default_value((opt.latency ? "true" : "false")))
+            ("batch", "Requests per batch of a network thread (BATCH), 1 sends them one by one", cxxopts::value<uint64_t>()->default_value(std::to_string(opt.batch)))
+            ("batch_deadline", "Microseconds a partial batch waits before it is sent", cxxopts::value<uint64_t>()->default_value(std::to_string(opt.batch_deadline)))
+            ("adaptive_batch", "Grow batches while the DPU is backed up and shrink them when it drains", cxxopts::value<bool>()->default_value((opt.adaptive_batch ? "true" : "false")))
             ("help", "Print help")
             ;
 
@@ -46,6 +50,15 @@ void parse_args(int argc, char* argv[]){
         if(result.count("latency"))
             opt.latency = result["latency"].as<bool>();
 
+        if(result.count("batch"))
+            opt.batch = result["batch"].as<uint64_t>();
+
+        if(result.count("batch_deadline"))
+            opt.batch_deadline = result["batch_deadline"].as<uint64_t>();
+
+        if(result.count("adaptive_batch"))
+            opt.adaptive_batch = result["adaptive_batch"].as<bool>();
+
     }catch(const cxxopts::OptionException& e){
         std::cout << "Error parsing options: " << e.what() << std::endl;
         exit(0);
@@ -62,24 +75,33 @@ void parse_args(int argc, char* argv[]){
 	g_measure_latency = true;
     }
 
+    if(opt.batch != 0)
+	g_batch_size = opt.batch;
+    g_batch_deadline = opt.batch_deadline;
+    g_batch_adaptive = opt.adaptive_batch;
+
     g_init_parallelism = opt.threads;
     g_run_parallelism = opt.threads;
 
     std::cout << "# of compute threads: " << g_run_parallelism << std::endl;
+    #ifdef BATCH
+    std::cout << "Batching: " << g_batch_size << " requests or " << g_batch_deadline << " us" << (g_batch_adaptive ? ", adaptive" : "") << std::endl;
+    #endif
 }
 
 void f(int tid){
     threads[tid]->run();
 }
 
-int main(int argc, char* argv[]){
-    parse_args(argc, argv);
-
 #if defined BATCH || defined BATCH2
-    std::cout << "Batching is not supported in TPCC benchmark" << std::endl;
-    exit(0);
+void n(int tid){
+    net_threads[tid]->run_network();
+}
 #endif
 
+int main(int argc, char* argv[]){
+    parse_args(argc, argv);
+
     std::string path = "../dpu.txt";
     auto conf = new config_t(path);
 
@@ -89,6 +111,28 @@ int main(int argc, char* argv[]){
 
     stat = new stat_t();
 
+    #ifdef BATCH
+    // run network threads for batching
+    std::cout << "Running " << NETWORK_THREAD_NUM << " network threads ..." << std::endl;
+    std::vector<std::thread> network_threads;
+    net_threads = new thread_t* [NETWORK_THREAD_NUM];
+    for(int i=0; i<NETWORK_THREAD_NUM; i++){
+	net_threads[i] = new thread_t;
+	net_threads[i]->init(i, (worker_t*)worker);
+	network_threads.push_back(std::thread(n, i));
+    }
+    #elif defined BATCH2
+    // run network threads for batching
+    std::cout << "Running " << WORKER_THREAD_NUM * 2 << " network threads ..." << std::endl;
+    std::vector<std::thread> network_threads;
+    net_threads = new thread_t* [WORKER_THREAD_NUM * 2];
+    for(int i=0; i<WORKER_THREAD_NUM * 2; i++){
+	net_threads[i] = new thread_t;
+	net_threads[i]->init(i, (worker_t*)worker);
+	network_threads.push_back(std::thread(n, i));
+    }
+    #endif
+
     std::cout << "Initializing threads ... " << std::endl;
     int thread_cnt = g_run_parallelism;
     threads = new thread_t* [thread_cnt];
@@ -125,6 +169,11 @@ int main(int argc, char* argv[]){
     std::cout << "Elapsed time (sec)   : " << elapsed / 1000000000.0 << std::endl;
 
     g_run_finish = true;
+    #if defined BATCH || defined BATCH2
+    // network threads for batching
+    for(auto& t: network_threads) t.join();
+    #endif
+
     if(STATS_ENABLE)
         stat->summary();
     return 0;
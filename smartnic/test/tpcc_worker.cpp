@@ -5,6 +5,8 @@
 #include "worker/tpcc.h"
 #include "worker/worker.h"
 #include "worker/txn.h"
+#include "worker/arena.h"
+#include "worker/reclaim.h"
 #include "net/config.h"
 #include <chrono>
 
@@ -18,6 +20,15 @@ int main(int argc, char* argv[]){
     std::string host = "../host.txt";
     auto conf = new config_t(host);
 
+    uint64_t budget = argc > 1 ? atoi(argv[1]) : DPU_MEMORY_BUDGET; // MB
+    g_node_id = argc > 2 ? atoi(argv[2]) : 0; // memory node (MULTI_DPU)
+    if(g_node_id < 0 || g_node_id >= DPU_NUM){
+	debug::notify_error("Node id %d is out of range (DPU_NUM %d)", g_node_id, DPU_NUM);
+	exit(0);
+    }
+    dpu_arena = new arena_t(budget);
+    dpu_reclaimer = new reclaimer_t;
+
     std::cout << "Initializing worker ... " << std::endl;
     auto worker = new tpcc_worker_t;
     worker->init(conf);
@@ -30,6 +30,9 @@ void parse_args(int argc, char* argv[]){
             ("threads", "Number of client threads in a compute server to run", cxxopts::value<uint64_t>()->default_value(std::to_string(opt.threads)))
             ("zipfian", "Key distribution skew factor to use", cxxopts::value<double>()->default_value(std::to_string(opt.zipfian)))
             ("latency", "Enable latency measurement", cxxopts::value<bool>()->default_value((opt.latency ? "true" : "false")))
+            ("batch", "Requests per batch of a network thread (BATCH), 1 sends them one by one", cxxopts::value<uint64_t>()->default_value(std::to_string(opt.batch)))
+            ("batch_deadline", "Microseconds a partial batch waits before it is sent", cxxopts::value<uint64_t>()->default_value(std::to_string(opt.batch_deadline)))
+            ("adaptive_batch", "Grow batches while the DPU is backed up and shrink them when it drains", cxxopts::value<bool>()->default_value((opt.adaptive_batch ? "true" : "false")))
             ("help", "Print help")
             ;
 
@@ -59,6 +62,15 @@ void parse_args(int argc, char* argv[]){
         if(result.count("latency"))
             opt.latency = result["latency"].as<bool>();
 
+        if(result.count("batch"))
+            opt.batch = result["batch"].as<uint64_t>();
+
+        if(result.count("batch_deadline"))
+            opt.batch_deadline = result["batch_deadline"].as<uint64_t>();
+
+        if(result.count("adaptive_batch"))
+            opt.adaptive_batch = result["adaptive_batch"].as<bool>();
+
     }catch(const cxxopts::OptionException& e){
         std::cout << "Error parsing options: " << e.what() << std::endl;
         exit(0);
@@ -106,11 +118,19 @@ void parse_args(int argc, char* argv[]){
 	g_measure_latency = true;
     }
 
+    if(opt.batch != 0)
+	g_batch_size = opt.batch;
+    g_batch_deadline = opt.batch_deadline;
+    g_batch_adaptive = opt.adaptive_batch;
+
     //g_init_parallelism = opt.threads;
     g_run_parallelism = opt.threads;
 
     std::cout << "Workload size: " << g_synth_table_size << std::endl;
     std::cout << "# of client threads: " << g_run_parallelism << std::endl;
+    #ifdef BATCH
+    std::cout << "Batching: " << g_batch_size << " requests or " << g_batch_deadline << " us" << (g_batch_adaptive ? ", adaptive" : "") << std::endl;
+    #endif
 }
 
 void f(int tid){
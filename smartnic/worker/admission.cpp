@@ -0,0 +1,80 @@
+#include "worker/admission.h"
+#include "common/stat.h"
+
+admission_t::admission_t(uint64_t size): samples(0){
+    width = 1;
+    while(width < size)
+	width <<= 1;
+    sample_size = width * SKETCH_SAMPLE_RATIO;
+
+    counters = new std::atomic<uint8_t>[width * SKETCH_DEPTH];
+    for(uint64_t i=0; i<width*SKETCH_DEPTH; i++)
+	counters[i].store(0, std::memory_order_relaxed);
+}
+
+// the rows of the sketch are indexed by double hashing of a single 64-bit mix
+void admission_t::hash(uint64_t key, uint64_t& h1, uint64_t& h2){
+    uint64_t x = key + 0x9E3779B97F4A7C15UL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9UL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBUL;
+    x = x ^ (x >> 31);
+    h1 = x;
+    h2 = (x >> 32) | 1;
+}
+
+uint32_t admission_t::min_count(uint64_t h1, uint64_t h2){
+    uint32_t min = SKETCH_MAX_COUNT;
+    for(int i=0; i<SKETCH_DEPTH; i++){
+	uint32_t cnt = counters[i * width + ((h1 + i * h2) & (width - 1))].load(std::memory_order_relaxed);
+	if(cnt < min)
+	    min = cnt;
+    }
+    return min;
+}
+
+// conservative update: only the counters holding the minimum grow
+void admission_t::record(uint64_t key){
+    uint64_t h1, h2;
+    hash(key, h1, h2);
+    uint32_t min = min_count(h1, h2);
+    if(min < SKETCH_MAX_COUNT){
+	for(int i=0; i<SKETCH_DEPTH; i++){
+	    auto& counter = counters[i * width + ((h1 + i * h2) & (width - 1))];
+	    if(counter.load(std::memory_order_relaxed) == min)
+		counter.store(min + 1, std::memory_order_relaxed);
+	}
+    }
+
+    // exactly one thread sees the sample boundary
+    if(samples.fetch_add(1, std::memory_order_relaxed) + 1 == sample_size)
+	age();
+}
+
+uint32_t admission_t::estimate(uint64_t key){
+    uint64_t h1, h2;
+    hash(key, h1, h2);
+    return min_count(h1, h2);
+}
+
+void admission_t::age(){
+    for(uint64_t i=0; i<width*SKETCH_DEPTH; i++){
+	auto cnt = counters[i].load(std::memory_order_relaxed);
+	if(cnt)
+	    counters[i].store(cnt >> 1, std::memory_order_relaxed);
+    }
+    samples.fetch_sub(sample_size, std::memory_order_relaxed);
+}
+
+bool admission_t::admit(uint64_t candidate, uint64_t victim, int tid){
+    bool admitted = true;
+    if(victim != ADMIT_NO_VICTIM) // there is still room without evicting
+	admitted = estimate(candidate) > estimate(victim);
+
+    if(admitted){
+	ADD_STAT(tid, admit_cnt, 1);
+    }
+    else{
+	ADD_STAT(tid, reject_cnt, 1);
+    }
+    return admitted;
+}
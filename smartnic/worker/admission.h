@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include "common/global.h"
+
+#define ADMIT_NO_VICTIM 	UINT64_MAX
+
+// TinyLFU admission filter of the DPU row buffer and index cache
+// a count-min sketch of small saturating counters estimates how often a key was accessed
+// recently, all counters are halved every sample_size accesses so old popularity fades
+// counters are updated with relaxed loads/stores, a lost increment only makes the estimate lower
+class admission_t{
+    public:
+	admission_t(uint64_t size);
+
+	void record(uint64_t key);
+	uint32_t estimate(uint64_t key);
+	// a candidate is admitted only if it is hotter than the victim it replaces
+	bool admit(uint64_t candidate, uint64_t victim, int tid);
+
+    private:
+	void hash(uint64_t key, uint64_t& h1, uint64_t& h2);
+	uint32_t min_count(uint64_t h1, uint64_t h2);
+	void age();
+
+	uint64_t width; // counters per row, a power of two
+	uint64_t sample_size;
+	std::atomic<uint8_t>* counters; // SKETCH_DEPTH rows of width counters
+	std::atomic<uint64_t> samples;
+};
@@ -0,0 +1,116 @@
+#include "worker/arena.h"
+#include "concurrency/lock_word.h"
+#include "common/huge_page.h"
+#include "common/debug.h"
+
+static const char* class_name[ARENA_CLASS_NUM] = {"page", "row"};
+
+arena_t::arena_t(uint64_t budget_mb): huge(true), next_slab(0){
+    slab_num = budget_mb * 1024 * 1024 / ARENA_SLAB_SIZE;
+    uint64_t size = slab_num * ARENA_SLAB_SIZE;
+
+    auto addr = huge_page_alloc(size);
+    if(addr == MAP_FAILED){ // not enough huge pages reserved, take regular pages
+	huge = false;
+	addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if(addr == MAP_FAILED){
+	    debug::notify_error("Failed to map the DPU arena (%lu MB)", budget_mb);
+	    exit(0);
+	}
+    }
+    base = reinterpret_cast<char*>(addr);
+
+    uint64_t obj_size[ARENA_CLASS_NUM] = {PAGE_SIZE, ROW_SIZE};
+    for(int i=0; i<ARENA_CLASS_NUM; i++){
+	auto c = &classes[i];
+	c->latch.store(false);
+	c->obj_size = (obj_size[i] + CACHELINE_SIZE - 1) / CACHELINE_SIZE * CACHELINE_SIZE;
+	c->per_slab = ARENA_SLAB_SIZE / c->obj_size;
+	c->free_list = nullptr;
+	c->free_cnt.store(0);
+	c->used.store(0);
+	c->slabs.store(0);
+    }
+    debug::notify_info("DPU arena of %lu MB (%s pages)", size / 1024 / 1024, huge ? "huge" : "regular");
+}
+
+void arena_t::lock(arena_class_t cls){
+    auto& latch = classes[cls].latch;
+    bool expected = false;
+    while(!latch.compare_exchange_weak(expected, true, std::memory_order_acquire)){
+	expected = false;
+	cpu_relax();
+    }
+}
+
+void arena_t::unlock(arena_class_t cls){
+    classes[cls].latch.store(false, std::memory_order_release);
+}
+
+// carve the next unused slab of the budget into objects of the class, the caller holds the latch
+bool arena_t::grow(arena_class_t cls){
+    auto idx = next_slab.fetch_add(1);
+    if(idx >= slab_num)
+	return false;
+
+    auto c = &classes[cls];
+    auto slab = base + idx * ARENA_SLAB_SIZE;
+    for(uint64_t i=0; i<c->per_slab; i++){
+	auto obj = slab + i * c->obj_size;
+	*reinterpret_cast<void**>(obj) = c->free_list;
+	c->free_list = obj;
+    }
+    c->free_cnt.fetch_add(c->per_slab);
+    c->slabs.fetch_add(1);
+    return true;
+}
+
+void* arena_t::alloc(arena_class_t cls){
+    auto c = &classes[cls];
+    if(c->free_cnt.load(std::memory_order_relaxed) == 0 && next_slab.load(std::memory_order_relaxed) >= slab_num)
+	return nullptr; // out of budget, skip the latch
+
+    lock(cls);
+    if(!c->free_list && !grow(cls)){
+	unlock(cls);
+	return nullptr;
+    }
+    auto obj = c->free_list;
+    c->free_list = *reinterpret_cast<void**>(obj);
+    c->free_cnt.fetch_sub(1);
+    unlock(cls);
+
+    c->used.fetch_add(1);
+    return obj;
+}
+
+void arena_t::free(arena_class_t cls, void* obj){
+    auto c = &classes[cls];
+    lock(cls);
+    *reinterpret_cast<void**>(obj) = c->free_list;
+    c->free_list = obj;
+    c->free_cnt.fetch_add(1);
+    unlock(cls);
+
+    c->used.fetch_sub(1);
+}
+
+int64_t arena_t::available(arena_class_t cls){
+    auto c = &classes[cls];
+    auto taken = next_slab.load();
+    int64_t unused = taken < slab_num ? slab_num - taken : 0;
+    return c->free_cnt.load() + unused * c->per_slab;
+}
+
+void arena_t::print(){
+    auto taken = next_slab.load();
+    if(taken > slab_num)
+	taken = slab_num;
+    debug::notify_info("DPU arena: %lu / %lu MB in slabs", taken * ARENA_SLAB_SIZE / 1024 / 1024, slab_num * ARENA_SLAB_SIZE / 1024 / 1024);
+    for(int i=0; i<ARENA_CLASS_NUM; i++){
+	auto c = &classes[i];
+	auto used = c->used.load();
+	auto slabs = c->slabs.load();
+	debug::notify_info("    %-4s: %lu objects (%lu MB) in %lu slabs (%lu MB)", class_name[i], used, used * c->obj_size / 1024 / 1024, slabs, slabs * ARENA_SLAB_SIZE / 1024 / 1024);
+    }
+}
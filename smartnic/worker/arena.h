@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include "common/global.h"
+
+#define ARENA_SLAB_SIZE 	(2UL * 1024 * 1024) // one huge page
+
+enum arena_class_t{
+    ARENA_PAGE = 0, // index nodes
+    ARENA_ROW, 	    // buffered rows
+    ARENA_CLASS_NUM
+};
+
+// DPU memory for index pages and rows under a single hard budget
+// the budget is one hugepage-backed region that is handed out slab by slab to the
+// size classes, a slab stays with its class and freed objects go to the class free list
+class arena_t{
+    public:
+	arena_t(uint64_t budget_mb);
+
+	// returns nullptr once the budget is used up
+	void* alloc(arena_class_t cls);
+	void free(arena_class_t cls, void* obj);
+	// objects of the class that can still be allocated
+	int64_t available(arena_class_t cls);
+	uint64_t object_size(arena_class_t cls){ return classes[cls].obj_size; }
+	void print();
+
+    private:
+	bool grow(arena_class_t cls);
+	void lock(arena_class_t cls);
+	void unlock(arena_class_t cls);
+
+	struct alignas(CACHELINE_SIZE) slab_class_t{
+	    std::atomic<bool> latch;
+	    uint64_t obj_size;
+	    uint64_t per_slab;
+	    void* free_list; // linked through the first word of the free objects
+	    std::atomic<int64_t> free_cnt;
+	    std::atomic<uint64_t> used;
+	    std::atomic<uint64_t> slabs;
+	};
+
+	char* base;
+	uint64_t slab_num;
+	bool huge;
+	std::atomic<uint64_t> next_slab;
+	slab_class_t classes[ARENA_CLASS_NUM];
+};
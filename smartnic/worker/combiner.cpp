@@ -0,0 +1,58 @@
+#include "worker/combiner.h"
+#include "storage/row.h"
+
+#ifdef COMMUTATIVE
+
+combiner_t::combiner_t(){
+    for(int i=0; i<WORKER_THREAD_NUM; i++)
+	slots[i].pending.store(false);
+    for(int i=0; i<COMBINER_LANES; i++)
+	lanes[i].latch.store(false);
+}
+
+void combiner_t::apply(uint32_t row_id, row_t* row, delta_t* ops, int num, int tid){
+    assert(tid < WORKER_THREAD_NUM);
+    int lane = row_id % COMBINER_LANES;
+    auto& slot = slots[tid];
+    slot.lane = lane;
+    slot.row = row;
+    slot.ops = ops;
+    slot.num = num;
+    slot.pending.store(true, std::memory_order_release);
+
+    auto& latch = lanes[lane].latch;
+    while(slot.pending.load(std::memory_order_acquire)){
+	if(!latch.load(std::memory_order_relaxed) && !latch.exchange(true, std::memory_order_acquire)){
+	    combine(lane);
+	    latch.store(false, std::memory_order_release);
+	}
+    }
+}
+
+// latch held, slots of other lanes are left to their own combiner
+void combiner_t::combine(int lane){
+    for(int i=0; i<WORKER_THREAD_NUM; i++){
+	auto& slot = slots[i];
+	if(!slot.pending.load(std::memory_order_acquire) || slot.lane != lane)
+	    continue;
+	auto data = slot.row->get_data();
+	for(int j=0; j<slot.num; j++){
+	    auto& op = slot.ops[j];
+	    if(op.type == DELTA_INT64){
+		auto field = (int64_t*)&data[op.offset];
+		*field += op.i;
+		if(op.fetch)
+		    op.i = *field;
+	    }
+	    else{
+		auto field = (double*)&data[op.offset];
+		*field += op.d;
+		if(op.fetch)
+		    op.d = *field;
+	    }
+	}
+	slot.pending.store(false, std::memory_order_release);
+    }
+}
+
+#endif // end of COMMUTATIVE
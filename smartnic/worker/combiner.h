@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include "common/global.h"
+#include "common/rpc.h"
+
+class row_t;
+
+// flat combining of commutative deltas (COMMUTATIVE)
+// a thread publishes its deltas in its slot, whoever holds the latch of the row's lane applies
+// every published delta of the lane, so a hot row is updated by one core instead of all of them
+// bouncing its cachelines, the others only spin on their own slot
+class combiner_t{
+    public:
+	combiner_t();
+
+	// returns once the deltas are applied, fetch deltas hold the new value of their field
+	void apply(uint32_t row_id, row_t* row, delta_t* ops, int num, int tid);
+
+    private:
+	void combine(int lane);
+
+	struct alignas(CACHELINE_SIZE) slot_t{
+	    std::atomic<bool> pending;
+	    int lane;
+	    row_t* row;
+	    delta_t* ops;
+	    int num;
+	};
+
+	struct alignas(CACHELINE_SIZE) lane_t{
+	    std::atomic<bool> latch;
+	};
+
+	slot_t slots[WORKER_THREAD_NUM];
+	lane_t lanes[COMBINER_LANES];
+};
@@ -0,0 +1,101 @@
+#include "worker/coroutine.h"
+#include "common/debug.h"
+
+#ifdef INTERLEAVE
+
+thread_local int coro_current = CORO_NONE;
+static thread_local coro_sched_t* coro_self = nullptr;
+
+coro_sched_t::coro_sched_t(std::function<void(int)> body): body(body), idle(CORO_NUM){
+    coro_self = this;
+    for(int i=0; i<CORO_NUM; i++){
+	stack[i] = new char[CORO_STACK_SIZE];
+	state[i] = CORO_IDLE;
+	getcontext(&ctx[i]);
+	ctx[i].uc_stack.ss_sp = stack[i];
+	ctx[i].uc_stack.ss_size = CORO_STACK_SIZE;
+	ctx[i].uc_link = &sched_ctx;
+	makecontext(&ctx[i], entry, 0);
+    }
+}
+
+coro_sched_t::~coro_sched_t(){
+    for(int i=0; i<CORO_NUM; i++)
+	delete[] stack[i];
+    coro_self = nullptr;
+}
+
+// a coroutine serves one request after another, it is only resumed once a request is handed to it
+void coro_sched_t::entry(){
+    auto self = coro_self;
+    int id = coro_current;
+    while(true){
+	self->body(id);
+	self->switch_to_sched(CORO_IDLE);
+    }
+}
+
+void coro_sched_t::switch_to_sched(coro_state_t next){
+    int id = coro_current;
+    state[id] = next;
+    if(next == CORO_IDLE)
+	idle++;
+    swapcontext(&ctx[id], &sched_ctx);
+}
+
+int coro_sched_t::idle_num(){
+    return idle;
+}
+
+int coro_sched_t::take_idle(){
+    for(int i=0; i<CORO_NUM; i++){
+	if(state[i] == CORO_IDLE){
+	    state[i] = CORO_READY;
+	    idle--;
+	    return i;
+	}
+    }
+    return CORO_NONE;
+}
+
+void coro_sched_t::resume(int id){
+    state[id] = CORO_READY;
+    coro_current = id;
+    swapcontext(&sched_ctx, &ctx[id]);
+    coro_current = CORO_NONE;
+}
+
+void coro_sched_t::complete(uint64_t wr_id){
+    int id = (int)wr_id - 1;
+    if(id < 0 || id >= CORO_NUM || state[id] != CORO_WAITING){
+	debug::notify_error("Completion (wr_id %lu) without a waiting coroutine", wr_id);
+	return;
+    }
+    resume(id);
+}
+
+void coro_sched_t::run_ready(){
+    for(int i=0; i<CORO_NUM; i++){
+	if(state[i] == CORO_READY)
+	    resume(i);
+    }
+}
+
+void coro_sched_t::wait(){
+    switch_to_sched(CORO_WAITING);
+}
+
+void coro_sched_t::yield(){
+    switch_to_sched(CORO_READY);
+}
+
+void coro_wait(){
+    coro_self->wait();
+}
+
+void coro_yield(){
+    if(coro_current != CORO_NONE)
+	coro_self->yield();
+}
+
+#endif // end of INTERLEAVE
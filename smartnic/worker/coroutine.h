@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <ucontext.h>
+#include "common/global.h"
+
+#define CORO_NONE 		-1
+// signalled work requests of a coroutine carry its id + 1, wr_id 0 is left to the blocking paths
+#define CORO_WR_ID(id) 		((uint64_t)(id) + 1)
+
+enum coro_state_t{
+    CORO_IDLE = 0, 	// no request handed to it
+    CORO_READY, 	// runnable, resumed in the next round of the scheduler
+    CORO_WAITING 	// its signalled verb has not completed yet
+};
+
+// the coroutine running on this thread, CORO_NONE on the scheduler stack
+extern thread_local int coro_current;
+
+static inline int coro_id(){
+    return coro_current;
+}
+
+// work request id of the running coroutine, 0 outside a coroutine
+static inline uint64_t coro_wr_id(){
+    return coro_current == CORO_NONE ? 0 : CORO_WR_ID(coro_current);
+}
+
+// back to the scheduler until the verb posted with coro_wr_id() completes
+void coro_wait();
+// lets the other coroutines of the thread run, no-op outside a coroutine
+void coro_yield();
+
+// request-handling coroutines of a worker thread, each on its own stack
+// a coroutine runs until it waits for a host-memory verb, yields on a page latched by a
+// sibling or finishes its request, the thread then resumes others from its CQ
+class coro_sched_t{
+    public:
+	// body serves one request on the coroutine given by its argument
+	coro_sched_t(std::function<void(int)> body);
+	~coro_sched_t();
+
+	// scheduler side
+	int idle_num();
+	int take_idle(); // marks an idle coroutine busy, CORO_NONE if there is none
+	void resume(int id);
+	void complete(uint64_t wr_id);
+	void run_ready();
+
+	// coroutine side
+	void wait();
+	void yield();
+
+    private:
+	static void entry();
+	void switch_to_sched(coro_state_t next);
+
+	std::function<void(int)> body;
+	ucontext_t sched_ctx;
+	ucontext_t ctx[CORO_NUM];
+	char* stack[CORO_NUM];
+	coro_state_t state[CORO_NUM];
+	int idle;
+};
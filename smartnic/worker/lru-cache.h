@@ -178,6 +178,13 @@ public:
    */
   bool find(ConstAccessor& ac, const TKey& key);
 
+  /**
+   * Find a value by key and copy it out, the element is not held after the
+   * call returns. The caller has to make sure the value stays valid on its
+   * own, e.g. by deferring the reclamation of evicted values.
+   */
+  bool find(const TKey& key, TValue& value);
+
   /**
    * Insert a value into the container. Both the key and value will be copied.
    * The new element will put into the eviction list as the most-recently
@@ -191,6 +198,12 @@ public:
   bool insert_with_evict(const TKey& key, const TValue& value, bool& evicted, Accessor& evictAccessor);
   bool insert_with_evict(const TKey& key, const TValue& value, bool& evicted, TKey& evict_key, TValue& evict_value);
 
+  /**
+   * Get the key an insert would evict right now. Returns false if the
+   * container still has room, so an insert would not evict anything.
+   */
+  bool victim(TKey& victim_key);
+
   /**
    * Clear the container. NOT THREAD SAFE -- do not use while other threads
    * are accessing the container.
@@ -278,6 +291,17 @@ ThreadSafeLRUCache(size_t maxSize)
   m_tail.m_prev = &m_head;
 }
 
+template <class TKey, class TValue, class THash>
+bool ThreadSafeLRUCache<TKey, TValue, THash>::
+find(const TKey& key, TValue& value) {
+  ConstAccessor ac;
+  if (!find(ac, key)) {
+    return false;
+  }
+  value = *ac.get();
+  return true;
+}
+
 template <class TKey, class TValue, class THash>
 bool ThreadSafeLRUCache<TKey, TValue, THash>::
 find(ConstAccessor& ac, const TKey& key) {
@@ -441,6 +465,21 @@ insert_with_evict(const TKey& key, const TValue& value, bool& evictionDone, TKey
   return true;
 }
 
+template <class TKey, class TValue, class THash>
+bool ThreadSafeLRUCache<TKey, TValue, THash>::
+victim(TKey& victim_key) {
+  if (m_size.load() < m_maxSize) {
+    return false;
+  }
+  std::lock_guard<ListMutex> lock(m_listMutex);
+  ListNode* last = m_tail.m_prev;
+  if (last == &m_head) {
+    return false;
+  }
+  victim_key = last->m_key;
+  return true;
+}
+
 template <class TKey, class TValue, class THash>
 void ThreadSafeLRUCache<TKey, TValue, THash>::
 clear() {
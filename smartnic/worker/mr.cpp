@@ -1,17 +1,35 @@
 #include "worker/mr.h"
+#ifdef INTERLEAVE
+#include "worker/coroutine.h"
+#endif
+
+// coroutines of a worker thread must not share the buffers of their in-flight verbs
+static inline int buffer_slot(int tid){
+    #ifdef INTERLEAVE
+    int id = coro_id();
+    return tid * CORO_NUM + (id == CORO_NONE ? 0 : id);
+    #else
+    return tid;
+    #endif
+}
 
 worker_mr_t::worker_mr_t(){
     #ifdef BATCH
     // for batched communication, commit buffer is larger than rpc_request buffer
     uint64_t request_msg = (sizeof(rpc_commit_t) + CACHELINE_SIZE) * NETWORK_THREAD_NUM; // # of request buffers match with the # of network threads in client --> can be polled with RDMA batch requests
-    uint64_t response_msg = (sizeof(rpc_response_t) + CACHELINE_SIZE) * WORKER_THREAD_NUM * 2; // # of response buffers match with the # of worker threads in smartnic --> RDMA batch requests are processed one at a time
+    uint64_t response_msg = (sizeof(rpc_response_t) + CACHELINE_SIZE) * WORKER_THREAD_NUM * CORO_NUM * 2; // # of response buffers match with the # of worker threads in smartnic --> RDMA batch requests are processed one at a time
     #elif defined BATCH2
     // for batched communication, commit buffer is larger than rpc_request buffer
     uint64_t request_msg = (sizeof(rpc_commit_t) + CACHELINE_SIZE) * WORKER_THREAD_NUM; // # of request buffers match with the # of network threads in client --> can be polled with RDMA batch requests
-    uint64_t response_msg = (sizeof(rpc_response_t) + CACHELINE_SIZE) * WORKER_THREAD_NUM * 2; // # of response buffers match with the # of worker threads in smartnic --> RDMA batch requests are processed one at a time
+    uint64_t response_msg = (sizeof(rpc_response_t) + CACHELINE_SIZE) * WORKER_THREAD_NUM * CORO_NUM * 2; // # of response buffers match with the # of worker threads in smartnic --> RDMA batch requests are processed one at a time
+    #elif defined RPC_RING
+    // a small ring per client, only requests too large for a frame take a full request buffer
+    uint64_t pull_msg = (sizeof(rpc_request_t<Key>) + CACHELINE_SIZE) * WORKER_THREAD_NUM * CORO_NUM;
+    uint64_t request_msg = (uint64_t)RPC_RING_SIZE * CLIENT_THREAD_NUM + pull_msg;
+    uint64_t response_msg = (sizeof(rpc_response_t) + CACHELINE_SIZE) * WORKER_THREAD_NUM * CORO_NUM;
     #else
     uint64_t request_msg = (sizeof(rpc_request_t<Key>) + CACHELINE_SIZE) * CLIENT_THREAD_NUM;
-    uint64_t response_msg = (sizeof(rpc_response_t) + CACHELINE_SIZE) * WORKER_THREAD_NUM;
+    uint64_t response_msg = (sizeof(rpc_response_t) + CACHELINE_SIZE) * WORKER_THREAD_NUM * CORO_NUM;
     #endif
     uint64_t client_msg = request_msg + response_msg;
 
@@ -26,7 +44,7 @@ worker_mr_t::worker_mr_t(){
     for(int i=0; i<NETWORK_THREAD_NUM; i++)
 	rpc_request_buffer[i] = reinterpret_cast<base_request_t*>(request_base + (sizeof(rpc_commit_t) + CACHELINE_SIZE) * i);
 	//rpc_request_buffer[i] = reinterpret_cast<base_request_t*>(client_memory_pool + (sizeof(rpc_commit_t) + CACHELINE_SIZE) * i);
-    for(int i=0; i<WORKER_THREAD_NUM*2; i++){
+    for(int i=0; i<WORKER_THREAD_NUM*CORO_NUM*2; i++){
 	rpc_response_buffer[i] = reinterpret_cast<rpc_response_t*>(response_base + (sizeof(rpc_response_t) + CACHELINE_SIZE) * i);
 	//rpc_response_buffer[i] = reinterpret_cast<rpc_response_t*>(client_memory_pool + (sizeof(rpc_commit_t) + CACHELINE_SIZE) * NETWORK_THREAD_NUM + (sizeof(rpc_response_t) + CACHELINE_SIZE) * i);
     }
@@ -36,32 +54,53 @@ worker_mr_t::worker_mr_t(){
     for(int i=0; i<WORKER_THREAD_NUM; i++)
 	rpc_request_buffer[i] = reinterpret_cast<base_request_t*>(request_base + (sizeof(rpc_commit_t) + CACHELINE_SIZE) * i);
 	//rpc_request_buffer[i] = reinterpret_cast<base_request_t*>(client_memory_pool + (sizeof(rpc_commit_t) + CACHELINE_SIZE) * i);
-    for(int i=0; i<WORKER_THREAD_NUM*2; i++){
+    for(int i=0; i<WORKER_THREAD_NUM*CORO_NUM*2; i++){
 	rpc_response_buffer[i] = reinterpret_cast<rpc_response_t*>(response_base + (sizeof(rpc_response_t) + CACHELINE_SIZE) * i);
 	//rpc_response_buffer[i] = reinterpret_cast<rpc_response_t*>(client_memory_pool + (sizeof(rpc_commit_t) + CACHELINE_SIZE) * NETWORK_THREAD_NUM + (sizeof(rpc_response_t) + CACHELINE_SIZE) * i);
     }
+    #elif defined RPC_RING
+    ring_buffer = reinterpret_cast<char*>(client_memory_pool);
+    uint64_t pull_base = client_memory_pool + (uint64_t)RPC_RING_SIZE * CLIENT_THREAD_NUM;
+    for(int i=0; i<WORKER_THREAD_NUM*CORO_NUM; i++)
+	pull_buffer[i] = reinterpret_cast<rpc_request_t<Key>*>(pull_base + (sizeof(rpc_request_t<Key>) + CACHELINE_SIZE) * i);
+    for(int i=0; i<WORKER_THREAD_NUM*CORO_NUM; i++)
+	rpc_response_buffer[i] = reinterpret_cast<rpc_response_t*>(pull_base + pull_msg + sizeof(rpc_response_t) * i);
     #else
     for(int i=0; i<CLIENT_THREAD_NUM; i++)
 	rpc_request_buffer[i] = reinterpret_cast<rpc_request_t<Key>*>(client_memory_pool + (sizeof(rpc_request_t<Key>) + CACHELINE_SIZE) * i);
-    for(int i=0; i<WORKER_THREAD_NUM; i++)
+    for(int i=0; i<WORKER_THREAD_NUM*CORO_NUM; i++)
 	rpc_response_buffer[i] = reinterpret_cast<rpc_response_t*>(client_memory_pool + (sizeof(rpc_request_t<Key>) + CACHELINE_SIZE) * CLIENT_THREAD_NUM + sizeof(rpc_response_t) * i);
     #endif
 
-    uint64_t server_msg = (sizeof(request_t) + sizeof(response_t)) * WORKER_THREAD_NUM;
-    uint64_t server_mem = (PAGE_BUFFER_SIZE + SIBLING_BUFFER_SIZE + ROW_SIZE + CACHELINE_SIZE) * WORKER_THREAD_NUM;
+    uint64_t server_msg = (sizeof(request_t) + sizeof(response_t)) * WORKER_THREAD_NUM * CORO_NUM;
+    uint64_t server_mem = (PAGE_BUFFER_SIZE + SIBLING_BUFFER_SIZE + ROW_SIZE + CACHELINE_SIZE) * WORKER_THREAD_NUM * CORO_NUM;
+    #ifdef BUFFER
+    server_mem += ROW_SIZE * EVICT_BATCH_SIZE * 2;
+    #endif
+    #if defined BATCH || defined BATCH2
+    server_mem += ROW_SIZE * REQUEST_BATCH_SIZE * WORKER_THREAD_NUM * CORO_NUM;
+    #endif
 
     server_memory_region = new memory_region_t(server_msg + server_mem);
     server_memory_size = server_memory_region->size();
     server_memory_pool = reinterpret_cast<uint64_t>(server_memory_region->ptr());
 
     uint64_t buf_size = sizeof(request_t) + sizeof(response_t) + PAGE_BUFFER_SIZE + SIBLING_BUFFER_SIZE + ROW_SIZE + CACHELINE_SIZE;
-    for(int i=0; i<WORKER_THREAD_NUM; i++){
+    for(int i=0; i<WORKER_THREAD_NUM*CORO_NUM; i++){
 	request_buffer[i] = reinterpret_cast<request_t*>(server_memory_pool + buf_size * i);
 	response_buffer[i] = reinterpret_cast<response_t*>(server_memory_pool + buf_size * i + sizeof(request_t));
 	page_buffer[i] = reinterpret_cast<uint64_t>(server_memory_pool + buf_size * i + sizeof(request_t) + sizeof(response_t));
 	sibling_buffer[i] = reinterpret_cast<uint64_t>(server_memory_pool + buf_size * i + sizeof(request_t) + sizeof(response_t) + PAGE_BUFFER_SIZE);
 	row_buffer[i] = reinterpret_cast<row_t*>(server_memory_pool + buf_size * i + sizeof(request_t) + sizeof(response_t) + PAGE_BUFFER_SIZE + SIBLING_BUFFER_SIZE);
     }
+    uint64_t extra_base = server_memory_pool + buf_size * WORKER_THREAD_NUM * CORO_NUM;
+    #ifdef BUFFER
+    evict_buffer = reinterpret_cast<row_t*>(extra_base);
+    extra_base += ROW_SIZE * EVICT_BATCH_SIZE * 2;
+    #endif
+    #if defined BATCH || defined BATCH2
+    prefetch_buffer = reinterpret_cast<row_t*>(extra_base);
+    #endif
 }
 
 uint64_t worker_mr_t::get_client_memory_pool(){
@@ -87,51 +126,71 @@ base_request_t* worker_mr_t::rpc_request_pool(int qp_id){
 }
 
 rpc_response_t* worker_mr_t::rpc_response_pool(int tid){
-    return rpc_response_buffer[tid * 2];
+    return rpc_response_buffer[buffer_slot(tid) * 2];
     //return reinterpret_cast<rpc_response_t*>(client_memory_pool + (sizeof(rpc_commit_t) + sizeof(rpc_response_t)*2 + CACHELINE_SIZE) * tid + sizeof(rpc_commit_t));
 }
 
 rpc_response_t* worker_mr_t::rpc_notify_response_pool(int tid){
-    return rpc_response_buffer[tid * 2 + 1];
+    return rpc_response_buffer[buffer_slot(tid) * 2 + 1];
     //return reinterpret_cast<rpc_response_t*>(client_memory_pool + (sizeof(rpc_commit_t) + sizeof(rpc_response_t)*2 + CACHELINE_SIZE) * tid + sizeof(rpc_commit_t) + sizeof(rpc_response_t));
 }
 
 #else
 
+#ifdef RPC_RING
+char* worker_mr_t::ring_pool(int qp_id){
+    return ring_buffer + (uint64_t)RPC_RING_SIZE * qp_id;
+}
+
+rpc_request_t<Key>* worker_mr_t::pull_buffer_pool(int tid){
+    return pull_buffer[buffer_slot(tid)];
+}
+#else
 rpc_request_t<Key>* worker_mr_t::rpc_request_buffer_pool(int qp_id){
     return rpc_request_buffer[qp_id];
     //return reinterpret_cast<rpc_request_t<Key>*>(client_memory_pool + (sizeof(rpc_request_t<Key>) + sizeof(rpc_response_t)) * tid);
 }
+#endif
 
 rpc_response_t* worker_mr_t::rpc_response_buffer_pool(int tid){
-    return rpc_response_buffer[tid];
+    return rpc_response_buffer[buffer_slot(tid)];
     //return reinterpret_cast<rpc_response_t*>(client_memory_pool + (sizeof(rpc_request_t<Key>) + sizeof(rpc_response_t)) * tid + sizeof(rpc_request_t<Key>));
 }
 #endif
 
 request_t* worker_mr_t::request_buffer_pool(int tid){
-    return request_buffer[tid];
+    return request_buffer[buffer_slot(tid)];
     //return reinterpret_cast<request_t*>(server_memory_pool + (sizeof(request_t)+ sizeof(response_t) + PAGE_BUFFER_SIZE + SIBLING_BUFFER_SIZE + ROW_SIZE + CACHELINE_SIZE) * tid);
 }
 
 response_t* worker_mr_t::response_buffer_pool(int tid){
-    return response_buffer[tid];
+    return response_buffer[buffer_slot(tid)];
     //return reinterpret_cast<response_t*>(server_memory_pool + (sizeof(request_t)+ sizeof(response_t) + PAGE_BUFFER_SIZE + SIBLING_BUFFER_SIZE + ROW_SIZE + CACHELINE_SIZE) * tid + sizeof(request_t));
 }
 
 uint64_t worker_mr_t::page_buffer_pool(int tid){
-    return page_buffer[tid];
+    return page_buffer[buffer_slot(tid)];
     //return (server_memory_pool + (sizeof(request_t)+ sizeof(response_t) + PAGE_BUFFER_SIZE + SIBLING_BUFFER_SIZE + ROW_SIZE + CACHELINE_SIZE) * tid + sizeof(request_t) + sizeof(response_t));
 }
 
 uint64_t worker_mr_t::sibling_buffer_pool(int tid){
-    return sibling_buffer[tid];
+    return sibling_buffer[buffer_slot(tid)];
     //return (server_memory_pool + (sizeof(request_t)+ sizeof(response_t) + PAGE_BUFFER_SIZE + SIBLING_BUFFER_SIZE + ROW_SIZE + CACHELINE_SIZE) * tid + sizeof(request_t) + sizeof(response_t) + PAGE_SIZE);
 }
 
 row_t* worker_mr_t::row_buffer_pool(int tid){
-    return row_buffer[tid];
+    return row_buffer[buffer_slot(tid)];
     //return reinterpret_cast<row_t*>(server_memory_pool + (sizeof(request_t)+ sizeof(response_t) + PAGE_BUFFER_SIZE + SIBLING_BUFFER_SIZE + ROW_SIZE + CACHELINE_SIZE) * tid + sizeof(request_t) + sizeof(response_t) + PAGE_SIZE + SIBLING_BUFFER_SIZE);
 }
 
+#ifdef BUFFER
+row_t* worker_mr_t::evict_buffer_pool(int idx){
+    return reinterpret_cast<row_t*>((uint64_t)evict_buffer + ROW_SIZE * idx);
+}
+#endif
 
+#if defined BATCH || defined BATCH2
+row_t* worker_mr_t::prefetch_buffer_pool(int tid, int idx){
+    return reinterpret_cast<row_t*>((uint64_t)prefetch_buffer + ROW_SIZE * (REQUEST_BATCH_SIZE * buffer_slot(tid) + idx));
+}
+#endif
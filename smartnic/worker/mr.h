@@ -16,20 +16,31 @@ class worker_mr_t{
 
 	#ifdef BATCH
 	base_request_t* rpc_request_buffer[NETWORK_THREAD_NUM];
-	rpc_response_t* rpc_response_buffer[WORKER_THREAD_NUM*2];
+	rpc_response_t* rpc_response_buffer[WORKER_THREAD_NUM*CORO_NUM*2];
 	#elif defined BATCH2
 	base_request_t* rpc_request_buffer[WORKER_THREAD_NUM];
-	rpc_response_t* rpc_response_buffer[WORKER_THREAD_NUM*2];
+	rpc_response_t* rpc_response_buffer[WORKER_THREAD_NUM*CORO_NUM*2];
+	#elif defined RPC_RING
+	char* ring_buffer; // the request rings lead the client memory region
+	rpc_request_t<Key>* pull_buffer[WORKER_THREAD_NUM*CORO_NUM];
+	rpc_response_t* rpc_response_buffer[WORKER_THREAD_NUM*CORO_NUM];
 	#else
 	rpc_request_t<Key>* rpc_request_buffer[CLIENT_THREAD_NUM];
-	rpc_response_t* rpc_response_buffer[WORKER_THREAD_NUM];
+	rpc_response_t* rpc_response_buffer[WORKER_THREAD_NUM*CORO_NUM];
 	#endif
 
-	request_t* request_buffer[WORKER_THREAD_NUM];
-	response_t* response_buffer[WORKER_THREAD_NUM];
-	uint64_t page_buffer[WORKER_THREAD_NUM];
-	uint64_t sibling_buffer[WORKER_THREAD_NUM];
-	row_t* row_buffer[WORKER_THREAD_NUM];
+	// per worker thread, or per coroutine of a worker thread in INTERLEAVE
+	request_t* request_buffer[WORKER_THREAD_NUM*CORO_NUM];
+	response_t* response_buffer[WORKER_THREAD_NUM*CORO_NUM];
+	uint64_t page_buffer[WORKER_THREAD_NUM*CORO_NUM];
+	uint64_t sibling_buffer[WORKER_THREAD_NUM*CORO_NUM];
+	row_t* row_buffer[WORKER_THREAD_NUM*CORO_NUM];
+	#ifdef BUFFER
+	row_t* evict_buffer; // staging rows of the evictor, two batches
+	#endif
+	#if defined BATCH || defined BATCH2
+	row_t* prefetch_buffer; // rows of a request batch read together, per buffer slot
+	#endif
 
 
 	worker_mr_t();
@@ -45,7 +56,12 @@ class worker_mr_t{
 	rpc_response_t* rpc_response_pool(int tid);
 	rpc_response_t* rpc_notify_response_pool(int tid);
 	#else
+	#ifdef RPC_RING
+	char* ring_pool(int qp_id);
+	rpc_request_t<Key>* pull_buffer_pool(int tid);
+	#else
 	rpc_request_t<Key>* rpc_request_buffer_pool(int tid);
+	#endif
 	rpc_response_t* rpc_response_buffer_pool(int tid);
 	#endif
 
@@ -55,4 +71,10 @@ class worker_mr_t{
 	uint64_t page_buffer_pool(int tid);
 	uint64_t sibling_buffer_pool(int tid);
 	row_t* row_buffer_pool(int tid);
+	#ifdef BUFFER
+	row_t* evict_buffer_pool(int idx);
+	#endif
+	#if defined BATCH || defined BATCH2
+	row_t* prefetch_buffer_pool(int tid, int idx);
+	#endif
 };
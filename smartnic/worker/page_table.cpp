@@ -4,41 +4,32 @@
 #include "worker/transport.h"
 #include "worker/mr.h"
 #include "worker/txn.h"
+#include "worker/admission.h"
+#include "worker/arena.h"
+#include "worker/reclaim.h"
 #include "concurrency/nowait.h"
 #include "concurrency/waitdie.h"
 #include "concurrency/woundwait.h"
 #include "common/helper.h"
 #include "common/debug.h"
+#include "common/stat.h"
 
 #include <cassert>
+#include <cstdlib>
+
+static_assert(sizeof(row_t) <= ROW_SIZE, "a buffered row must fit into an arena frame");
 
 // local
-table_entry_t::table_entry_t(uint32_t id, uint64_t local_addr, uint64_t remote_addr, int pid): state(false), id(id), local_addr(local_addr), remote_addr(remote_addr), pid(pid), timestamp(0), next(nullptr){
-    #ifdef WOUNDWAIT
-    manager = new woundwait_t();
-    #elif defined WAITDIE
-    manager = new waitdie_t();
-    #elif defined NOWAIT
-    manager = new nowait_t();
-    #endif
-}
+table_entry_t::table_entry_t(uint32_t id, uint64_t local_addr, uint64_t remote_addr, int pid): timestamp(0), local_addr(local_addr), remote_addr(remote_addr), id(id), pid(pid), state(false), flags(ENTRY_DIRTY){ } // no host copy yet
 
 // remote
-table_entry_t::table_entry_t(uint32_t id, uint64_t local_addr, uint64_t remote_addr, int pid, bool flag): state(true), id(id), local_addr(local_addr), remote_addr(remote_addr), pid(pid), timestamp(0), next(nullptr){
-    #ifdef WOUNDWAIT
-    manager = new woundwait_t();
-    #elif defined WAITDIE
-    manager = new waitdie_t();
-    #elif defined NOWAIT
-    manager = new nowait_t();
-    #endif
-}
+table_entry_t::table_entry_t(uint32_t id, uint64_t local_addr, uint64_t remote_addr, int pid, bool flag): timestamp(0), local_addr(local_addr), remote_addr(remote_addr), id(id), pid(pid), state(true), flags(0){ }
 
 
 // table entry
 RC table_entry_t::lock(lock_type_t type, txn_man_t* txn, Access* access, int tid){
-    #if defined NOWAIT || defined WAITDIE || defined WOUNDWAIT
-    return manager->lock_get(type, txn, access, tid);
+    #if defined NOWAIT || defined WAITDIE || defined WOUNDWAIT || defined DETERMINISTIC
+    return manager.lock_get(type, txn, access, tid);
     #else
     return manager.lock_get(type);
     #endif
@@ -46,8 +37,8 @@ RC table_entry_t::lock(lock_type_t type, txn_man_t* txn, Access* access, int tid
 
 // lock for DPU to host migration
 RC table_entry_t::lock(int tid){
-    #if defined NOWAIT || defined WAITDIE || defined WOUNDWAIT
-    return manager->lock_get(tid);
+    #if defined NOWAIT || defined WAITDIE || defined WOUNDWAIT || defined DETERMINISTIC
+    return manager.lock_get(tid);
     #else
     return manager.lock_get();
     #endif
@@ -55,12 +46,12 @@ RC table_entry_t::lock(int tid){
 
 
 void table_entry_t::release(access_t type, txn_man_t* txn, int client_id, int tid, uint64_t timestamp){
-    #if defined NOWAIT || defined WAITDIE || defined WOUNDWAIT
+    #if defined NOWAIT || defined WAITDIE || defined WOUNDWAIT || defined DETERMINISTIC
     if(!is_remote())
 	update_timestamp(timestamp);
-    manager->lock_release(txn, client_id, tid);
+    manager.lock_release(txn, client_id, tid);
     #else // ROW_LOCK
-    if(type == READ || type == SCAN){
+    if(type == READ || type == SCAN || type == DELTA){
 	if(!is_remote())
 	    update_timestamp(timestamp);
 	manager.lock_release(LOCK_SH);
@@ -75,78 +66,150 @@ void table_entry_t::release(access_t type, txn_man_t* txn, int client_id, int ti
 
 // unlock for DPU to host migration
 void table_entry_t::release(txn_man_t* txn, int client_id, int tid){
-    #if defined NOWAIT || defined WAITDIE || defined WOUNDWAIT
-    manager->lock_release(txn, client_id, tid);
+    #if defined NOWAIT || defined WAITDIE || defined WOUNDWAIT || defined DETERMINISTIC
+    manager.lock_release(txn, client_id, tid);
     #else // ROW_LOCK
     manager.lock_release();
     #endif
 }
 
+#ifdef EARLY_LOCK_RELEASE
+// install the final image of a local write and hand the lock to the next txn
+RC table_entry_t::release_early(txn_man_t* txn, Access* access, row_t* new_row, int tid){
+    update_timestamp(access->timestamp);
+    set_dirty();
+    return manager.lock_release_early(txn, access, (row_t*)local_addr, new_row, tid);
+}
+#endif
+
 
 // page table
 page_table_t::page_table_t(): size(DEFAULT_BUFFER_SIZE), next_id(1){
-    size_t tab_size = sizeof(uint64_t) * size;
-    auto addr = huge_page_alloc(tab_size);
-    //memset(addr, 0, tab_size);
-
-    tab = reinterpret_cast<std::atomic<table_entry_t*>*>(addr);
-    for(int i=0; i<size; i++)
-	tab[i].store(nullptr);
+    init(size);
 }
 
 page_table_t::page_table_t(size_t size): size(size), next_id(1){
-    size_t tab_size = sizeof(uint64_t) * size;
-    auto addr = huge_page_alloc(tab_size);
-    //memset(addr, 0, tab_size);
+    init(size);
+}
 
-    tab = reinterpret_cast<std::atomic<table_entry_t*>*>(addr);
-    for(int i=0; i<size; i++)
-	tab[i].store(nullptr);
+void page_table_t::init(size_t size){
+    // row ids are sequential, so id % bucket_num fills the buckets evenly
+    // rows beyond the buffer size go to overflow buckets
+    bucket_num = (size + BUCKET_SLOTS - 1) / BUCKET_SLOTS;
+    auto addr = huge_page_alloc(sizeof(bucket_t) * bucket_num);
+    auto slots = huge_page_alloc(sizeof(table_entry_t) * BUCKET_SLOTS * bucket_num);
+
+    buckets = reinterpret_cast<bucket_t*>(addr);
+    for(uint64_t i=0; i<bucket_num; i++){
+	buckets[i].tags.store(0);
+	buckets[i].overflow.store(nullptr);
+	buckets[i].slots = reinterpret_cast<table_entry_t*>(slots) + i * BUCKET_SLOTS;
+    }
+
+    #ifdef BUFFER
+    admission = new admission_t(ROW_SKETCH_SIZE);
+    victim.store(ADMIT_NO_VICTIM);
+    clock_hand = 0;
+    batches[0].num = batches[1].num = 0;
+    filling = 0;
+    #endif
+}
+
+bucket_t* page_table_t::alloc_overflow(){
+    auto bucket = reinterpret_cast<bucket_t*>(aligned_alloc(CACHELINE_SIZE, sizeof(bucket_t)));
+    auto slots = aligned_alloc(CACHELINE_SIZE, sizeof(table_entry_t) * BUCKET_SLOTS);
+    if(!bucket || !slots){
+	debug::notify_error("Failed to allocate overflow bucket");
+	exit(0);
+    }
+
+    bucket->tags.store(0);
+    bucket->overflow.store(nullptr);
+    bucket->slots = reinterpret_cast<table_entry_t*>(slots);
+    return bucket;
 }
 
 void page_table_t::set(uint32_t id, uint64_t local_addr, uint64_t remote_addr, int pid, bool is_remote){
-    table_entry_t* entry;
-    if(is_remote)
-	entry = new table_entry_t(id, local_addr, remote_addr, pid, true);
-    else
-	entry = new table_entry_t(id, local_addr, remote_addr, pid);
+    uint8_t tag = get_tag(id);
+    auto bucket = &buckets[id % bucket_num];
 
-    int idx = id % size;
-RETRY:
-    auto cur = tab[idx].load();
-    table_entry_t* prev = nullptr;
-    while(cur){
-	prev = cur;
-	cur = cur->next.load();
-    }
+    while(true){
+	auto tags = bucket->tags.load();
+	for(int i=0; i<BUCKET_SLOTS; i++){
+	    uint64_t shift = i * 8;
+	    if(((tags >> shift) & 0xFF) != BUCKET_TAG_EMPTY)
+		continue;
+
+	    // reserve the slot, fill it, then publish the tag
+	    if(!bucket->tags.compare_exchange_strong(tags, tags | ((uint64_t)BUCKET_TAG_RESERVED << shift))){
+		i = -1; // tags has been reloaded, rescan
+		continue;
+	    }
+
+	    bucket->ids[i] = id;
+	    auto slot = &bucket->slots[i];
+	    if(is_remote)
+		new(slot) table_entry_t(id, local_addr, remote_addr, pid, true);
+	    else
+		new(slot) table_entry_t(id, local_addr, remote_addr, pid);
+	    bucket->tags.fetch_xor((uint64_t)(BUCKET_TAG_RESERVED ^ tag) << shift);
+	    return;
+	}
 
-    if(!prev){ // this entry is empty 
-	if(!tab[idx].compare_exchange_strong(cur, entry))
-	    goto RETRY;
+	// bucket is full, move on to the overflow bucket
+	auto next = bucket->overflow.load();
+	if(!next){
+	    auto new_bucket = alloc_overflow();
+	    if(bucket->overflow.compare_exchange_strong(next, new_bucket))
+		next = new_bucket;
+	    else{ // someone else has linked one
+		free(new_bucket->slots);
+		free(new_bucket);
+	    }
+	}
+	bucket = next;
     }
-    else{ // append
-	if(!prev->next.compare_exchange_strong(cur, entry))
-	    goto RETRY;
+}
+
+table_entry_t* page_table_t::find(uint32_t id){
+    uint8_t tag = get_tag(id);
+    auto bucket = &buckets[id % bucket_num];
+    while(bucket){
+	auto match = match_tag(bucket->tags.load(), tag);
+	while(match){
+	    int i = __builtin_ctzll(match) / 8;
+	    if(bucket->ids[i] == id)
+		return &bucket->slots[i];
+	    match &= match - 1;
+	}
+	bucket = bucket->overflow.load();
     }
+    return nullptr;
 }
 	
 RC page_table_t::get(table_entry_t*& entry, uint32_t id, access_t type, txn_man_t* txn, Access* access, int tid){
-    int idx = id % size;
-    auto cur = tab[idx].load();
-    while(cur){
-	if(cur->id == id){ // found
-	    entry = cur;
-	    access->entry = cur;
-	    if(type == READ || type == SCAN){ // shared
-		return cur->lock(LOCK_SH, txn, access, tid);
-	    }
-	    else{ // exclusive
-		return cur->lock(LOCK_EX, txn, access, tid); 
-	    }
-	}
-	cur = cur->next.load();
+    auto cur = find(id);
+    if(!cur)
+	return ABORT;
+
+    entry = cur;
+    access->entry = cur;
+    #ifdef BUFFER
+    cur->touch();
+    admission->record(id);
+    if(cur->is_remote()){
+	ADD_STAT(tid, buffer_miss, 1);
+    }
+    else{
+	ADD_STAT(tid, buffer_hit, 1);
+    }
+    #endif
+    if(type == READ || type == SCAN || type == DELTA){ // shared, deltas commute
+	return cur->lock(LOCK_SH, txn, access, tid);
+    }
+    else{ // exclusive
+	return cur->lock(LOCK_EX, txn, access, tid); 
     }
-    return ABORT;
 }
 
 uint64_t page_table_t::rpc_alloc(worker_transport_t* transport, worker_mr_t* mem, int tid, int pid){
@@ -162,76 +225,141 @@ uint64_t page_table_t::rpc_alloc(worker_transport_t* transport, worker_mr_t* mem
     return response->addr;
 }
 	
-void page_table_t::replace(table_entry_t*& entry, txn_man_t* txn, int tid){
-    table_entry_t* victim[VICTIM_SIZE];
-    int victim_idx = 0;
-    uint32_t id = entry->id;
-    uint64_t tab_size = size;
-    //uint64_t tab_size = next_id.load();
-
-    //debug::notify_error("REPLACE");
-    //exit(0);
-    while(true){
-	auto idx = rand() % tab_size;
-	auto cur = tab[idx].load();
-	while(cur){
-	    if(cur->id != id && !cur->is_remote()){ // find non-matching entry
-		/*
-		// if failed to lock, try next entry
-		if(cur->lock(tid) == ABORT){
-		    cur = cur->next.load();
+#ifdef BUFFER
+bool page_table_t::admit(table_entry_t* entry, int tid){
+    return admission->admit(entry->id, victim.load(std::memory_order_relaxed), tid);
+}
+
+// move a remote row into a free DPU frame of the arena, the caller holds the row's lock
+// no frame, no migration: the request path never waits for an eviction
+bool page_table_t::migrate(table_entry_t* entry, row_t* row, uint64_t timestamp){
+    auto new_row = (row_t*)dpu_arena->alloc(ARENA_ROW);
+    if(!new_row)
+	return false;
+
+    // readers sharing the lock race for the same row
+    if(entry->flags.fetch_or(ENTRY_MIGRATING) & ENTRY_MIGRATING){
+	dpu_arena->free(ARENA_ROW, new_row);
+	return false;
+    }
+    if(!entry->is_remote()){
+	entry->flags.fetch_and(~ENTRY_MIGRATING);
+	dpu_arena->free(ARENA_ROW, new_row);
+	return false;
+    }
+
+    memcpy(new_row, row, sizeof(row_t));
+    entry->update_timestamp(timestamp);
+    entry->local_addr = (uint64_t)new_row;
+    entry->set_local();
+    entry->flags.fetch_and(~ENTRY_MIGRATING);
+    entry->touch();
+    return true;
+}
+
+// CLOCK sweep of the evictor thread, refills the free frames up to the high watermark
+// rows referenced since the last pass get a second chance, rows in use are skipped
+// returns false if there was nothing to do
+bool page_table_t::evict(txn_man_t* txn, int tid){
+    auto frames = dpu_arena->available(ARENA_ROW);
+    if(frames >= EVICT_LOW_WATERMARK)
+	return false;
+
+    int64_t target = EVICT_HIGH_WATERMARK - frames;
+    int64_t evicted = 0;
+    // at most two turns of the clock, the first one may only clear reference bits
+    for(uint64_t scanned=0; scanned<bucket_num*2 && evicted<target; scanned++){
+	auto bucket = &buckets[clock_hand];
+	clock_hand = (clock_hand + 1) % bucket_num;
+
+	for(; bucket && evicted<target; bucket=bucket->overflow.load()){
+	    uint64_t tags = bucket->tags.load();
+	    for(int slot=0; slot<BUCKET_SLOTS && evicted<target; slot++){
+		auto tag = (tags >> (slot * 8)) & 0xFF;
+		if(tag == BUCKET_TAG_EMPTY || tag == BUCKET_TAG_RESERVED)
 		    continue;
-		}
-		*/
 
-		// ensure this is local
-		if(cur->is_remote()){
-		    //cur->release(txn, tid, tid);
-		    cur = cur->next.load();
+		auto cur = &bucket->slots[slot];
+		if(cur->is_remote() || cur->clear_referenced())
+		    continue;
+		if(cur->lock(tid) != RCOK) // in use
+		    continue;
+		if(cur->is_remote()){ // evicted meanwhile
+		    cur->release(txn, tid, tid);
 		    continue;
 		}
 
-		victim[victim_idx] = cur;
-		victim_idx++;
-		if(victim_idx == VICTIM_SIZE){
-		    int target_idx = -1;
-		    uint64_t target_ts = UINT64_MAX;
-		    for(int i=0; i<victim_idx; i++){
-			auto victim_ts = victim[i]->timestamp.load();
-			if(victim_ts < target_ts){
-			    target_ts = victim_ts;
-			    target_idx = i;
-			}
-		    }
-
-		    for(int i=0; i<victim_idx; i++){
-			if(i == target_idx)
-			    continue;
-			// release locks for other entries as soon as possible 
-			//victim[i]->release(txn, tid, tid);
-		    }
-
-		    auto target = victim[target_idx];
-		    auto data = txn->mem->row_buffer_pool(tid);
-		    memcpy(data, (void*)target->local_addr, ROW_SIZE);
-
-		    uint64_t remote_addr;
-		    if(target->remote_addr == 0){ // rpc alloc
-			remote_addr = rpc_alloc(txn->transport, txn->mem, tid, target->pid);
-		    }
-		    else{ // reuse preallocated remote addr
-			remote_addr = target->remote_addr;
-		    }
-
-		    txn->transport->write((uint64_t)data, remote_addr, ROW_SIZE, tid, target->pid);
-		    target->remote_addr = remote_addr;
-		    target->set_remote();
-		    //target->release(txn, tid, tid);
-		    //debug::notify_info("REPLACE \t\tby tid %d", tid);
-		    return;
-		}
+		evict_one(cur, txn, tid);
+		evicted++;
 	    }
-	    cur = cur->next.load();
 	}
     }
+
+    write_back(txn, tid);
+    complete_write_back(txn, tid);
+    return true;
+}
+
+// the evictor holds the entry's lock until the row is gone from the DPU
+void page_table_t::evict_one(table_entry_t* entry, txn_man_t* txn, int tid){
+    if(!entry->is_dirty()){ // the host copy is up to date
+	finish_evict(entry, txn, tid);
+	return;
+    }
+
+    if(entry->remote_addr == 0){ // rpc alloc shares the qp, no batch may be in flight
+	complete_write_back(txn, tid);
+	entry->remote_addr = rpc_alloc(txn->transport, txn->mem, tid, entry->pid);
+    }
+
+    auto batch = &batches[filling];
+    auto data = txn->mem->evict_buffer_pool(filling * EVICT_BATCH_SIZE + batch->num);
+    memcpy(data, (void*)entry->local_addr, ROW_SIZE);
+    batch->entries[batch->num++] = entry;
+    if(batch->num == EVICT_BATCH_SIZE)
+	write_back(txn, tid);
+}
+
+void page_table_t::finish_evict(table_entry_t* entry, txn_man_t* txn, int tid){
+    auto frame = entry->local_addr;
+    entry->set_remote();
+    entry->local_addr = 0;
+    entry->flags.fetch_and(~ENTRY_DIRTY);
+    entry->release(txn, tid, tid);
+    victim.store(entry->id, std::memory_order_relaxed);
+
+    dpu_reclaimer->retire(ARENA_ROW, (void*)frame, tid);
+}
+
+// post the batch being filled and retire the one in flight, so copying the next
+// batch overlaps with the RDMA WRITEs of this one
+void page_table_t::write_back(txn_man_t* txn, int tid){
+    auto batch = &batches[filling];
+    if(batch->num == 0)
+	return;
+    complete_write_back(txn, tid);
+
+    uint64_t src[EVICT_BATCH_SIZE];
+    uint64_t dest[EVICT_BATCH_SIZE];
+    int pid[EVICT_BATCH_SIZE];
+    for(int i=0; i<batch->num; i++){
+	src[i] = (uint64_t)txn->mem->evict_buffer_pool(filling * EVICT_BATCH_SIZE + i);
+	dest[i] = batch->entries[i]->remote_addr;
+	pid[i] = batch->entries[i]->pid;
+    }
+    txn->transport->write_async(src, dest, pid, ROW_SIZE, batch->num, tid);
+    filling ^= 1;
+}
+
+// wait for the batch in flight, its rows can be read from the host from now on
+void page_table_t::complete_write_back(txn_man_t* txn, int tid){
+    auto batch = &batches[filling ^ 1];
+    if(batch->num == 0)
+	return;
+
+    txn->transport->poll_async(tid);
+    for(int i=0; i<batch->num; i++)
+	finish_evict(batch->entries[i], txn, tid);
+    batch->num = 0;
 }
+#endif
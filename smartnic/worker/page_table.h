@@ -3,34 +3,49 @@
 #include <cstdint>
 #include "common/global.h"
 #include "concurrency/row_lock.h"
+#include "concurrency/woundwait.h"
+#include "concurrency/waitdie.h"
+#include "concurrency/nowait.h"
+#include "concurrency/deterministic.h"
 
-class woundwait_t;
-class waitdie_t;
-class nowait_t;
 class lock_t;
 class txn_man_t;
 class worker_transport_t;
 class worker_mr_t;
+class row_t;
+class admission_t;
 
+#define BUCKET_SLOTS 		8
+#define BUCKET_TAG_EMPTY 	0x00
+#define BUCKET_TAG_RESERVED 	0xFF
+
+// table entry flags
+#define ENTRY_REFERENCED 	0x1 	// accessed since the last pass of the clock hand
+#define ENTRY_DIRTY 		0x2 	// the resident row is newer than its host copy
+#define ENTRY_MIGRATING 	0x4 	// a reader is moving the row to the DPU
+
+// page table slot, lives inline in the bucket's slot array
 class table_entry_t{
     public:
     	#ifdef WOUNDWAIT
-	woundwait_t* manager;
+	woundwait_t manager;
     	#elif defined WAITDIE
-    	waitdie_t* manager;
+    	waitdie_t manager;
     	#elif defined NOWAIT
-    	nowait_t* manager;
+    	nowait_t manager;
+    	#elif defined DETERMINISTIC
+    	deterministic_t manager;
     	#else
     	lock_t manager;
     	#endif
 
-	bool state; // local or remote
-	uint32_t id;
-	int pid;
+	std::atomic<uint64_t> timestamp;
 	uint64_t local_addr;
 	uint64_t remote_addr;
-	std::atomic<uint64_t> timestamp;
-	std::atomic<table_entry_t*> next;
+	uint32_t id;
+	uint16_t pid;
+	bool state; // local or remote
+	std::atomic<uint8_t> flags;
 
 	table_entry_t(uint32_t id, uint64_t local_addr, uint64_t remote_addr, int pid); // local
 	table_entry_t(uint32_t id, uint64_t local_addr, uint64_t remote_addr, int pid, bool flag); // remote
@@ -47,6 +62,29 @@ class table_entry_t{
 	    state = false;
 	}
 
+	// reference bit of the CLOCK sweep, written only when it is not set yet
+	void touch(){
+	    if(!(flags.load(std::memory_order_relaxed) & ENTRY_REFERENCED))
+		flags.fetch_or(ENTRY_REFERENCED);
+	}
+
+	// returns true if the entry gets a second chance
+	bool clear_referenced(){
+	    if(!(flags.load(std::memory_order_relaxed) & ENTRY_REFERENCED))
+		return false;
+	    flags.fetch_and(~ENTRY_REFERENCED);
+	    return true;
+	}
+
+	void set_dirty(){
+	    if(!(flags.load(std::memory_order_relaxed) & ENTRY_DIRTY))
+		flags.fetch_or(ENTRY_DIRTY);
+	}
+
+	bool is_dirty(){
+	    return flags.load() & ENTRY_DIRTY;
+	}
+
 	void update_timestamp(uint64_t cur_ts){
 	    auto ts = timestamp.load();
 	    if(ts < cur_ts){
@@ -58,6 +96,17 @@ class table_entry_t{
 	RC lock(int tid);
 	void release(access_t type, txn_man_t* txn, int client_id, int tid, uint64_t timestamp);
 	void release(txn_man_t* txn, int client_id, int tid);
+	#ifdef EARLY_LOCK_RELEASE
+	RC release_early(txn_man_t* txn, Access* access, row_t* new_row, int tid);
+	#endif
+};
+
+// 64-byte bucket: one tag byte and one row id per slot, so a lookup touches a single cache line
+struct alignas(CACHELINE_SIZE) bucket_t{
+    std::atomic<uint64_t> tags;
+    uint32_t ids[BUCKET_SLOTS];
+    std::atomic<bucket_t*> overflow;
+    table_entry_t* slots;
 };
 
 class page_table_t{
@@ -67,7 +116,11 @@ class page_table_t{
 
 	void set(uint32_t id, uint64_t local_addr, uint64_t remote_addr, int pid, bool is_remote);
 	RC get(table_entry_t*& entry, uint32_t id, access_t type, txn_man_t* txn, Access* access, int tid);
-	void replace(table_entry_t*& replace, txn_man_t* txn, int tid);
+	#ifdef BUFFER
+	bool admit(table_entry_t* entry, int tid);
+	bool migrate(table_entry_t* entry, row_t* row, uint64_t timestamp);
+	bool evict(txn_man_t* txn, int tid);
+	#endif
 	uint64_t rpc_alloc(worker_transport_t* transport, worker_mr_t* mem, int tid, int pid);
 
 	uint64_t get_next_id(){
@@ -75,7 +128,47 @@ class page_table_t{
 	}
 
     private:
+	void init(size_t size);
+	table_entry_t* find(uint32_t id);
+	bucket_t* alloc_overflow();
+	#ifdef BUFFER
+	void evict_one(table_entry_t* entry, txn_man_t* txn, int tid);
+	void finish_evict(table_entry_t* entry, txn_man_t* txn, int tid);
+	void write_back(txn_man_t* txn, int tid);
+	void complete_write_back(txn_man_t* txn, int tid);
+	#endif
+
+	static uint8_t get_tag(uint32_t id){
+	    uint8_t tag = (uint8_t)(((uint64_t)id * 0x9E3779B97F4A7C15UL) >> 56);
+	    if(tag == BUCKET_TAG_EMPTY || tag == BUCKET_TAG_RESERVED)
+		tag = 1;
+	    return tag;
+	}
+
+	// compare all the tags of a bucket at once (SWAR), returns the high bit of each matching byte
+	static uint64_t match_tag(uint64_t tags, uint8_t tag){
+	    uint64_t x = tags ^ (0x0101010101010101UL * tag);
+	    return (x - 0x0101010101010101UL) & ~x & 0x8080808080808080UL;
+	}
+
 	uint64_t size;
+	uint64_t bucket_num;
 	std::atomic<uint64_t> next_id;
-	std::atomic<table_entry_t*>* tab;
+	bucket_t* buckets;
+
+	#ifdef BUFFER
+	// access frequency of the rows, a remote row is only migrated if it is hotter
+	// than the row the evictor dropped last
+	admission_t* admission;
+	std::atomic<uint64_t> victim;
+
+	// evictor state, only touched by the evictor thread
+	struct evict_batch_t{
+	    table_entry_t* entries[EVICT_BATCH_SIZE];
+	    int num;
+	};
+	uint64_t clock_hand;
+	evict_batch_t batches[2]; // one being filled, one in flight
+	int filling;
+	#endif
 };
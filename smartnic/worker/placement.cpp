@@ -0,0 +1,85 @@
+#include "worker/placement.h"
+#include "worker/arena.h"
+#include "storage/table.h"
+#include "index/node.h"
+#include "common/debug.h"
+#include <algorithm>
+
+placement_t::placement_t(uint64_t index_keys): placed(0){
+    // leaves end up about half full after splits, the inner levels add a fraction of that
+    uint64_t leaves = index_keys * 2 / lnode_cardinality<Key, Value> + 1;
+    page_reserve = leaves + leaves * 2 / inode_cardinality<Key> + 1;
+
+    int64_t bytes = dpu_arena->available(ARENA_ROW) * dpu_arena->object_size(ARENA_ROW);
+    bytes -= page_reserve * dpu_arena->object_size(ARENA_PAGE);
+    int64_t rows = bytes / (int64_t)dpu_arena->object_size(ARENA_ROW) - EVICT_HIGH_WATERMARK;
+    row_budget = rows > 0 ? rows : 0;
+    capacity = row_budget;
+}
+
+placement_t::plan_t& placement_t::get_plan(table_t* table, uint64_t ids){
+    auto& plan = plans[table];
+    if(plan.hot.size() < ids)
+	plan.hot.resize(ids, false);
+    return plan;
+}
+
+void placement_t::pin(table_t* table, uint64_t rows){
+    auto& plan = get_plan(table, 0);
+    plan.all = true;
+    plan.rows += rows;
+    row_budget = rows < row_budget ? row_budget - rows : 0;
+}
+
+void placement_t::rank(table_t* table, std::vector<uint32_t>& freq, uint64_t rows_per_id){
+    auto& plan = get_plan(table, freq.size());
+    std::vector<uint32_t> ids;
+    for(uint32_t id=0; id<freq.size(); id++){
+	if(freq[id])
+	    ids.push_back(id);
+    }
+    std::stable_sort(ids.begin(), ids.end(), [&](uint32_t a, uint32_t b){ return freq[a] > freq[b]; });
+
+    uint64_t k = std::min<uint64_t>(ids.size(), row_budget / rows_per_id);
+    for(uint64_t i=0; i<k; i++)
+	plan.hot[ids[i]] = true;
+    plan.rows += k * rows_per_id;
+    row_budget -= k * rows_per_id;
+}
+
+bool placement_t::set_hot(table_t* table, uint64_t id, uint64_t ids){
+    auto& plan = get_plan(table, ids);
+    if(plan.hot[id] || row_budget == 0)
+	return false;
+    plan.hot[id] = true;
+    plan.rows++;
+    row_budget--;
+    return true;
+}
+
+bool placement_t::is_hot(table_t* table, uint64_t id){
+    auto it = plans.find(table);
+    if(it == plans.end())
+	return false;
+    auto& plan = it->second;
+    return plan.all || (id < plan.hot.size() && plan.hot[id]);
+}
+
+row_t* placement_t::alloc(table_t* table, uint64_t id){
+    if(!is_hot(table, id))
+	return nullptr;
+    // pinned tables larger than planned must not eat into the page reserve
+    if(placed.fetch_add(1) >= capacity)
+	return nullptr;
+    return (row_t*)dpu_arena->alloc(ARENA_ROW);
+}
+
+void placement_t::print(){
+    debug::notify_info("Placement plan: %lu rows in DPU memory, %lu index pages reserved", capacity - row_budget, page_reserve);
+    for(auto& it: plans){
+	if(it.second.all)
+	    debug::notify_info("    %-12s: all (%lu rows)", it.first->get_table_name(), it.second.rows);
+	else
+	    debug::notify_info("    %-12s: %lu rows", it.first->get_table_name(), it.second.rows);
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include <vector>
+#include <unordered_map>
+#include "common/global.h"
+
+class table_t;
+class row_t;
+
+// load-time placement of rows between DPU and host memory
+// the plan is built from the access profile of the workload before the tables are loaded,
+// planned rows get a DPU frame and the rest is written to host memory only, so the buffer
+// starts in steady state and keeps headroom for the index pages and later migrations
+class placement_t{
+    public:
+	// row budget: what the arena holds after the index pages and the migration headroom
+	placement_t(uint64_t index_keys);
+
+	// every row of the table
+	void pin(table_t* table, uint64_t rows);
+	// hottest ids first by their sampled access count, each id stands for rows_per_id rows
+	void rank(table_t* table, std::vector<uint32_t>& freq, uint64_t rows_per_id);
+	// a single id, for profiles that are already in rank order
+	bool set_hot(table_t* table, uint64_t id, uint64_t ids);
+
+	uint64_t budget(){ return row_budget; }
+	bool is_hot(table_t* table, uint64_t id);
+	// a DPU frame for a planned row, nullptr for a row that goes to host memory
+	row_t* alloc(table_t* table, uint64_t id);
+	void print();
+
+    private:
+	struct plan_t{
+	    bool all = false;
+	    std::vector<bool> hot; // by id
+	    uint64_t rows = 0;
+	};
+
+	plan_t& get_plan(table_t* table, uint64_t ids);
+
+	uint64_t row_budget; // still to be planned
+	uint64_t capacity;
+	uint64_t page_reserve;
+	std::atomic<uint64_t> placed;
+	std::unordered_map<table_t*, plan_t> plans;
+};
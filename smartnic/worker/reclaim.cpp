@@ -0,0 +1,37 @@
+#include "worker/reclaim.h"
+
+reclaimer_t::reclaimer_t(): global_epoch(1){
+    for(int i=0; i<RECLAIM_THREAD_NUM; i++)
+	slots[i].epoch.store(EPOCH_IDLE);
+}
+
+void reclaimer_t::retire(arena_class_t cls, void* obj, int tid){
+    auto& limbo = slots[slot(tid)].limbo;
+    limbo.push_back({obj, cls, global_epoch.load()});
+    if(limbo.size() % RECLAIM_BATCH == 0)
+	reclaim(tid);
+}
+
+void reclaimer_t::reclaim(int tid){
+    auto cur = global_epoch.load();
+    uint64_t safe = cur;
+    bool caught_up = true;
+    for(int i=0; i<RECLAIM_THREAD_NUM; i++){
+	auto epoch = slots[i].epoch.load();
+	if(epoch == EPOCH_IDLE)
+	    continue;
+	if(epoch < safe)
+	    safe = epoch;
+	if(epoch != cur)
+	    caught_up = false;
+    }
+    if(caught_up)
+	global_epoch.compare_exchange_strong(cur, cur + 1);
+
+    // a thread that announced a later epoch entered after the object was unlinked
+    auto& limbo = slots[slot(tid)].limbo;
+    while(!limbo.empty() && limbo.front().epoch < safe){
+	dpu_arena->free(limbo.front().cls, limbo.front().obj);
+	limbo.pop_front();
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include <deque>
+#include "common/global.h"
+#include "worker/arena.h"
+#ifdef INTERLEAVE
+#include "worker/coroutine.h"
+#endif
+
+#define EPOCH_IDLE 		UINT64_MAX
+
+// epoch-based reclamation of DPU pages and rows
+// a thread announces the global epoch while it may hold pointers to cached pages or
+// buffered rows, an unlinked object is retired with the epoch it was unlinked in and
+// goes back to the arena once every active thread has announced a later epoch
+class reclaimer_t{
+    public:
+	reclaimer_t();
+
+	// a single store of the announced epoch, no read-modify-write
+	void enter(int tid){
+	    slots[slot(tid)].epoch.store(global_epoch.load(std::memory_order_acquire));
+	}
+
+	void exit(int tid){
+	    slots[slot(tid)].epoch.store(EPOCH_IDLE, std::memory_order_release);
+	}
+
+	// the object must already be unreachable for threads entering from now on
+	void retire(arena_class_t cls, void* obj, int tid);
+	// advance the global epoch if every active thread has caught up, then free what is safe
+	void reclaim(int tid);
+
+    private:
+	// a suspended coroutine keeps its pointers, so each coroutine announces on its own
+	int slot(int tid){
+	    #ifdef INTERLEAVE
+	    int id = coro_id();
+	    if(id != CORO_NONE)
+		return DEFAULT_INIT_THREADS + tid * CORO_NUM + id;
+	    #endif
+	    return tid;
+	}
+
+	struct retired_t{
+	    void* obj;
+	    arena_class_t cls;
+	    uint64_t epoch;
+	};
+
+	struct alignas(CACHELINE_SIZE) slot_t{
+	    std::atomic<uint64_t> epoch;
+	    std::deque<retired_t> limbo; // only touched by the owner thread
+	};
+
+	alignas(CACHELINE_SIZE) std::atomic<uint64_t> global_epoch;
+	slot_t slots[RECLAIM_THREAD_NUM];
+};
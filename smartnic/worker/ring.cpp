@@ -0,0 +1,100 @@
+#include "worker/ring.h"
+#include "worker/mr.h"
+#include "worker/transport.h"
+
+#ifdef RPC_RING
+
+rpc_ring_t::rpc_ring_t(worker_mr_t* mem, worker_transport_t* transport): mem(mem), transport(transport){
+    for(int i=0; i<CLIENT_THREAD_NUM; i++){
+	state[i].busy.store(false);
+	state[i].head = 0;
+	state[i].credited = 0;
+    }
+    // threads start their scans apart
+    for(int i=0; i<WORKER_THREAD_NUM; i++)
+	cursor[i] = CLIENT_THREAD_NUM / WORKER_THREAD_NUM * i;
+}
+
+ring_header_t* rpc_ring_t::head(int qp_id){
+    return (ring_header_t*)(mem->ring_pool(qp_id) + state[qp_id].head % RPC_RING_SIZE);
+}
+
+bool rpc_ring_t::complete(ring_header_t* header){
+    uint32_t len = ((volatile ring_header_t*)header)->len;
+    if(len == 0)
+	return false;
+    if(len == RING_WRAP)
+	return true;
+    uint32_t seq = ((volatile ring_header_t*)header)->seq;
+    auto footer = (volatile uint32_t*)((char*)header + ring_frame_size(len & ~RING_PULL) - sizeof(uint32_t));
+    if(*footer != seq)
+	return false;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return true;
+}
+
+bool rpc_ring_t::take(int qp_id){
+    auto header = head(qp_id);
+    if(!complete(header))
+	return false;
+    if(header->len != RING_WRAP)
+	return true;
+
+    // the client went on at the start of the ring
+    auto& ring = state[qp_id];
+    uint64_t skip = RPC_RING_SIZE - ring.head % RPC_RING_SIZE;
+    memset(header, 0, skip);
+    ring.head += skip;
+    return complete(head(qp_id));
+}
+
+// rings are scanned from where the last scan stopped, a ring claimed by another thread or
+// without a complete frame is passed over
+int rpc_ring_t::poll(int* qp_ids, int num, int tid){
+    int cnt = 0;
+    int start = cursor[tid];
+    for(int i=0; i<CLIENT_THREAD_NUM && cnt < num; i++){
+	int qp_id = (start + i) % CLIENT_THREAD_NUM;
+	auto& ring = state[qp_id];
+	if(ring.busy.load(std::memory_order_relaxed) || !complete(head(qp_id)))
+	    continue;
+	if(ring.busy.exchange(true, std::memory_order_acquire))
+	    continue;
+	if(!take(qp_id)){ // served by another thread meanwhile
+	    ring.busy.store(false, std::memory_order_release);
+	    continue;
+	}
+	qp_ids[cnt++] = qp_id;
+	cursor[tid] = qp_id + 1;
+    }
+    return cnt;
+}
+
+base_request_t* rpc_ring_t::request(int qp_id, int tid){
+    auto header = head(qp_id);
+    if(header->len & RING_PULL){
+	auto pull = (ring_pull_t*)(header + 1);
+	auto buf = mem->pull_buffer_pool(tid);
+	transport->read_client((uint64_t)buf, pull->addr, pull->size, qp_id);
+	return (base_request_t*)buf;
+    }
+    return (base_request_t*)(header + 1);
+}
+
+void rpc_ring_t::release(int qp_id){
+    auto& ring = state[qp_id];
+    auto header = head(qp_id);
+    if(header->len && header->len != RING_WRAP){
+	// zeroed so that a later frame never finds stale bytes at its header or footer
+	uint32_t size = ring_frame_size(header->len & ~RING_PULL);
+	memset(header, 0, size);
+	ring.head += size;
+	if(ring.head - ring.credited >= RPC_RING_CREDIT_BATCH){
+	    ring.credited = ring.head;
+	    transport->return_credit((uint64_t)&ring.credited, qp_id);
+	}
+    }
+    ring.busy.store(false, std::memory_order_release);
+}
+
+#endif // end of RPC_RING
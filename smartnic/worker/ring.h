@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include "common/global.h"
+#include "common/rpc.h"
+
+class worker_mr_t;
+class worker_transport_t;
+
+// consumer side of the request rings (RPC_RING)
+// a worker thread scans the ring heads for complete frames and claims a ring while it serves
+// its head frame, so each ring is consumed in order, the consumed bytes are zeroed and handed
+// back to the client as credits once a batch of them is free
+class rpc_ring_t{
+    public:
+	rpc_ring_t(worker_mr_t* mem, worker_transport_t* transport);
+
+	// claims up to num rings with a complete frame at their head, returns how many
+	int poll(int* qp_ids, int num, int tid);
+	// the request at the head of a claimed ring
+	base_request_t* request(int qp_id, int tid);
+	// consumes the head frame and gives up the ring
+	void release(int qp_id);
+
+    private:
+	ring_header_t* head(int qp_id);
+	bool complete(ring_header_t* header);
+	// skips a wrap marker, true if a complete frame is at the head
+	bool take(int qp_id);
+
+	struct alignas(CACHELINE_SIZE) state_t{
+	    std::atomic<bool> busy;
+	    uint64_t head; // bytes consumed
+	    uint64_t credited; // bytes returned to the client
+	};
+
+	worker_mr_t* mem;
+	worker_transport_t* transport;
+	state_t state[CLIENT_THREAD_NUM];
+	int cursor[WORKER_THREAD_NUM]; // where the thread's next scan starts
+};
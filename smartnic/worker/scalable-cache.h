@@ -62,6 +62,13 @@ struct ThreadSafeScalableCache {
    */
   bool find(ConstAccessor& ac, const TKey& key);
 
+  /**
+   * Find a value by key and copy it out, the element is not held after the
+   * call returns. The caller has to make sure the value stays valid on its
+   * own, e.g. by deferring the reclamation of evicted values.
+   */
+  bool find(const TKey& key, TValue& value);
+
   /**
    * Insert a value into the container. Both the key and value will be copied.
    * The new element will put into the eviction list as the most-recently
@@ -75,6 +82,12 @@ struct ThreadSafeScalableCache {
   bool insert_with_evict(const TKey& key, const TValue& value, bool& evicted, Accessor& evictAccessor); 
   bool insert_with_evict(const TKey& key, const TValue& value, bool& evicted, TKey& evict_key, TValue& evict_value);
 
+  /**
+   * Get the key an insert of the given key would evict from its shard.
+   * Returns false if the shard still has room.
+   */
+  bool victim(const TKey& key, TKey& victim_key);
+
   /**
    * Clear the container. NOT THREAD SAFE -- do not use while other threads
    * are accessing the container.
@@ -148,6 +161,12 @@ find(ConstAccessor& ac, const TKey& key) {
   return getShard(key).find(ac, key);
 }
 
+template <class TKey, class TValue, class THash>
+bool ThreadSafeScalableCache<TKey, TValue, THash>::
+find(const TKey& key, TValue& value) {
+  return getShard(key).find(key, value);
+}
+
 template <class TKey, class TValue, class THash>
 bool ThreadSafeScalableCache<TKey, TValue, THash>::
 insert(const TKey& key, const TValue& value) {
@@ -166,6 +185,12 @@ insert_with_evict(const TKey& key, const TValue& value, bool& evicted, TKey& evi
   return getShard(key).insert_with_evict(key, value, evicted, evict_key, evict_value);
 }
 
+template <class TKey, class TValue, class THash>
+bool ThreadSafeScalableCache<TKey, TValue, THash>::
+victim(const TKey& key, TKey& victim_key) {
+  return getShard(key).victim(victim_key);
+}
+
 template <class TKey, class TValue, class THash>
 void ThreadSafeScalableCache<TKey, TValue, THash>::
 remove(Accessor& ac) {
@@ -0,0 +1,74 @@
+#include "worker/sequencer.h"
+#include "worker/txn.h"
+#include "concurrency/lock_word.h"
+#include <algorithm>
+
+#ifdef DETERMINISTIC
+
+sequencer_t::sequencer_t(): latch(false), txn_cnt(0), opened(0), tab(nullptr){ }
+
+void sequencer_t::submit(txn_man_t* txn, page_table_t* _tab, int client_id, uint64_t timestamp, uint32_t* row_ids, access_t* types, int num, int tid){
+    assert(num <= MAX_ROW_PER_TXN);
+    lock();
+    tab = _tab;
+    int cnt = txn_cnt.load();
+    auto _txn = &txns[cnt];
+    _txn->client_id = client_id;
+    _txn->timestamp = timestamp;
+    _txn->num = num;
+    memcpy(_txn->row_ids, row_ids, sizeof(uint32_t) * num);
+    memcpy(_txn->types, types, sizeof(access_t) * num);
+    if(cnt == 0)
+	opened.store(asm_rdtsc());
+    txn_cnt.store(cnt + 1);
+
+    if(cnt + 1 == EPOCH_SIZE)
+	schedule(txn, tid);
+    unlock();
+}
+
+void sequencer_t::tick(txn_man_t* txn, int tid){
+    if(txn_cnt.load() == 0 || asm_rdtsc() - opened.load() < EPOCH_TIMEOUT)
+	return;
+    if(!try_lock()) // someone else is closing the epoch
+	return;
+    if(txn_cnt.load() && asm_rdtsc() - opened.load() >= EPOCH_TIMEOUT)
+	schedule(txn, tid);
+    unlock();
+}
+
+// txns of an epoch are ordered by timestamp, and all the locks of a txn are
+// requested before the next txn's, so every lock queue agrees on the order
+void sequencer_t::schedule(txn_man_t* txn, int tid){
+    int cnt = txn_cnt.load();
+    for(int i=0; i<cnt; i++)
+	order[i] = &txns[i];
+    std::sort(order, order + cnt, [](epoch_txn_t* a, epoch_txn_t* b){
+	if(a->timestamp != b->timestamp)
+	    return a->timestamp < b->timestamp;
+	return a->client_id < b->client_id;
+    });
+
+    for(int i=0; i<cnt; i++){
+	auto _txn = order[i];
+	txn->lock_set(_txn->client_id, _txn->timestamp, _txn->row_ids, _txn->types, _txn->num, tab, tid);
+    }
+    txn_cnt.store(0);
+}
+
+void sequencer_t::lock(){
+    while(!try_lock())
+	cpu_relax();
+}
+
+bool sequencer_t::try_lock(){
+    bool expected = false;
+    if(latch.load(std::memory_order_relaxed))
+	return false;
+    return latch.compare_exchange_strong(expected, true, std::memory_order_acquire);
+}
+
+void sequencer_t::unlock(){
+    latch.store(false, std::memory_order_release);
+}
+#endif
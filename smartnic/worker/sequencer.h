@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include "common/global.h"
+
+class txn_man_t;
+class page_table_t;
+
+// read/write set of a txn waiting in the open epoch
+struct epoch_txn_t{
+    int client_id;
+    uint64_t timestamp;
+    int num;
+    uint32_t row_ids[MAX_ROW_PER_TXN];
+    access_t types[MAX_ROW_PER_TXN];
+};
+
+// deterministic mode: collects the read/write sets of client txns into epochs and
+// requests their locks in a fixed order, one epoch after another
+// an epoch closes when it is full or when it has been open for EPOCH_TIMEOUT
+class sequencer_t{
+    public:
+	sequencer_t();
+	void submit(txn_man_t* txn, page_table_t* tab, int client_id, uint64_t timestamp, uint32_t* row_ids, access_t* types, int num, int tid);
+	// called by idle workers to close an epoch that timed out
+	void tick(txn_man_t* txn, int tid);
+
+    private:
+	void schedule(txn_man_t* txn, int tid);
+	void lock();
+	bool try_lock();
+	void unlock();
+
+	std::atomic<bool> latch;
+	std::atomic<int> txn_cnt;
+	std::atomic<uint64_t> opened; // arrival of the first txn of the open epoch
+	page_table_t* tab;
+
+	epoch_txn_t txns[EPOCH_SIZE];
+	epoch_txn_t* order[EPOCH_SIZE];
+};
@@ -3,7 +3,15 @@
 #include "worker/transport.h"
 #include "worker/txn.h"
 #include "worker/ycsb.h"
+#include "worker/page_table.h"
+#include "worker/reclaim.h"
+#ifdef RPC_RING
+#include "worker/ring.h"
+#endif
 #include "common/stat.h"
+#ifdef INTERLEAVE
+#include "worker/coroutine.h"
+#endif
 
 void thread_t::init(int tid, worker_t* worker){
     this->tid = tid;
@@ -15,6 +23,25 @@ int thread_t::get_tid(){
     return tid;
 }
 
+// serves the request that arrived on the client qp and reposts the receive buffer
+// (consumes the ring frame with RPC_RING)
+void thread_t::handle(txn_man_t* m_txn, int qp_id){
+    #if defined BATCH || defined BATCH2
+    auto request = worker->mem->rpc_request_pool(qp_id);
+    m_txn->run_request(request, tid);
+    memset(request, 0, sizeof(rpc_commit_t));
+    worker->transport->prepost_recv_client((uint64_t)request, sizeof(rpc_commit_t), qp_id);
+    #elif defined RPC_RING
+    auto request = worker->rings->request(qp_id, tid);
+    m_txn->run_request(request, tid);
+    worker->rings->release(qp_id); // the client may reuse the frame
+    #else
+    auto request = worker->mem->rpc_request_buffer_pool(qp_id);
+    m_txn->run_request((base_request_t*)request, tid);
+    worker->transport->prepost_recv_client((uint64_t)request, sizeof(rpc_request_t<Key>), qp_id);
+    #endif
+}
+
 void thread_t::run(){
     bind_core_worker(tid);
 
@@ -24,6 +51,19 @@ void thread_t::run(){
     rc = worker->get_txn_man(m_txn, this);
     assert(rc == RCOK);
 
+    #if defined LOCKTABLE && defined BUFFER
+    if(tid == EVICT_TID){ // dedicated to eviction, does not serve requests
+	while(true){
+	    if(!worker->tab->evict(m_txn, tid))
+		dpu_reclaimer->reclaim(tid); // free the frames of the last sweeps
+	}
+    }
+    #endif
+
+    #ifdef INTERLEAVE
+    run_interleaved(m_txn);
+    #endif
+
     //int batch_size = 32;
     #if defined BATCH || defined BATCH2
     //int batch_size = 4;
@@ -31,39 +71,100 @@ void thread_t::run(){
     #else
     int batch_size = 8;
     #endif
+    #ifdef RPC_RING
+    int qp_ids[batch_size];
+    #else
     struct ibv_wc wc[batch_size];
+    #endif
     #ifdef BREAKDOWN
     uint64_t _start = asm_rdtsc();
     uint64_t _end;
     #endif
     
     while(true){
+	#ifdef RPC_RING
+	int cnt = worker->rings->poll(qp_ids, batch_size, tid);
+	#else
 	int cnt = worker->transport->poll(wc, batch_size);
+	#endif
 
 	if(cnt > batch_size){
 	    debug::notify_error("recv size error");
 	    exit(0);
 	}
+
+	// pages and rows seen while serving the requests stay valid until exit
+	dpu_reclaimer->enter(tid);
 	for(int i=0; i<cnt; i++){
-	    #ifdef BATCH
-	    auto qp_id = wc[i].wr_id;
-	    auto request = worker->mem->rpc_request_pool(qp_id);
-	    m_txn->run_request(request, tid);
-	    memset(request, 0, sizeof(rpc_commit_t));
-	    worker->transport->prepost_recv_client((uint64_t)request, sizeof(rpc_commit_t), qp_id);
-	    #elif defined BATCH2
-	    auto qp_id = wc[i].wr_id;
-	    auto request = worker->mem->rpc_request_pool(qp_id);
-	    m_txn->run_request(request, tid);
-	    memset(request, 0, sizeof(rpc_commit_t));
-	    worker->transport->prepost_recv_client((uint64_t)request, sizeof(rpc_commit_t), qp_id);
+	    #ifdef RPC_RING
+	    handle(m_txn, qp_ids[i]);
+	    #else
+	    handle(m_txn, wc[i].wr_id);
+	    #endif
+	}
+	#ifdef DETERMINISTIC
+	m_txn->sequencer.tick(m_txn, tid); // close the open epoch if it timed out
+	#endif
+	dpu_reclaimer->exit(tid);
+
+	#ifdef BREAKDOWN
+	if(tid == 0){
+	    _end = asm_rdtsc();
+	    if((_end - _start) >= 10000000000){ // print every 10 sec
+		stat->summary();
+		stat->clear();
+		_start = _end;
+	    }
+	}
+	#endif
+    }
+}
+
+#ifdef INTERLEAVE
+// the thread polls for requests only while a coroutine is idle, a coroutine runs until it
+// waits on a host-memory verb and is resumed when the verb completes on the thread's CQ
+void thread_t::run_interleaved(txn_man_t* m_txn){
+    int inbox[CORO_NUM]; // client qp of the request handed to each coroutine
+    coro_sched_t sched([&](int id){
+	// pages and rows seen while serving the request stay valid until exit
+	dpu_reclaimer->enter(tid);
+	handle(m_txn, inbox[id]);
+	dpu_reclaimer->exit(tid);
+    });
+
+    struct ibv_wc wc[CORO_NUM];
+    #ifdef BREAKDOWN
+    uint64_t _start = asm_rdtsc();
+    uint64_t _end;
+    #endif
+
+    while(true){
+	int idle = sched.idle_num();
+	if(idle){
+	    #ifdef RPC_RING
+	    int qp_ids[CORO_NUM];
+	    int cnt = worker->rings->poll(qp_ids, idle, tid);
 	    #else
-	    auto qp_id = wc[i].wr_id;
-	    auto request = worker->mem->rpc_request_buffer_pool(qp_id);
-	    m_txn->run_request((base_request_t*)request, tid);
-	    worker->transport->prepost_recv_client((uint64_t)request, sizeof(rpc_request_t<Key>), qp_id);
+	    int cnt = worker->transport->poll(wc, idle);
 	    #endif
+	    for(int i=0; i<cnt; i++){
+		int id = sched.take_idle();
+		#ifdef RPC_RING
+		inbox[id] = qp_ids[i];
+		#else
+		inbox[id] = wc[i].wr_id;
+		#endif
+		sched.resume(id);
+	    }
+	}
+
+	int cnt = worker->transport->poll_server(wc, CORO_NUM, tid);
+	for(int i=0; i<cnt; i++){
+	    if(wc[i].status != IBV_WC_SUCCESS)
+		debug::notify_error("Failed to ibv_poll_cq ---- status %s (%d)", ibv_wc_status_str(wc[i].status), wc[i].status);
+	    sched.complete(wc[i].wr_id);
 	}
+	sched.run_ready(); // coroutines that gave way to a latch holder
 
 	#ifdef BREAKDOWN
 	if(tid == 0){
@@ -77,3 +178,4 @@ void thread_t::run(){
 	#endif
     }
 }
+#endif
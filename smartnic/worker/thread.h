@@ -3,6 +3,7 @@
 #include "common/global.h"
 
 class worker_t;
+class txn_man_t;
 
 class thread_t{
     public:
@@ -15,4 +16,8 @@ class thread_t{
 	void run();
 
     private:
+	void handle(txn_man_t* m_txn, int qp_id);
+	#ifdef INTERLEAVE
+	void run_interleaved(txn_man_t* m_txn);
+	#endif
 };
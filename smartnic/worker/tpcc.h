@@ -39,13 +39,6 @@ class tpcc_worker_t: public worker_t{
         tree_t<Key, Value>* i_orderline;        // key = (w_id, d_id, o_id)
         tree_t<Key, Value>* i_orderline_wd;     // key = (w_id, d_id)
 
-	#ifdef LOCKTABLE
-	page_table_t* tab;
-	#else
-	indirection_table_t* tab;
-	#endif
-	std::atomic<int64_t> free_pages;
-
         // XXX: HACK
         // only one txn can be delivering a warehouse at a time
         // *_delivering[w_id] --> the warehouse is delivering
@@ -54,6 +47,7 @@ class tpcc_worker_t: public worker_t{
         uint64_t rpc_alloc_row(int pid, int tid);
 
         int key_to_part(Key key);
+        void plan_placement();
 
     private:
         uint64_t num_wh;
@@ -75,8 +69,53 @@ class tpcc_txn_man_t: public txn_man_t{
     public:
         void init(worker_t* worker);
         RC run_request(base_request_t* reuqest, int tid);
+	#ifdef STORED_PROC
+	bool resume_proc(Access* access, int tid);
+	#endif
 
     private:
+        tree_t<Key, Value>* get_index(tpcc_request_type_t tpcc_type);
+	#ifdef PROJECTION
+	catalog_t* get_schema(tpcc_request_type_t tpcc_type);
+	#endif
+	#ifdef LOCKTABLE
+	row_t* load_row(table_entry_t* entry, row_t* row, int pid, uint64_t timestamp, int tid);
+	#endif
+
         tpcc_worker_t* worker;
+
+	#ifdef STORED_PROC
+	RC run_proc(rpc_request_t<Key>* request, int tid);
+	RC continue_proc(int client_id, int tid);
+	void run_step(int client_id, row_t* row);
+	void end_proc(RC rc, int client_id, int tid);
+
+	// one access of a procedure, listed in the order the client would send it
+	struct proc_access_t{
+	    tpcc_request_type_t tpcc_type;
+	    access_t type;
+	    Key key;
+	    int pid;
+	};
+
+	// the procedure of each client, it goes on on the thread that grants a lock it waits for
+	struct proc_t{
+	    bool active;
+	    rpc_proc_t args;
+	    uint64_t timestamp;
+	    proc_access_t set[3 + 2 * MAX_OL_PER_ORDER];
+	    int num;
+	    int next;
+	    char* writes; // new images of the written rows in access order, installed at commit
+	    int write_num;
+	    // carried between the accesses
+	    char w_name[11];
+	    char d_name[11];
+	    double w_tax;
+	    int64_t o_id;
+	    uint64_t c_discount;
+	};
+	proc_t procs[CLIENT_THREAD_NUM];
+	#endif
 };
 
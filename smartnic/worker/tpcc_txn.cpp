@@ -10,15 +10,146 @@
 #include "worker/transport.h"
 #include "worker/worker.h"
 #include "worker/page_table.h"
+#include "benchmark/tpcc_helper.h"
+#include "benchmark/tpcc_const.h"
 #include <unordered_map>
 
 void tpcc_txn_man_t::init(worker_t* worker){
     txn_man_t::init(worker);
     this->worker = (tpcc_worker_t*)worker;
+    #ifdef STORED_PROC
+    for(int i=0; i<CLIENT_THREAD_NUM; i++){
+	procs[i].active = false;
+	procs[i].writes = new char[sizeof(row_t) * (1 + MAX_OL_PER_ORDER)];
+    }
+    #endif
 }
 
 RC tpcc_txn_man_t::run_request(base_request_t* _request, int tid){
 #if defined BATCH || defined BATCH2
+    RC rc = RCOK;
+    int qp_id = _request->qp_id;
+
+    auto send_ptr = mem->rpc_response_pool(tid);
+    auto rpc_response = create_message<rpc_response_t>((void*)send_ptr, tid);
+
+    int base_size = sizeof(int) * 2;
+    int res_idx = 0;
+    if(_request->type == buffer_type_t::COMMIT_BUFFER){ // commits with the rows of their txns in access order
+	auto rpc_request = reinterpret_cast<rpc_commit_t*>(_request);
+	int num = rpc_request->num;
+	for(int i=0; i<num; i++){
+	    auto req = rpc_request->get_buffer(i);
+	    int client_id = req->tid;
+	    rc = finish_with_write(req->data, qp_id, client_id, tid);
+	    rpc_response->get_buffer(res_idx++)->update(client_id, rc);
+	}
+    }
+    else{
+	auto rpc_request = reinterpret_cast<rpc_request_t<Key>*>(_request);
+	int num = rpc_request->num;
+
+	// as in ycsb, lock decisions are made request by request and the remote rows granted
+	// in the batch are read afterwards with a single chain of RDMA READs
+	int pending = 0;
+	uint64_t local_addr[REQUEST_BATCH_SIZE];
+	uint64_t remote_addr[REQUEST_BATCH_SIZE];
+	int remote_pid[REQUEST_BATCH_SIZE];
+	rpc_response_buffer_t* pending_res[REQUEST_BATCH_SIZE];
+	int pending_client[REQUEST_BATCH_SIZE];
+	#if defined LOCKTABLE && defined BUFFER
+	table_entry_t* pending_entry[REQUEST_BATCH_SIZE];
+	uint64_t pending_timestamp[REQUEST_BATCH_SIZE];
+	#endif
+
+	for(int i=0; i<num; i++){
+	    auto req = rpc_request->get_buffer(i);
+	    rc = RCOK;
+	    int client_id = req->tid;
+	    access_t type = req->type;
+	    auto res = rpc_response->get_buffer(res_idx);
+
+	    if(type == COMMIT){ // read-only txns
+		rc = finish(rc, qp_id, client_id, tid);
+		res->update(client_id, rc);
+		res_idx++;
+		continue;
+	    }
+
+	    uint64_t timestamp = req->timestamp;
+	    int pid = req->pid;
+	    uint32_t row_id = 0;
+	    uint32_t page_id = 0;
+	    if(!get_index(req->tpcc_type)->search(req->key, row_id, page_id, tid)){ // key does not exist in the db
+		res->update(client_id, ERROR);
+		res_idx++;
+		debug::notify_info("qp %d --- ERROR (tid %d)", qp_id, tid);
+		continue;
+	    }
+
+	    #ifdef LOCKTABLE
+	    table_entry_t* entry = nullptr;
+	    row_t* row = get_row(rc, row_id, qp_id, client_id, tid, pid, type, worker->tab, entry, timestamp);
+	    #else
+	    uint64_t row_addr = worker->tab->get_addr(row_id);
+	    bool is_remote = is_masked_addr(row_addr);
+	    auto unmasked_addr = get_unmasked_addr(row_addr);
+	    row_t* row = get_row(rc, unmasked_addr, qp_id, client_id, tid, pid, type, is_remote);
+	    #endif
+
+	    if(row == nullptr){ // WAIT or ABORT, a waiting request is answered by notify
+		if(rc == ABORT){
+		    res->update(client_id, rc);
+		    res_idx++;
+		}
+		continue;
+	    }
+
+	    #ifdef LOCKTABLE
+	    bool is_remote = entry->is_remote();
+	    uint64_t unmasked_addr = entry->remote_addr;
+	    #endif
+	    if(is_remote){ // the response is completed once the read lands
+		local_addr[pending] = (uint64_t)mem->prefetch_buffer_pool(tid, pending);
+		remote_addr[pending] = unmasked_addr;
+		remote_pid[pending] = pid;
+		pending_res[pending] = res;
+		pending_client[pending] = client_id;
+		#if defined LOCKTABLE && defined BUFFER
+		pending_entry[pending] = entry;
+		pending_timestamp[pending] = timestamp;
+		#endif
+		pending++;
+		res_idx++;
+		continue;
+	    }
+
+	    res->update(client_id, rc);
+	    memcpy(res->data, row, sizeof(row_t));
+	    res_idx++;
+	}
+
+	if(pending){
+	    transport->read_async(local_addr, remote_addr, remote_pid, sizeof(row_t), pending, tid);
+	    transport->poll_async(tid);
+	}
+	for(int i=0; i<pending; i++){
+	    auto row = (row_t*)local_addr[i];
+	    #if defined LOCKTABLE && defined BUFFER
+	    auto entry = pending_entry[i];
+	    if(worker->tab->admit(entry, tid) && worker->tab->migrate(entry, row, pending_timestamp[i])) // migrate
+		row = (row_t*)entry->local_addr;
+	    #endif
+	    pending_res[i]->update(pending_client[i], RCOK);
+	    memcpy(pending_res[i]->data, row, sizeof(row_t));
+	}
+    }
+
+    rpc_response->num = res_idx;
+    if(res_idx){
+	size_t response_size = base_size + sizeof(rpc_response_buffer_t) * res_idx;
+	transport->send_client((uint64_t)rpc_response, response_size, qp_id);
+    }
     return RCOK;
 #else
     RC rc = RCOK;
@@ -42,8 +173,24 @@ RC tpcc_txn_man_t::run_request(base_request_t* _request, int tid){
     }
     #endif
 
+    #ifdef MULTI_DPU
+    if(type == PREPARE || type == ABORT_ALL){ // two-phase commit across DPUs
+	rc = type == PREPARE ? prepare(qp_id, tid) : rollback(qp_id, tid);
+	response->type = rc;
+	transport->send_client((uint64_t)response, response_size, qp_id);
+	return rc;
+    }
+    #endif
     if(type == COMMIT_DATA){
+	#ifdef COLUMN_COMMIT
+	rc = finish_with_write(request->data, request->num, qp_id, tid, true);
+	#else
 	rc = finish_with_write(request->data, request->num, qp_id, tid);
+	#endif
+	#ifdef EARLY_LOCK_RELEASE
+	if(rc == WAIT) // parked, answered by the last predecessor
+	    return rc;
+	#endif
 	response->type = rc;
 	transport->send_client((uint64_t)response, response_size, qp_id);
 	#ifdef BREAKDOWN
@@ -70,6 +217,10 @@ RC tpcc_txn_man_t::run_request(base_request_t* _request, int tid){
     }
     else if(type == COMMIT){
 	rc = finish(rc, qp_id, tid);
+	#ifdef EARLY_LOCK_RELEASE
+	if(rc == WAIT) // parked, answered by the last predecessor
+	    return rc;
+	#endif
 	response->type = rc;
 	transport->send_client((uint64_t)response, response_size, qp_id);
 	#ifdef BREAKDOWN
@@ -94,28 +245,52 @@ RC tpcc_txn_man_t::run_request(base_request_t* _request, int tid){
         #endif
 	return rc;
     }
+    #ifdef DETERMINISTIC
+    else if(type == SCHEDULE){ // read/write set of a new txn, answered once it is locked
+	int num = request->num;
+	auto set = (rpc_schedule_t<Key>*)request->data;
+	uint32_t row_ids[MAX_ROW_PER_TXN];
+	access_t types[MAX_ROW_PER_TXN];
+	for(int i=0; i<num; i++){
+	    uint32_t page_id = 0;
+	    if(!get_index(set[i].tpcc_type)->search(set[i].key, row_ids[i], page_id, tid)){
+		response->type = ERROR;
+		transport->send_client((uint64_t)response, response_size, qp_id);
+		debug::notify_info("qp %d --- ERROR (tid %d)", qp_id, tid);
+		return ERROR;
+	    }
+	    types[i] = set[i].type;
+	    for(int j=0; j<i; j++){ // a row queued twice would wait for itself
+		if(row_ids[j] == row_ids[i]){
+		    debug::notify_error("qp %d --- row %u appears twice in the read/write set", qp_id, row_ids[i]);
+		    exit(0);
+		}
+	    }
+	}
+	sequencer.submit(this, worker->tab, qp_id, timestamp, row_ids, types, num, tid);
+	return WAIT;
+    }
+    #endif
+    #ifdef STORED_PROC
+    else if(type == PROC){ // answered once the whole procedure is done
+	return run_proc(request, tid);
+    }
+    #endif
 
-    assert(type == READ || type == SCAN || type == WRITE);
+    assert(type == READ || type == SCAN || type == WRITE || type == DELTA);
 
-    tree_t<Key, Value>* idx = nullptr;
-    auto tpcc_type = request->tpcc_type;
-    if(tpcc_type == TPCC_WAREHOUSE)
-	idx = worker->i_warehouse;
-    else if(tpcc_type == TPCC_DISTRICT)
-	idx = worker->i_district;
-    else if(tpcc_type == TPCC_CUSTOMER_LASTNAME)
-	idx = worker->i_customer_last;
-    else if(tpcc_type == TPCC_CUSTOMER_ID)
-	idx = worker->i_customer_id;
-    else if(tpcc_type == TPCC_ITEM)
-	idx = worker->i_item;
-    else if(tpcc_type == TPCC_STOCK)
-	idx = worker->i_stock;
-    else{
-	debug::notify_error("Not supported tpcc txn type: %d ... Implement me!", tpcc_type);
-	exit(0);
+    #ifdef EARLY_LOCK_RELEASE
+    if(request->release_num){
+	rc = release_early(request->release_idx, request->data, request->release_num, qp_id, tid);
+	if(rc == ABORT){
+	    response->type = rc;
+	    transport->send_client((uint64_t)response, response_size, qp_id);
+	    return rc;
+	}
     }
+    #endif
 
+    auto idx = get_index(request->tpcc_type);
     uint32_t row_id = 0;
     uint32_t page_id = 0;
     Key key = request->key;
@@ -136,8 +311,14 @@ RC tpcc_txn_man_t::run_request(base_request_t* _request, int tid){
     t[qp_id].start = t[qp_id].end;
     #endif
 
+    #ifdef PROJECTION
+    projs[qp_id] = {get_schema(request->tpcc_type), type == READ ? request->cols : 0};
+    #endif
     #ifdef LOCKTABLE
     table_entry_t* entry = nullptr;
+    #ifdef COMMUTATIVE
+    delta_args[qp_id] = (rpc_delta_t*)request->data;
+    #endif
     auto row = get_row(rc, row_id, qp_id, tid, pid, type, worker->tab, entry, timestamp);
     #else
     uint64_t row_addr = worker->tab->get_addr(row_id);
@@ -170,33 +351,27 @@ RC tpcc_txn_man_t::run_request(base_request_t* _request, int tid){
 	return rc;
     }
 
+    #ifdef COMMUTATIVE
+    if(type == DELTA)
+	return apply_delta(accesses[qp_id][row_cnt[qp_id]-1], tid);
+    #endif
+
     #ifdef LOCKTABLE
-    if(entry->is_remote()){
-	transport->read((uint64_t)row, entry->remote_addr, sizeof(row_t), tid, pid);
-	#ifdef BUFFER
-	if(test_probability()){ // migrate
-	    auto new_row = (row_t*)malloc(sizeof(row_t));
-	    memcpy(new_row, row, sizeof(row_t));
-	    entry->update_timestamp(timestamp);
-	    entry->local_addr = (uint64_t)new_row;
-	    entry->set_local();
-	    row = new_row;
-
-	    worker->tab->replace(entry, this, tid);
-	}
-	#endif
-    }
+    row = load_row(entry, row, pid, timestamp, tid);
     #else
     if(is_remote){
 	transport->read((uint64_t)row, unmasked_addr, sizeof(row_t), tid, pid);
     }
     #endif
 
-    memcpy(response->data, row, sizeof(row_t));
-
     assert(rc == RCOK);
     response->type = RCOK;
+    #ifdef PROJECTION
+    response_size += pack_row(qp_id, row, response->data);
+    #else
+    memcpy(response->data, row, sizeof(row_t));
     response_size += sizeof(row_t);
+    #endif
     transport->send_client((uint64_t)response, response_size, qp_id);
     #ifdef BREAKDOWN
     t[qp_id].end = asm_rdtsc();
@@ -208,3 +383,266 @@ RC tpcc_txn_man_t::run_request(base_request_t* _request, int tid){
 #endif
 }
 
+#ifdef LOCKTABLE
+// the locked row, read from host memory when it is not in the DPU buffer
+row_t* tpcc_txn_man_t::load_row(table_entry_t* entry, row_t* row, int pid, uint64_t timestamp, int tid){
+    if(entry->is_remote()){
+	transport->read((uint64_t)row, entry->remote_addr, sizeof(row_t), tid, pid);
+	#ifdef BUFFER
+	if(worker->tab->admit(entry, tid) && worker->tab->migrate(entry, row, timestamp)) // migrate
+	    row = (row_t*)entry->local_addr;
+	#endif
+    }
+    return row;
+}
+#endif
+
+#ifdef STORED_PROC
+// the client sends the parameters of a whole txn, its accesses are known up front
+RC tpcc_txn_man_t::run_proc(rpc_request_t<Key>* request, int tid){
+    int client_id = request->qp_id;
+    auto& proc = procs[client_id];
+    auto& args = proc.args;
+    memcpy(&args, request->data, sizeof(rpc_proc_t));
+    proc.timestamp = request->timestamp;
+    proc.num = 0;
+    proc.next = 0;
+    proc.write_num = 0;
+    proc.o_id = 0;
+
+    auto set = proc.set;
+    int& num = proc.num;
+    Key key;
+    if(args.type == TPCC_PAYMENT){
+	set[num++] = {TPCC_WAREHOUSE, g_wh_update ? WRITE : READ, args.w_id, worker->key_to_part(args.w_id)};
+	key = distKey(args.d_id, args.d_w_id);
+	set[num++] = {TPCC_DISTRICT, WRITE, key, worker->key_to_part(key)};
+	int pid = worker->key_to_part(distKey(args.c_d_id, args.c_w_id));
+	if(args.by_last_name)
+	    set[num++] = {TPCC_CUSTOMER_LASTNAME, WRITE, custNPKey(args.c_last, args.c_d_id, args.c_w_id), pid};
+	else
+	    set[num++] = {TPCC_CUSTOMER_ID, WRITE, custKey(args.c_id, args.c_d_id, args.c_w_id), pid};
+    }
+    else if(args.type == TPCC_NEW_ORDER){
+	set[num++] = {TPCC_WAREHOUSE, READ, args.w_id, worker->key_to_part(args.w_id)};
+	key = distKey(args.d_id, args.w_id);
+	set[num++] = {TPCC_DISTRICT, WRITE, key, worker->key_to_part(key)};
+	set[num++] = {TPCC_CUSTOMER_ID, READ, custKey(args.c_id, args.d_id, args.w_id), worker->key_to_part(key)};
+	for(uint64_t i=0; i<args.ol_cnt; i++){
+	    auto& item = args.items[i];
+	    set[num++] = {TPCC_ITEM, READ, item.ol_i_id, worker->key_to_part(item.ol_i_id)};
+	    key = stockKey(item.ol_i_id, item.ol_supply_w_id);
+	    set[num++] = {TPCC_STOCK, WRITE, key, worker->key_to_part(key)};
+	}
+    }
+    else{
+	debug::notify_error("Not supported procedure type: %d ... Implement me!", args.type);
+	exit(0);
+    }
+
+    proc.active = true;
+    return continue_proc(client_id, tid);
+}
+
+RC tpcc_txn_man_t::continue_proc(int client_id, int tid){
+    RC rc = RCOK;
+    auto& proc = procs[client_id];
+    while(proc.next < proc.num){
+	auto& acc = proc.set[proc.next];
+	uint32_t row_id = 0;
+	uint32_t page_id = 0;
+	if(!get_index(acc.tpcc_type)->search(acc.key, row_id, page_id, tid)){ // key does not exist in the db
+	    if(row_cnt[client_id] > 0)
+		cleanup(ABORT, client_id, tid);
+	    debug::notify_info("qp %d --- ERROR (tid %d)", client_id, tid);
+	    end_proc(ERROR, client_id, tid);
+	    return ERROR;
+	}
+
+	table_entry_t* entry = nullptr;
+	auto row = get_row(rc, row_id, client_id, tid, acc.pid, acc.type, worker->tab, entry, proc.timestamp);
+	if(row == nullptr){
+	    if(rc == ABORT)
+		end_proc(rc, client_id, tid);
+	    return rc; // WAIT: resume_proc() picks it up once the lock is granted
+	}
+	run_step(client_id, load_row(entry, row, acc.pid, proc.timestamp, tid));
+    }
+
+    rc = finish_with_write(proc.writes, proc.write_num, client_id, tid);
+    end_proc(rc, client_id, tid);
+    return rc;
+}
+
+bool tpcc_txn_man_t::resume_proc(Access* access, int tid){
+    int client_id = access->client_id;
+    auto& proc = procs[client_id];
+    if(!proc.active)
+	return false;
+    auto entry = access->entry;
+    auto row = entry->is_remote() ? mem->row_buffer_pool(tid) : (row_t*)entry->local_addr;
+    run_step(client_id, load_row(entry, row, entry->pid, proc.timestamp, tid));
+    continue_proc(client_id, tid);
+    return true;
+}
+
+// what the client does with a row it got back, written rows are changed in a copy
+void tpcc_txn_man_t::run_step(int client_id, row_t* row){
+    auto& proc = procs[client_id];
+    auto& args = proc.args;
+    int idx = proc.next++;
+    auto& acc = proc.set[idx];
+    if(acc.type == WRITE){
+	auto copy = (row_t*)&proc.writes[sizeof(row_t) * proc.write_num++];
+	memcpy(copy, row, sizeof(row_t));
+	row = copy;
+    }
+
+    catalog_t* schema;
+    switch(acc.tpcc_type){
+	case TPCC_WAREHOUSE:{
+	    schema = worker->t_warehouse->get_schema();
+	    if(args.type == TPCC_NEW_ORDER){
+		row->get_value(schema, W_TAX, &proc.w_tax);
+		break;
+	    }
+	    memcpy(proc.w_name, row->get_value(schema, W_NAME), 10);
+	    proc.w_name[10] = '\0';
+	    if(acc.type == WRITE){
+		double w_ytd;
+		row->get_value(schema, W_YTD, &w_ytd);
+		w_ytd += args.h_amount;
+		row->set_value(schema, W_YTD, &w_ytd);
+	    }
+	    break;
+	}
+	case TPCC_DISTRICT:{
+	    schema = worker->t_district->get_schema();
+	    if(args.type == TPCC_NEW_ORDER){
+		row->get_value(schema, D_NEXT_O_ID, &proc.o_id);
+		proc.o_id++;
+		row->set_value(schema, D_NEXT_O_ID, &proc.o_id);
+		break;
+	    }
+	    memcpy(proc.d_name, row->get_value(schema, D_NAME), 10);
+	    proc.d_name[10] = '\0';
+	    double d_ytd;
+	    row->get_value(schema, D_YTD, &d_ytd);
+	    d_ytd += args.h_amount;
+	    row->set_value(schema, D_YTD, &d_ytd);
+	    break;
+	}
+	case TPCC_CUSTOMER_LASTNAME:
+	case TPCC_CUSTOMER_ID:{
+	    schema = worker->t_customer->get_schema();
+	    if(args.type == TPCC_NEW_ORDER){
+		row->get_value(schema, C_DISCOUNT, &proc.c_discount);
+		break;
+	    }
+	    double c_balance;
+	    double c_ytd_payment;
+	    uint64_t c_payment_cnt;
+	    row->get_value(schema, C_BALANCE, &c_balance);
+	    c_balance -= args.h_amount;
+	    row->set_value(schema, C_BALANCE, &c_balance);
+	    row->get_value(schema, C_YTD_PAYMENT, &c_ytd_payment);
+	    c_ytd_payment += args.h_amount;
+	    row->set_value(schema, C_YTD_PAYMENT, &c_ytd_payment);
+	    row->get_value(schema, C_PAYMENT_CNT, &c_payment_cnt);
+	    c_payment_cnt++;
+	    row->set_value(schema, C_PAYMENT_CNT, &c_payment_cnt);
+
+	    auto c_credit = row->get_value(schema, C_CREDIT);
+	    if(strstr(c_credit, "BC") && !TPCC_SMALL){
+		char c_new_data[501];
+		sprintf(c_new_data, "| %zu %zu %zu %zu %zu $%7.2f",
+			args.c_id, args.c_d_id, args.c_w_id, args.d_id, args.w_id, args.h_amount);
+		row->set_value(schema, "C_DATA", c_new_data);
+	    }
+	    break;
+	}
+	case TPCC_ITEM: // i_price only feeds the order lines, which are not inserted
+	    break;
+	case TPCC_STOCK:{
+	    schema = worker->t_stock->get_schema();
+	    auto& item = args.items[(idx - 4) / 2]; // after warehouse, district, customer and the item
+	    int64_t s_quantity;
+	    row->get_value(schema, S_QUANTITY, &s_quantity);
+#if !TPCC_SMALL
+	    int64_t s_ytd;
+	    int64_t s_order_cnt;
+	    row->get_value(schema, S_YTD, &s_ytd);
+	    s_ytd += item.ol_quantity;
+	    row->set_value(schema, S_YTD, &s_ytd);
+	    row->get_value(schema, S_ORDER_CNT, &s_order_cnt);
+	    s_order_cnt++;
+	    row->set_value(schema, S_ORDER_CNT, &s_order_cnt);
+#endif
+	    if(args.remote){
+		int64_t s_remote_cnt;
+		row->get_value(schema, S_REMOTE_CNT, &s_remote_cnt);
+		s_remote_cnt++;
+		row->set_value(schema, S_REMOTE_CNT, &s_remote_cnt);
+	    }
+	    int64_t quantity = (int64_t)item.ol_quantity;
+	    if(s_quantity > quantity + 10)
+		quantity = s_quantity - quantity;
+	    else
+		quantity = s_quantity - quantity + 91;
+	    row->set_value(schema, S_QUANTITY, &quantity);
+	    break;
+	}
+	default:
+	    debug::notify_error("Not supported tpcc txn type: %d ... Implement me!", acc.tpcc_type);
+	    exit(0);
+    }
+}
+
+// the only message of a procedure, the conflicting key is the client's retry hint
+void tpcc_txn_man_t::end_proc(RC rc, int client_id, int tid){
+    auto& proc = procs[client_id];
+    proc.active = false; // before the client can send its next request
+    auto response = create_message<rpc_response_t>(mem->rpc_response_buffer_pool(tid), tid, rc);
+    auto result = (rpc_proc_result_t*)response->data;
+    result->conflict_key = (rc == ABORT && proc.next < proc.num) ? proc.set[proc.next].key : 0;
+    result->o_id = proc.o_id;
+    transport->send_client((uint64_t)response, sizeof(base_response_t) + sizeof(rpc_proc_result_t), client_id);
+}
+#endif // end of STORED_PROC
+
+tree_t<Key, Value>* tpcc_txn_man_t::get_index(tpcc_request_type_t tpcc_type){
+    if(tpcc_type == TPCC_WAREHOUSE)
+	return worker->i_warehouse;
+    else if(tpcc_type == TPCC_DISTRICT)
+	return worker->i_district;
+    else if(tpcc_type == TPCC_CUSTOMER_LASTNAME)
+	return worker->i_customer_last;
+    else if(tpcc_type == TPCC_CUSTOMER_ID)
+	return worker->i_customer_id;
+    else if(tpcc_type == TPCC_ITEM)
+	return worker->i_item;
+    else if(tpcc_type == TPCC_STOCK)
+	return worker->i_stock;
+
+    debug::notify_error("Not supported tpcc txn type: %d ... Implement me!", tpcc_type);
+    exit(0);
+}
+
+#ifdef PROJECTION
+catalog_t* tpcc_txn_man_t::get_schema(tpcc_request_type_t tpcc_type){
+    if(tpcc_type == TPCC_WAREHOUSE)
+	return worker->t_warehouse->get_schema();
+    else if(tpcc_type == TPCC_DISTRICT)
+	return worker->t_district->get_schema();
+    else if(tpcc_type == TPCC_CUSTOMER_LASTNAME || tpcc_type == TPCC_CUSTOMER_ID)
+	return worker->t_customer->get_schema();
+    else if(tpcc_type == TPCC_ITEM)
+	return worker->t_item->get_schema();
+    else if(tpcc_type == TPCC_STOCK)
+	return worker->t_stock->get_schema();
+
+    debug::notify_error("Not supported tpcc txn type: %d ... Implement me!", tpcc_type);
+    exit(0);
+}
+#endif
+
@@ -14,6 +14,9 @@
 #include "benchmark/tpcc_const.h"
 #include "worker/transport.h"
 #include "worker/mr.h"
+#include "worker/arena.h"
+#include "worker/reclaim.h"
+#include "worker/placement.h"
 #include "index/indirection.h"
 #include "worker/page_table.h"
 
@@ -36,9 +39,10 @@ RC tpcc_worker_t::init(config_t* conf){
     #else
     tab = new indirection_table_t();
     #endif
-    free_pages.store(DEFAULT_BUFFER_SIZE);
 
+    plan_placement();
     init_table();
+    dpu_arena->print();
     return RCOK;
 }
 
@@ -104,6 +108,44 @@ RC tpcc_worker_t::init_table(){
     return RCOK;
 }
 
+// NURand with the run-time constant of the clients
+static uint64_t plan_nurand(uint64_t A, uint64_t x, uint64_t y, uint64_t C, drand48_data* buffer){
+    int64_t a = 0, b = 0;
+    lrand48_r(buffer, &a);
+    lrand48_r(buffer, &b);
+    uint64_t r = (a % (A + 1)) | (x + b % (y - x + 1));
+    return ((r + C) % (y - x + 1)) + x;
+}
+
+// warehouse, district and item rows are touched by almost every transaction,
+// stock and customer rows are ranked by a sample of the clients' NURand ids
+void tpcc_worker_t::plan_placement(){
+    uint64_t whs = node_wh_num(g_node_id); // the warehouses of this memory node
+    uint64_t dists = whs * DIST_PER_WARE;
+    uint64_t custs = dists * g_cust_per_dist;
+    uint64_t index_keys = g_max_items + whs + dists + whs * g_max_items + 2 * custs;
+    placement = new placement_t(index_keys);
+
+    placement->pin(t_warehouse, whs);
+    placement->pin(t_district, dists);
+    placement->pin(t_item, g_max_items);
+
+    drand48_data buffer;
+    srand48_r(PLACEMENT_SEED, &buffer);
+    std::vector<uint32_t> freq(g_max_items + 1, 0);
+    uint64_t C = NURand_C(8191);
+    for(uint64_t i=0; i<PLACEMENT_SAMPLES; i++)
+	freq[plan_nurand(8191, 1, g_max_items, C, &buffer)]++;
+    placement->rank(t_stock, freq, whs);
+
+    freq.assign(g_cust_per_dist + 1, 0);
+    C = NURand_C(1023);
+    for(uint64_t i=0; i<PLACEMENT_SAMPLES; i++)
+	freq[plan_nurand(1023, 1, g_cust_per_dist, C, &buffer)]++;
+    placement->rank(t_customer, freq, dists);
+    placement->print();
+}
+
 RC tpcc_worker_t::get_txn_man(txn_man_t*& txn_man, thread_t* thd){
     txn_man = global_tpcc_txn_man;
 
@@ -117,39 +159,51 @@ void* tpcc_worker_t::thread_init_warehouse(void* This, int tid){
     uint32_t wid = tid + 1;
     assert((uint64_t)tid < g_num_wh);
     srand48_r(wid, tpcc_buffer[tid]);
+    dpu_reclaimer->enter(tid); // cached index pages may be evicted by other loaders
 
     if (tid == 0)
         wl->init_tab_item(tid);
+    if (wh_to_node(wid) != g_node_id) { // held by another memory node
+        dpu_reclaimer->exit(tid);
+        return NULL;
+    }
     wl->init_tab_wh(wid, tid);
     wl->init_tab_dist(wid, tid);
     wl->init_tab_stock(wid, tid );
     for (uint64_t did = 1; did <= DIST_PER_WARE; did++) {
+        dpu_reclaimer->enter(tid); // move on to the current epoch between districts
         wl->init_tab_cust(did, wid, tid);
         wl->init_tab_order(did, wid, tid);
         for (uint64_t cid = 1; cid <= g_cust_per_dist; cid++)
             wl->init_tab_hist(cid, did, wid, tid);
     }
+    dpu_reclaimer->exit(tid);
     return NULL;
 }
 
 void* tpcc_worker_t::thread_init_warehouse_parallel(void* This, int tid, int wid_from, int wid_to){
     auto wl = (tpcc_worker_t*)This;
+    dpu_reclaimer->enter(tid); // cached index pages may be evicted by other loaders
     for(uint32_t wid=wid_from+1; wid<wid_to+1; wid++){
         assert((uint64_t)wid <= g_num_wh);
         srand48_r(wid, tpcc_buffer[tid]);
 
         if (tid == 0)
             wl->init_tab_item(tid);
+        if (wh_to_node(wid) != g_node_id)
+            continue;
         wl->init_tab_wh(wid, tid);
         wl->init_tab_dist(wid, tid);
         wl->init_tab_stock(wid, tid);
         for (uint64_t did = 1; did <= DIST_PER_WARE; did++) {
+            dpu_reclaimer->enter(tid);
             wl->init_tab_cust(did, wid, tid);
             wl->init_tab_order(did, wid, tid);
             for (uint64_t cid = 1; cid <= g_cust_per_dist; cid++)
                 wl->init_tab_hist(cid, did, wid, tid);
         }
     }
+    dpu_reclaimer->exit(tid);
     return NULL;
 }
 
@@ -174,12 +228,12 @@ void tpcc_worker_t::init_tab_item(int tid) {
         int pid = key_to_part(i);
 
 	row_t* new_row;
-	bool alloc_local = free_pages.load() > 0 ? true : false;
+	auto local_row = placement->alloc(t_item, i);
+	bool alloc_local = local_row != nullptr;
 	uint64_t local_addr = 0;
         uint64_t remote_addr = rpc_alloc(tid, pid);
 	if(alloc_local){ // local alloc
-	    free_pages.fetch_sub(1);
-	    new_row = (row_t*)malloc(ROW_SIZE);
+	    new_row = local_row;
 	    local_addr = (uint64_t)new_row;
 	}
 	else{ // remote alloc
@@ -230,12 +284,12 @@ void tpcc_worker_t::init_tab_wh(uint32_t wid, int tid) {
     uint32_t row_id = tab->get_next_id();
 
     row_t* row;
-    bool alloc_local = free_pages.load() > 0 ? true : false;
+    auto local_row = placement->alloc(t_warehouse, wid);
+    bool alloc_local = local_row != nullptr;
     uint64_t local_addr = 0;
     uint64_t remote_addr = rpc_alloc(tid, pid);
     if(alloc_local){ // local alloc
-	free_pages.fetch_sub(1);
-	row = (row_t*)malloc(ROW_SIZE);
+	row = local_row;
 	local_addr = (uint64_t)row;
     }
     else{ // remote alloc
@@ -299,12 +353,12 @@ void tpcc_worker_t::init_tab_dist(uint64_t wid, int tid) {
         //int pid = key_to_part(did);
 
 	row_t* row;
-	bool alloc_local = free_pages.load() > 0 ? true : false;
+	auto local_row = placement->alloc(t_district, did);
+	bool alloc_local = local_row != nullptr;
 	uint64_t local_addr = 0;
         uint64_t remote_addr = rpc_alloc(tid, pid);
 	if(alloc_local){ // local alloc
-	    free_pages.fetch_sub(1);
-	    row = (row_t*)malloc(ROW_SIZE);
+	    row = local_row;
 	    local_addr = (uint64_t)row;
 	}
 	else{ // remote alloc
@@ -367,12 +421,12 @@ void tpcc_worker_t::init_tab_stock(uint64_t wid, int tid) {
 
 	uint32_t row_id = tab->get_next_id();
 	row_t* row;
-	bool alloc_local = free_pages.load() > 0 ? true : false;
+	auto local_row = placement->alloc(t_stock, sid);
+	bool alloc_local = local_row != nullptr;
 	uint64_t local_addr = 0;
         uint64_t remote_addr = rpc_alloc(tid, pid);
 	if(alloc_local){ // local alloc
-	    free_pages.fetch_sub(1);
-	    row = (row_t*)malloc(ROW_SIZE);
+	    row = local_row;
 	    local_addr = (uint64_t)row;
 	}
 	else{
@@ -441,12 +495,12 @@ void tpcc_worker_t::init_tab_cust(uint64_t did, uint64_t wid, int tid) {
         //int pid = key_to_part(did);
 	uint32_t row_id = tab->get_next_id();
         row_t* row;
-        bool alloc_local = free_pages.load() > 0 ? true : false;
+        auto local_row = placement->alloc(t_customer, cid);
+        bool alloc_local = local_row != nullptr;
         uint64_t local_addr = 0;
         uint64_t remote_addr = rpc_alloc(tid, pid);
         if(alloc_local){ // local alloc
-            free_pages.fetch_sub(1);
-            row = (row_t*)malloc(ROW_SIZE);
+            row = local_row;
             local_addr = (uint64_t)row;
         }
         else{
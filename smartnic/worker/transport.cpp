@@ -1,6 +1,9 @@
 #include "worker/transport.h"
 #include "common/rpc.h"
 #include "common/debug.h"
+#ifdef INTERLEAVE
+#include "worker/coroutine.h"
+#endif
 
 worker_transport_t::worker_transport_t(config_t* conf, uint64_t server_mem_pool, uint64_t server_mem_size, uint64_t client_mem_pool, uint64_t client_mem_size): conf(conf){
     bool ret = init(server_mem_pool, server_mem_size, client_mem_pool, client_mem_size);
@@ -164,7 +167,7 @@ bool worker_transport_t::setup_connection_to_server(){
     for(int i=0; i<WORKER_THREAD_NUM; i++)
         local.qpn[i] = server_qp[i]->qp_num;
 
-    worker_connect(conf->get_ip(0).c_str(), &local, &server_meta);
+    worker_connect(conf->get_ip(g_node_id).c_str(), &local, &server_meta); // the memory server of this node
     for(int i=0; i<WORKER_THREAD_NUM; i++){
         if(!modify_qp_state_to_rtr(server_qp[i], server_meta.gid, server_meta.gid_idx, server_meta.lid, server_meta.qpn[i]))
             return false;
@@ -194,6 +197,11 @@ bool worker_transport_t::setup_connection_to_client(){
         local.qpn[i] = client_qp[i]->qp_num;
     #endif
 
+    #ifdef RPC_RING
+    local.ring_addr = (uint64_t)client_mr->addr; // the rings lead the client memory region
+    local.ring_rkey = client_mr->rkey;
+    #endif
+
     worker_listen(&local, &client_meta);
 
     #ifdef BATCH
@@ -232,26 +240,96 @@ void worker_transport_t::prepost_recv(uint64_t ptr, int size, int qp_id){
 
 void worker_transport_t::recv(uint64_t ptr, int size, int qp_id){
 //    debug::notify_info("REMOTE RECV");
+    #ifdef INTERLEAVE
+    if(coro_id() != CORO_NONE){
+	post_recv(server_qp[qp_id], ptr, size, server_mr->lkey, coro_wr_id());
+	coro_wait();
+	return;
+    }
+    #endif
     rdma_recv(server_qp[qp_id], server_cq[qp_id], ptr, size, server_mr->lkey);
 }
 
 void worker_transport_t::send(uint64_t ptr, int size, int qp_id){
 //    debug::notify_info("REMOTE SEND");
+    #ifdef INTERLEAVE
+    if(coro_id() != CORO_NONE){
+	post_send(server_qp[qp_id], ptr, size, server_mr->lkey, coro_wr_id());
+	coro_wait();
+	return;
+    }
+    #endif
     rdma_send(server_qp[qp_id], server_cq[qp_id], ptr, size, server_mr->lkey);
 }
 
 void worker_transport_t::write(uint64_t src, uint64_t dest, int size, int qp_id, int pid){
 //    debug::notify_info("REMOTE WRITE");
+    #ifdef INTERLEAVE
+    if(coro_id() != CORO_NONE){ // the coroutine yields until the write lands
+	uint32_t rkey = server_meta.rkey[pid];
+	post_write(server_qp[qp_id], &src, &dest, size, server_mr->lkey, &rkey, 1, coro_wr_id());
+	coro_wait();
+	return;
+    }
+    #endif
     rdma_write(server_qp[qp_id], server_cq[qp_id], src, dest, size, server_mr->lkey, server_meta.rkey[pid]);
 }
 
 void worker_transport_t::read(uint64_t src, uint64_t dest, int size, int qp_id, int pid){
 //    debug::notify_info("REMOTE READ");
+    #ifdef INTERLEAVE
+    if(coro_id() != CORO_NONE){ // the coroutine yields until the read lands
+	uint32_t rkey = server_meta.rkey[pid];
+	post_read(server_qp[qp_id], &src, &dest, size, server_mr->lkey, &rkey, 1, coro_wr_id());
+	coro_wait();
+	return;
+    }
+    #endif
     rdma_read(server_qp[qp_id], server_cq[qp_id], src, dest, size, server_mr->lkey, server_meta.rkey[pid]);
 }
 
+void worker_transport_t::read_async(uint64_t* src, uint64_t* dest, int* pid, int size, int num, int qp_id){
+    uint32_t rkey[num];
+    for(int i=0; i<num; i++)
+	rkey[i] = server_meta.rkey[pid[i]];
+    uint64_t wr_id = 0;
+    #ifdef INTERLEAVE
+    wr_id = coro_wr_id();
+    #endif
+    post_read(server_qp[qp_id], src, dest, size, server_mr->lkey, rkey, num, wr_id);
+}
+
+void worker_transport_t::write_async(uint64_t* src, uint64_t* dest, int* pid, int size, int num, int qp_id){
+    uint32_t rkey[num];
+    for(int i=0; i<num; i++)
+	rkey[i] = server_meta.rkey[pid[i]];
+    uint64_t wr_id = 0;
+    #ifdef INTERLEAVE
+    wr_id = coro_wr_id();
+    #endif
+    post_write(server_qp[qp_id], src, dest, size, server_mr->lkey, rkey, num, wr_id);
+}
+
+void worker_transport_t::poll_async(int qp_id){
+    #ifdef INTERLEAVE
+    if(coro_id() != CORO_NONE){
+	coro_wait();
+	return;
+    }
+    #endif
+    struct ibv_wc wc;
+    poll_cq(server_cq[qp_id], 1, &wc);
+}
+
 bool worker_transport_t::cas(uint64_t src, uint64_t dest, uint64_t cmp, uint64_t swap, int size, int qp_id, int pid){
 //    debug::notify_info("REMOTE CAS");
+    #ifdef INTERLEAVE
+    if(coro_id() != CORO_NONE){
+	post_cas(server_qp[qp_id], src, dest, cmp, swap, size, server_mr->lkey, server_meta.rkey[pid], coro_wr_id());
+	coro_wait();
+	return cmp == *(uint64_t*)src;
+    }
+    #endif
     return rdma_cas(server_qp[qp_id], server_cq[qp_id], src, dest, cmp, swap, size, server_mr->lkey, server_meta.rkey[pid]);
 }
 
@@ -281,6 +359,23 @@ int worker_transport_t::poll_client(int qp_id, int num){
     return poll_cq_once(client_send_cq[qp_id], num, wc);
 }
 
+#ifdef RPC_RING
+void worker_transport_t::read_client(uint64_t src, uint64_t dest, int size, int qp_id){
+    rdma_read(client_qp[qp_id], client_send_cq[qp_id], src, dest, size, client_mr->lkey, client_meta.rkey[qp_id]);
+}
+
+void worker_transport_t::return_credit(uint64_t src, int qp_id){
+    post_write_inline(client_qp[qp_id], src, client_meta.credit_addr[qp_id], sizeof(uint64_t), client_meta.rkey[qp_id]);
+}
+#endif
+
+#ifdef INTERLEAVE
+// completions of the host-memory verbs posted by the coroutines of a worker thread
+int worker_transport_t::poll_server(struct ibv_wc* wc, int num, int qp_id){
+    return poll_cq_once(server_cq[qp_id], num, wc);
+}
+#endif
+
 int worker_transport_t::poll(struct ibv_wc* wc, int num){
     return poll_cq_once(client_recv_cq, num, wc);
     //return poll_cq_(client_recv_cq, num, wc);
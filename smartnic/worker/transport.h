@@ -17,6 +17,14 @@ class worker_transport_t{
 	void read(uint64_t src, uint64_t dest, int size, int qp_id, int pid);
 	void write(uint64_t src, uint64_t dest, int size, int qp_id, int pid);
 	bool cas(uint64_t src, uint64_t dest, uint64_t cmp, uint64_t swap, int size, int qp_id, int pid);
+	// batched reads and writes of scattered rows, completed later by poll_async
+	void read_async(uint64_t* src, uint64_t* dest, int* pid, int size, int num, int qp_id);
+	void write_async(uint64_t* src, uint64_t* dest, int* pid, int size, int num, int qp_id);
+	void poll_async(int qp_id);
+	#ifdef INTERLEAVE
+	// completions of the coroutines of a worker thread, routed by wr_id
+	int poll_server(struct ibv_wc* wc, int num, int qp_id);
+	#endif
 
 	// RDMA wrappers for client communication
         void prepost_recv_client(uint64_t ptr, int size, int qp_id);
@@ -25,6 +33,12 @@ class worker_transport_t{
         void send_client_async(uint64_t ptr, int size, int qp_id);
 	int poll_client(int qp_id, int num);
 	int poll(struct ibv_wc* wc, int num);
+	#ifdef RPC_RING
+	// a request too large for its ring frame, read from the client's request buffer
+	void read_client(uint64_t src, uint64_t dest, int size, int qp_id);
+	// consumed bytes of the client's ring, src is copied when posted
+	void return_credit(uint64_t src, int qp_id);
+	#endif
 
     private:
         struct rdma_ctx context;
@@ -16,12 +16,24 @@ breakdown_t t[CLIENT_THREAD_NUM];
 void txn_man_t::init(worker_t* worker){
     this->worker = worker;
     for(int i=0; i<CLIENT_THREAD_NUM; i++){
-	accesses[i] = new Access*[MAX_ROW_PER_TXN];
-	memset(accesses[i], 0, sizeof(Access*)*MAX_ROW_PER_TXN);
+	accesses[i] = new Access*[MAX_ACCESS_PER_TXN];
+	memset(accesses[i], 0, sizeof(Access*)*MAX_ACCESS_PER_TXN);
 	row_cnt[i] = 0;
 	#ifdef BREAKDOWN
 	memset(&t[i], 0, sizeof(breakdown_t));
 	#endif
+	#ifdef EARLY_LOCK_RELEASE
+	deps[i].cnt = 0;
+	deps[i].parked = false;
+	deps[i].num = 0;
+	deps[i].data = new char[sizeof(row_t) * MAX_ROW_PER_TXN];
+	#endif
+	#ifdef DETERMINISTIC
+	pending[i] = 0;
+	#endif
+	#ifdef PROJECTION
+	projs[i].cols = 0;
+	#endif
     }
 
     this->mem = worker->mem;
@@ -36,6 +48,18 @@ int txn_man_t::get_row_cnt(int client_id){
     return row_cnt[client_id];
 }
 
+#ifdef PROJECTION
+// the whole row image, or only the projected columns back to back
+size_t txn_man_t::pack_row(int client_id, row_t* row, char* dst){
+    auto& proj = projs[client_id];
+    if(proj.cols == 0){
+	memcpy(dst, row, sizeof(row_t));
+	return sizeof(row_t);
+    }
+    return row->pack(proj.schema, proj.cols, dst);
+}
+#endif
+
 #if defined BATCH || defined BATCH2
 RC txn_man_t::finish(RC rc, int qp_id, int client_id, int tid){
     return cleanup(rc, qp_id, client_id, tid);
@@ -117,6 +141,9 @@ RC txn_man_t::finish_with_write(char* _new_row, int qp_id, int client_id, int ti
 		else{
 		    row = (row_t*)entry->local_addr;
 		    row->copy(new_row);
+		    #ifdef BUFFER
+		    entry->set_dirty(); // written back when evicted
+		    #endif
 		}
 	    }
 	}
@@ -351,6 +378,10 @@ void txn_man_t::notify(Access* access, int tid){
 
 #else // ifn defined BATCH || defined BATCH2ING
 RC txn_man_t::finish(RC rc, int client_id, int tid){
+    #ifdef EARLY_LOCK_RELEASE
+    if(rc == RCOK && park_commit(nullptr, 0, client_id))
+	return WAIT;
+    #endif
     return cleanup(rc, client_id, tid);
 }
 
@@ -380,6 +411,10 @@ RC txn_man_t::cleanup(RC rc, int client_id, int tid){
 		continue;
 	    }
 	}
+	#ifdef COMMUTATIVE
+	else if(type == DELTA)
+	    commit_delta(access[rid], tid);
+	#endif
 	entry->release(type, this, client_id, tid, access[rid]->timestamp);
 	//debug::notify_info("tid %d --- %d unlocked \t(client_id %d, rid %d)", tid, access[rid]->rid, client_id, rid);
 	#else
@@ -406,9 +441,18 @@ RC txn_man_t::cleanup(RC rc, int client_id, int tid){
     return _rc;
 }
 
-RC txn_man_t::finish_with_write(char* _new_row, int num, int client_id, int tid){
+RC txn_man_t::finish_with_write(char* _new_row, int num, int client_id, int tid, bool by_cols){
+    #ifdef EARLY_LOCK_RELEASE
+    if(park_commit(_new_row, num, client_id))
+	return WAIT;
+    #endif
     auto access = accesses[client_id];
     int idx = num-1;
+    #ifdef COLUMN_COMMIT
+    char* cols[MAX_ROW_PER_TXN + 1];
+    if(by_cols)
+	split_cols(_new_row, num, cols);
+    #endif
     #ifdef LOCKTABLE
     RC rc = prepare_commit(access[0]);
     #else
@@ -431,7 +475,15 @@ RC txn_man_t::finish_with_write(char* _new_row, int num, int client_id, int tid)
 	else{
 	    if(type == WRITE){ // commit writes
 		auto new_row = (row_t*)&_new_row[sizeof(row_t) * idx];
-		if(entry->is_remote()){
+		if(_access->lock_status == lock_status_t::LOCK_RELEASED){
+		    // installed when its lock was released early
+		}
+		#ifdef COLUMN_COMMIT
+		else if(by_cols){
+		    install_cols(cols[idx], cols[idx + 1], entry, tid);
+		}
+		#endif
+		else if(entry->is_remote()){
 		    row = mem->row_buffer_pool(tid);
 		    memcpy(row, new_row, sizeof(row_t));
 		    transport->write((uint64_t)row, entry->remote_addr, sizeof(row_t), tid, entry->pid);
@@ -439,9 +491,16 @@ RC txn_man_t::finish_with_write(char* _new_row, int num, int client_id, int tid)
 		else{
 		    row = (row_t*)entry->local_addr;
 		    row->copy(new_row);
+		    #ifdef BUFFER
+		    entry->set_dirty(); // written back when evicted
+		    #endif
 		}
 		idx--;
 	    }
+	    #ifdef COMMUTATIVE
+	    else if(type == DELTA)
+		commit_delta(_access, tid);
+	    #endif
 	    // else commit reads
 	}
 
@@ -478,6 +537,41 @@ RC txn_man_t::finish_with_write(char* _new_row, int num, int client_id, int tid)
     return rc;
 }
 
+#ifdef COLUMN_COMMIT
+// runs are ordered by row, cols[i] is the first run of written row i and cols[num] the end
+void txn_man_t::split_cols(char* data, int num, char** cols){
+    int col_num = *(int*)data;
+    auto ptr = data + sizeof(int);
+    int row = 0;
+    for(int i=0; i<col_num; i++){
+	auto col = (commit_col_t*)ptr;
+	while(row <= col->row)
+	    cols[row++] = ptr;
+	ptr += commit_col_size(col->size);
+    }
+    while(row <= num)
+	cols[row++] = ptr;
+}
+
+// in place in DPU memory, or one small write per run since the rest of the host copy is current
+void txn_man_t::install_cols(char* cols, char* end, table_entry_t* entry, int tid){
+    bool is_remote = entry->is_remote();
+    auto row = is_remote ? mem->row_buffer_pool(tid) : (row_t*)entry->local_addr;
+    while(cols < end){
+	auto col = (commit_col_t*)cols;
+	auto dst = &row->data[col->offset];
+	memcpy(dst, col + 1, col->size);
+	if(is_remote)
+	    transport->write((uint64_t)dst, entry->remote_addr + (dst - (char*)row), col->size, tid, entry->pid);
+	cols += commit_col_size(col->size);
+    }
+    #ifdef BUFFER
+    if(!is_remote)
+	entry->set_dirty(); // written back when evicted
+    #endif
+}
+#endif
+
 void txn_man_t::inc_row_cnt(Access* access){
     row_cnt[access->client_id]++;
 }
@@ -487,6 +581,12 @@ void txn_man_t::prepare_abort(Access* access){
     auto txn_status_value = txn_status->load();
     if(txn_status_value == txn_status_t::ABORTING)
 	return;
+    #ifdef MULTI_DPU
+    if(txn_status_value == txn_status_t::COMMITTING){ // prepared, another DPU voted ABORT
+	txn_status->store(txn_status_t::ABORTING);
+	return;
+    }
+    #endif
     assert(txn_status_value == txn_status_t::RUNNING);
     if(!txn_status->compare_exchange_strong(txn_status_value, txn_status_t::ABORTING)){
 	assert(txn_status->load() == txn_status_t::ABORTING);
@@ -499,6 +599,10 @@ RC txn_man_t::prepare_commit(Access* access){
     if(txn_status_value == txn_status_t::ABORTING){ // this txn has been wounded
 	return ABORT;
     }
+    #ifdef MULTI_DPU
+    if(txn_status_value == txn_status_t::COMMITTING) // prepared, cannot be wounded anymore
+	return RCOK;
+    #endif
     assert(txn_status_value == txn_status_t::RUNNING);
     if(!txn_status->compare_exchange_strong(txn_status_value, txn_status_t::COMMITTING)){ // this txn has been wounded
 	return ABORT;
@@ -506,11 +610,36 @@ RC txn_man_t::prepare_commit(Access* access){
     return RCOK;
 }
 
+#ifdef MULTI_DPU
+// a txn that votes RCOK stays COMMITTING until the coordinator decides, a wounded one is
+// rolled back right away and votes ABORT
+RC txn_man_t::prepare(int client_id, int tid){
+    if(row_cnt[client_id] == 0)
+	return RCOK;
+    RC rc = prepare_commit(accesses[client_id][0]);
+    if(rc == ABORT)
+	cleanup(rc, client_id, tid);
+    return rc;
+}
+
+RC txn_man_t::rollback(int client_id, int tid){
+    if(row_cnt[client_id] == 0) // already rolled back on this DPU
+	return ABORT;
+    return cleanup(ABORT, client_id, tid);
+}
+#endif
+
 void txn_man_t::flush(Access* access){
     auto txn_status = access->txn_status;
     auto txn_status_value = txn_status->load();
     //assert(txn_status_value == txn_status_t::COMMITTING);
     txn_status->store(txn_status_t::RUNNING);
+    #ifdef EARLY_LOCK_RELEASE
+    // all locks are gone, no predecessor can reach this client anymore
+    auto& dep = deps[access->client_id];
+    dep.cnt.store(0);
+    dep.parked.store(false);
+    #endif
 }
 
 bool txn_man_t::wound(Access* access){
@@ -540,6 +669,22 @@ void txn_man_t::notify(Access* access, int tid){
     int client_id = access->client_id;
     //int rid = row_cnt[client_id];
     row_cnt[client_id]++;
+    #ifdef STORED_PROC
+    if(resume_proc(access, tid)) // answered once the whole procedure is done
+	return;
+    #endif
+    #ifdef NEAR_DATA
+    if(access->type == SCAN){ // answered once the whole scan is done
+	resume_scan(access, tid);
+	return;
+    }
+    #endif
+    #ifdef COMMUTATIVE
+    if(access->type == DELTA){ // answered with the fetched values
+	apply_delta(access, tid);
+	return;
+    }
+    #endif
     auto entry = access->entry;
     //auto entry = accesses[client_id][rid]->entry;
     row_t* row;
@@ -550,7 +695,11 @@ void txn_man_t::notify(Access* access, int tid){
     else{
 	row = (row_t*)entry->local_addr;
     }
+    #ifdef PROJECTION
+    response_size = sizeof(base_response_t) + pack_row(client_id, row, response->data);
+    #else
     memcpy(response->data, row, ROW_SIZE);
+    #endif
     transport->send_client((uint64_t)response, response_size, client_id);
     #ifdef BREAKDOWN
     t[client_id].end = asm_rdtsc();
@@ -560,12 +709,217 @@ void txn_man_t::notify(Access* access, int tid){
     //debug::notify_info("tid %d --- %d lock resume \t(client_id %d, rid %d)", tid, access->rid, client_id, row_cnt[client_id]-1);
 }
 
+#ifdef EARLY_LOCK_RELEASE
+// early lock release: the client ships the final images of writes it will not touch
+// again, they are installed right away and their locks are handed to the next txn
+RC txn_man_t::release_early(int* idx, char* _new_row, int num, int client_id, int tid){
+    auto access = accesses[client_id];
+    for(int i=0; i<num; i++){
+	assert(idx[i] < row_cnt[client_id]);
+	auto _access = access[idx[i]];
+	assert(_access->type == WRITE);
+	if(_access->lock_status == lock_status_t::LOCK_RELEASED)
+	    continue;
+
+	auto entry = _access->entry;
+	if(entry->is_remote()) // written back at commit with the lock held
+	    continue;
+
+	if(!_access->undo)
+	    _access->undo = (row_t*)malloc(sizeof(row_t));
+	auto new_row = (row_t*)&_new_row[sizeof(row_t) * i];
+	if(entry->release_early(this, _access, new_row, tid) == ABORT){ // wounded
+	    cleanup(ABORT, client_id, tid);
+	    return ABORT;
+	}
+    }
+    return RCOK;
+}
+
+void txn_man_t::add_dependency(Access* access, int cnt){
+    deps[access->client_id].cnt.fetch_add(cnt);
+}
+
+// a predecessor finished, returns true if the caller has to run the parked commit
+bool txn_man_t::resolve_dependency(Access* access, bool abort){
+    auto& dep = deps[access->client_id];
+    if(abort){ // the dependent has seen an undone write
+	auto status = txn_status_t::RUNNING;
+	access->txn_status->compare_exchange_strong(status, txn_status_t::ABORTING);
+    }
+    if(dep.cnt.fetch_sub(1) != 1 && !abort)
+	return false;
+
+    bool parked = true;
+    return dep.parked.compare_exchange_strong(parked, false);
+}
+
+// a txn that read early released writes commits only after its predecessors did,
+// the commit is parked and finished by the last predecessor
+bool txn_man_t::park_commit(char* new_row, int num, int client_id){
+    auto& dep = deps[client_id];
+    if(dep.cnt.load() == 0)
+	return false;
+
+    if(new_row != dep.data)
+	memcpy(dep.data, new_row, sizeof(row_t) * num);
+    dep.num = num;
+    dep.parked.store(true);
+    if(dep.cnt.load() > 0 && accesses[client_id][0]->txn_status->load() == txn_status_t::RUNNING)
+	return true;
+
+    // the last predecessor finished meanwhile or this txn has to abort anyway
+    bool parked = true;
+    return !dep.parked.compare_exchange_strong(parked, false);
+}
+
+void txn_man_t::commit_parked(Access* access, int tid){
+    int client_id = access->client_id;
+    auto& dep = deps[client_id];
+    RC rc = finish_with_write(dep.data, dep.num, client_id, tid);
+    if(rc == WAIT) // claimed by another predecessor
+	return;
+
+    auto send_ptr = mem->rpc_response_buffer_pool(tid);
+    auto response = create_message<rpc_response_t>(send_ptr, tid, rc);
+    transport->send_client((uint64_t)response, sizeof(base_response_t), client_id);
+}
+#endif
+
+#ifdef COMMUTATIVE
+// a delta is applied in DPU memory, the shared lock keeps the row from being evicted until
+// the txn finishes, a row that cannot be brought in for lack of frames aborts the txn
+RC txn_man_t::apply_delta(Access* access, int tid){
+    int client_id = access->client_id;
+    auto entry = access->entry;
+    auto send_ptr = mem->rpc_response_buffer_pool(tid);
+    auto response = create_message<rpc_response_t>(send_ptr, tid, RCOK);
+    size_t response_size = sizeof(base_response_t);
+
+    if(entry->is_remote()){
+	auto row = mem->row_buffer_pool(tid);
+	transport->read((uint64_t)row, entry->remote_addr, sizeof(row_t), tid, entry->pid);
+	if(!worker->tab->migrate(entry, row, access->timestamp)){
+	    while(entry->flags.load() & ENTRY_MIGRATING) // moved by another holder
+		asm("nop");
+	    if(entry->is_remote()){ // no free frame
+		cleanup(ABORT, client_id, tid);
+		response->type = ABORT;
+		transport->send_client((uint64_t)response, response_size, client_id);
+		return ABORT;
+	    }
+	}
+    }
+
+    // fetch deltas hand out values right away, so they cannot wait for the commit
+    auto& delta = access->delta;
+    delta_t fetch[MAX_DELTA_PER_REQUEST];
+    int num = 0;
+    for(int i=0; i<delta.num; i++){
+	if(delta.ops[i].fetch)
+	    fetch[num++] = delta.ops[i];
+    }
+    auto row = (row_t*)entry->local_addr;
+    if(num){
+	combiner.apply(entry->id, row, fetch, num, tid);
+	entry->set_dirty();
+    }
+
+    // later deltas may already be in the image, the fetched fields carry this txn's values
+    memcpy(response->data, row, sizeof(row_t));
+    auto data = ((row_t*)response->data)->get_data();
+    for(int i=0; i<num; i++)
+	memcpy(&data[fetch[i].offset], &fetch[i].i, sizeof(int64_t));
+    response_size += sizeof(row_t);
+    transport->send_client((uint64_t)response, response_size, client_id);
+    return RCOK;
+}
+
+// the adds of a committing txn, its lock is still held so the row is resident
+void txn_man_t::commit_delta(Access* access, int tid){
+    auto& delta = access->delta;
+    delta_t ops[MAX_DELTA_PER_REQUEST];
+    int num = 0;
+    for(int i=0; i<delta.num; i++){
+	if(!delta.ops[i].fetch)
+	    ops[num++] = delta.ops[i];
+    }
+    if(!num)
+	return;
+
+    auto entry = access->entry;
+    combiner.apply(entry->id, (row_t*)entry->local_addr, ops, num, tid);
+    entry->set_dirty(); // written back when evicted
+}
+#endif
+
+#ifdef DETERMINISTIC
+// lock the read/write set of a txn, called by the sequencer in epoch order
+// the client is answered once the last lock of the set is granted
+void txn_man_t::lock_set(int client_id, uint64_t timestamp, uint32_t* row_ids, access_t* types, int num, page_table_t* tab, int tid){
+    auto access = accesses[client_id];
+    for(int rid=0; rid<num; rid++){
+	if(access[rid] == nullptr){
+	    access[rid] = new Access();
+	    if(rid == 0)
+		access[rid]->txn_status = new std::atomic<txn_status_t>(txn_status_t::RUNNING);
+	    else
+		access[rid]->txn_status = access[0]->txn_status;
+	}
+	access[rid]->client_id = client_id;
+	access[rid]->timestamp = timestamp;
+	access[rid]->type = types[rid];
+	access[rid]->lock_status = lock_status_t::LOCK_READY;
+	access[rid]->rid = row_ids[rid];
+    }
+    row_cnt[client_id] = num;
+
+    // one extra count keeps the grants of earlier rows from answering too early
+    pending[client_id].store(num + 1);
+    for(int rid=0; rid<num; rid++){
+	table_entry_t* entry = nullptr;
+	RC rc = tab->get(entry, row_ids[rid], types[rid], this, access[rid], tid);
+	if(rc == ABORT){
+	    debug::notify_error("row %u of client %d is not in the page table", row_ids[rid], client_id);
+	    exit(0);
+	}
+	else if(rc == RCOK)
+	    granted(access[rid], tid);
+    }
+    granted(access[0], tid);
+}
+
+void txn_man_t::granted(Access* access, int tid){
+    int client_id = access->client_id;
+    if(pending[client_id].fetch_sub(1) != 1)
+	return;
+
+    auto send_ptr = mem->rpc_response_buffer_pool(tid);
+    auto response = create_message<rpc_response_t>(send_ptr, tid, RCOK);
+    transport->send_client((uint64_t)response, sizeof(base_response_t), client_id);
+}
+#endif
+
 #ifdef LOCKTABLE
 row_t* txn_man_t::get_row(RC& rc, uint32_t row_id, int client_id, int tid, int pid, access_t type, page_table_t* tab, table_entry_t*& entry, uint64_t timestamp){
     auto access = accesses[client_id];
+    #ifdef DETERMINISTIC
+    // the whole set is locked already, the row must be part of it
+    for(int rid=0; rid<row_cnt[client_id]; rid++){
+	if(access[rid]->entry->id != row_id)
+	    continue;
+	rc = RCOK;
+	entry = access[rid]->entry;
+	if(entry->is_remote())
+	    return mem->row_buffer_pool(tid);
+	return (row_t*)entry->local_addr;
+    }
+    debug::notify_error("row %u is not in the read/write set of client %d", row_id, client_id);
+    exit(0);
+    #endif
     int _row_cnt = row_cnt[client_id];
     if(access[_row_cnt] == nullptr){
-	auto _access = new Access;
+	auto _access = new Access();
 	access[_row_cnt] = _access;
 	std::atomic<txn_status_t>* txn_status = nullptr;
 	if(_row_cnt == 0){
@@ -591,6 +945,10 @@ row_t* txn_man_t::get_row(RC& rc, uint32_t row_id, int client_id, int tid, int p
     access[_row_cnt]->type = type;
     access[_row_cnt]->lock_status = lock_status_t::LOCK_READY;
     access[_row_cnt]->rid = row_id; // debug
+    #ifdef COMMUTATIVE
+    if(type == DELTA) // before the lock can be granted by another thread
+	access[_row_cnt]->delta = *delta_args[client_id];
+    #endif
 
     rc = tab->get(entry, row_id, type, this, access[_row_cnt], tid);
     if(rc == ABORT){
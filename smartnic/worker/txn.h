@@ -1,6 +1,12 @@
 #pragma once
 #include "common/rpc.h"
 #include "common/global.h"
+#ifdef DETERMINISTIC
+#include "worker/sequencer.h"
+#endif
+#ifdef COMMUTATIVE
+#include "worker/combiner.h"
+#endif
 #include <vector>
 #include <thread>
 #include <chrono>
@@ -11,6 +17,7 @@ class table_t;
 template <typename, typename>
 class tree_t;
 class row_t;
+class catalog_t;
 class worker_mr_t;
 class worker_transport_t;
 class base_query_t;
@@ -52,6 +59,12 @@ class Access{
 	lock_status_t lock_status;
 	std::atomic<txn_status_t>* txn_status;
 	uint64_t timestamp;
+	#ifdef EARLY_LOCK_RELEASE
+	row_t* undo; // before image of an early released write
+	#endif
+	#ifdef COMMUTATIVE
+	rpc_delta_t delta; // fetch deltas are applied when the lock is granted, the others at commit
+	#endif
 };
 
 class txn_man_t{
@@ -64,6 +77,37 @@ class txn_man_t{
 	int row_cnt[CLIENT_THREAD_NUM];
 	Access** accesses[CLIENT_THREAD_NUM];
 
+	#ifdef EARLY_LOCK_RELEASE
+	// commit dependencies of a client's txn on early released writes
+	struct commit_dep_t{
+	    std::atomic<int> cnt; // unfinished predecessors
+	    std::atomic<bool> parked; // the commit waits for the last predecessor
+	    int num;
+	    char* data; // rows of the parked COMMIT_DATA
+	};
+	commit_dep_t deps[CLIENT_THREAD_NUM];
+	#endif
+
+	#ifdef DETERMINISTIC
+	sequencer_t sequencer;
+	std::atomic<int> pending[CLIENT_THREAD_NUM]; // locks of a scheduled txn not granted yet
+	#endif
+
+	#ifdef COMMUTATIVE
+	combiner_t combiner;
+	rpc_delta_t* delta_args[CLIENT_THREAD_NUM]; // deltas of the DELTA request being locked
+	#endif
+
+	#ifdef PROJECTION
+	// columns the pending access of each client is answered with, cols 0 for the whole row
+	struct projection_t{
+	    catalog_t* schema;
+	    uint64_t cols;
+	};
+	projection_t projs[CLIENT_THREAD_NUM];
+	size_t pack_row(int client_id, row_t* row, char* dst);
+	#endif
+
 	// main functions
 	virtual void init(worker_t* worker);
 	void release();
@@ -90,7 +134,7 @@ class txn_man_t{
     #else // ifndef BATCH
 
 	RC finish(RC rc, int qp_id, int tid);
-	RC finish_with_write(char* new_row, int num, int qp_id, int tid);
+	RC finish_with_write(char* new_row, int num, int qp_id, int tid, bool by_cols = false); // by_cols: commit_col_t runs
 	RC cleanup(RC rc, int qp_id, int tid);
 
 	#ifdef LOCKTABLE
@@ -107,6 +151,46 @@ class txn_man_t{
 	RC prepare_commit(Access* access);
 	void flush(Access* acess);
 
+	#ifdef EARLY_LOCK_RELEASE
+	RC release_early(int* idx, char* new_row, int num, int qp_id, int tid);
+	void add_dependency(Access* access, int cnt);
+	bool resolve_dependency(Access* access, bool abort);
+	bool park_commit(char* new_row, int num, int qp_id);
+	void commit_parked(Access* access, int tid);
+	#endif
+
+	#ifdef NEAR_DATA
+	// the lock a scan waited for is granted, the workload goes on with the scan
+	virtual void resume_scan(Access* access, int tid){ }
+	#endif
+
+	#ifdef STORED_PROC
+	// the lock a procedure waited for is granted, true if the workload went on with it
+	virtual bool resume_proc(Access* access, int tid){ return false; }
+	#endif
+
+	#ifdef COLUMN_COMMIT
+	void split_cols(char* data, int num, char** cols);
+	void install_cols(char* cols, char* end, table_entry_t* entry, int tid);
+	#endif
+
+	#ifdef COMMUTATIVE
+	RC apply_delta(Access* access, int tid);
+	void commit_delta(Access* access, int tid);
+	#endif
+
+	#ifdef MULTI_DPU
+	// two-phase commit across DPUs: the vote of this DPU, and the rollback of a txn that
+	// aborted on another one, prepared or not
+	RC prepare(int client_id, int tid);
+	RC rollback(int client_id, int tid);
+	#endif
+
+	#ifdef DETERMINISTIC
+	void lock_set(int client_id, uint64_t timestamp, uint32_t* row_ids, access_t* types, int num, page_table_t* tab, int tid);
+	void granted(Access* access, int tid);
+	#endif
+
     #endif // end of BATCH
 
 	// helper functions
@@ -8,6 +8,9 @@
 #include "storage/row.h"
 #include "storage/table.h"
 #include "worker/txn.h"
+#ifdef RPC_RING
+#include "worker/ring.h"
+#endif
 
 RC worker_t::init(config_t* conf){
     this->conf = conf;
@@ -40,6 +43,8 @@ RC worker_t::init(config_t* conf){
 	auto ptr = mem->rpc_request_pool(i);
 	transport->prepost_recv_client((uint64_t)ptr, sizeof(rpc_commit_t), i);
     }
+    #elif defined RPC_RING
+    rings = new rpc_ring_t(mem, transport); // clients write their requests, nothing to prepost
     #else
     for(int i=0; i<CLIENT_THREAD_NUM; i++){
 	auto ptr = mem->rpc_request_buffer_pool(i);
@@ -13,6 +13,10 @@ class table_t;
 class row_t;
 class thread_t;
 class txn_man_t;
+class page_table_t;
+class indirection_table_t;
+class placement_t;
+class rpc_ring_t;
 
 class worker_t{
     public:
@@ -26,6 +30,18 @@ class worker_t{
         worker_mr_t* mem;
         // network configuration
         config_t* conf;
+	// indirection table (row_id <-> row_addr)
+	#ifdef LOCKTABLE
+	page_table_t* tab;
+	#else
+	indirection_table_t* tab;
+	#endif
+	// which rows the loaders put in DPU memory
+	placement_t* placement;
+	#ifdef RPC_RING
+	// requests written by the clients
+	rpc_ring_t* rings;
+	#endif
 
 	// initialize tables and indexes
 	virtual RC init(config_t* conf);
@@ -21,17 +21,11 @@ class ycsb_worker_t: public worker_t{
 	RC get_txn_man(txn_man_t*& txn_man, thread_t* thd);
 
         int key_to_part(uint64_t key);
+        void plan_placement();
 
         table_t* table;
 
         tree_t<Key, Value>* index;
-	// indirection table (row_id <-> row_addr)
-	#ifdef LOCKTABLE
-	page_table_t* tab;
-	#else
-	indirection_table_t* tab;
-	#endif
-	std::atomic<int64_t> free_pages;
 
     private:
         static void thread_init_table(void* This, int tid){
@@ -48,6 +42,9 @@ class ycsb_txn_man_t: public txn_man_t{
         void init(worker_t* worker);
 
 	RC run_request(base_request_t* request, int tid);
+	#ifdef NEAR_DATA
+	void resume_scan(Access* access, int tid);
+	#endif
     private:
 //        RC read(rpc_request_t<Key>* request, rpc_response_type* response, int tid);
 //        RC upsert(rpc_request_t<Key>* request, int tid);
@@ -56,5 +53,27 @@ class ycsb_txn_man_t: public txn_man_t{
 
 	ycsb_worker_t* worker;
 	uint64_t row_cnt;
+
+	#ifdef NEAR_DATA
+	RC run_scan(rpc_request_t<Key>* request, int tid);
+	RC continue_scan(int client_id, int tid);
+	void add_scan_row(int client_id, table_entry_t* entry);
+	void finish_scan(int client_id, int tid);
+	void delegate_scan(int client_id, int tid);
+
+	// the scan of each client, it goes on on the thread that grants a lock it waits for
+	struct scan_t{
+	    scan_filter_t filter;
+	    uint64_t timestamp;
+	    uint32_t row_ids[MAX_SCAN_NUM];
+	    int num;
+	    int next;
+	    table_entry_t* remote[MAX_SCAN_NUM]; // locked rows that are not in DPU memory
+	    int remote_num;
+	    scan_result_t result;
+	};
+	scan_t scans[CLIENT_THREAD_NUM];
+	uint64_t near_data_addr[WORKER_THREAD_NUM]; // host block for the delegated scans of a thread
+	#endif
 };
 
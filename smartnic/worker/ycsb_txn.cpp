@@ -15,6 +15,10 @@
 void ycsb_txn_man_t::init(worker_t* worker){
     txn_man_t::init(worker);
     this->worker = (ycsb_worker_t*)worker;
+    #ifdef NEAR_DATA
+    for(int i=0; i<WORKER_THREAD_NUM; i++)
+	near_data_addr[i] = worker->rpc_alloc(0, 0);
+    #endif
 }
 
 #if defined BATCH || defined BATCH2
@@ -48,6 +52,20 @@ RC ycsb_txn_man_t::run_request(base_request_t* request, int tid){
     else{
 	auto rpc_request = reinterpret_cast<rpc_request_t<Key>*>(request);
 	int num = rpc_request->num;
+
+	// lock decisions are made request by request, the remote rows granted in the batch
+	// are read afterwards with a single chain of RDMA READs
+	int pending = 0;
+	uint64_t local_addr[REQUEST_BATCH_SIZE];
+	uint64_t remote_addr[REQUEST_BATCH_SIZE];
+	int remote_pid[REQUEST_BATCH_SIZE];
+	rpc_response_buffer_t* pending_res[REQUEST_BATCH_SIZE];
+	int pending_client[REQUEST_BATCH_SIZE];
+	#if defined LOCKTABLE && defined BUFFER
+	table_entry_t* pending_entry[REQUEST_BATCH_SIZE];
+	uint64_t pending_timestamp[REQUEST_BATCH_SIZE];
+	#endif
+
 	for(int i=0; i<num; i++){
 	    auto req = rpc_request->get_buffer(i);
 
@@ -112,26 +130,23 @@ RC ycsb_txn_man_t::run_request(base_request_t* request, int tid){
 	    }
 
     	    #ifdef LOCKTABLE
-	    if(entry->is_remote()){
-		transport->read((uint64_t)row, entry->remote_addr, sizeof(row_t), tid, pid);
-	        #ifdef BUFFER
-		if(test_probability()){ // migrate
-		    row_t* new_row = (row_t*)malloc(sizeof(row_t));
-		    memcpy(new_row, row, sizeof(row_t));
-		    entry->set_local();
-		    entry->update_timestamp(timestamp);
-		    entry->local_addr = (uint64_t)new_row;
-		    row = new_row;
-
-		    worker->tab->replace(entry, this, tid);
-		}
-                #endif // end of BUFFER
-	    }
-            #else // ifndef LOCKTABLE
-	    if(is_remote){
-		transport->read((uint64_t)row, unmasked_addr, sizeof(row_t), tid, pid);
+	    bool is_remote = entry->is_remote();
+	    uint64_t unmasked_addr = entry->remote_addr;
+    	    #endif
+	    if(is_remote){ // the response is completed once the read lands
+		local_addr[pending] = (uint64_t)mem->prefetch_buffer_pool(tid, pending);
+		remote_addr[pending] = unmasked_addr;
+		remote_pid[pending] = pid;
+		pending_res[pending] = res;
+		pending_client[pending] = client_id;
+	        #if defined LOCKTABLE && defined BUFFER
+		pending_entry[pending] = entry;
+		pending_timestamp[pending] = timestamp;
+                #endif
+		pending++;
+		res_idx++;
+		continue;
 	    }
-    	    #endif 
 
 	    res->update(client_id, rc);
 	    //res->update(client_id, RCOK);
@@ -141,6 +156,21 @@ RC ycsb_txn_man_t::run_request(base_request_t* request, int tid){
 	    res_idx++;
 
 	}
+
+	if(pending){
+	    transport->read_async(local_addr, remote_addr, remote_pid, sizeof(row_t), pending, tid);
+	    transport->poll_async(tid);
+	}
+	for(int i=0; i<pending; i++){
+	    auto row = (row_t*)local_addr[i];
+	    #if defined LOCKTABLE && defined BUFFER
+	    auto entry = pending_entry[i];
+	    if(worker->tab->admit(entry, tid) && worker->tab->migrate(entry, row, pending_timestamp[i])) // migrate
+		row = (row_t*)entry->local_addr;
+	    #endif
+	    pending_res[i]->update(pending_client[i], RCOK);
+	    memcpy(pending_res[i]->data, row, sizeof(row_t));
+	}
     }
 
     rpc_response->num = res_idx;
@@ -181,8 +211,20 @@ RC ycsb_txn_man_t::run_request(base_request_t* _request, int tid){
 	}
     }
     #endif
+    #ifdef MULTI_DPU
+    if(type == PREPARE || type == ABORT_ALL){ // two-phase commit across DPUs
+	rc = type == PREPARE ? prepare(qp_id, tid) : rollback(qp_id, tid);
+	response->type = rc;
+	transport->send_client((uint64_t)response, response_size, qp_id);
+	return rc;
+    }
+    #endif
     if(type == COMMIT_DATA){
+	#ifdef COLUMN_COMMIT
+	rc = finish_with_write(request->data, request->num, qp_id, tid, true);
+	#else
 	rc = finish_with_write(request->data, request->num, qp_id, tid);
+	#endif
 	response->type = rc;
 	transport->send_client((uint64_t)response, response_size, qp_id);
 	#ifdef BREAKDOWN
@@ -235,6 +277,11 @@ RC ycsb_txn_man_t::run_request(base_request_t* _request, int tid){
 	return rc;
     }
 
+    #ifdef NEAR_DATA
+    if(type == SCAN)
+	return run_scan(request, tid);
+    #endif
+
     assert(type == READ || type == SCAN || type == WRITE);
 
     //auto send_ptr = mem->rpc_response_buffer_pool(qp_id);
@@ -256,6 +303,9 @@ RC ycsb_txn_man_t::run_request(base_request_t* _request, int tid){
     t[qp_id].start = t[qp_id].end;
     #endif
 
+    #ifdef PROJECTION
+    projs[qp_id] = {worker->table->get_schema(), type == READ ? request->cols : 0};
+    #endif
     #ifdef LOCKTABLE
     table_entry_t* entry = nullptr;
     row_t* row = get_row(rc, row_id, qp_id, tid, pid, type, worker->tab, entry, timestamp);
@@ -295,16 +345,8 @@ RC ycsb_txn_man_t::run_request(base_request_t* _request, int tid){
     if(entry->is_remote()){
 	transport->read((uint64_t)row, entry->remote_addr, sizeof(row_t), tid, pid);
         #ifdef BUFFER
-	if(test_probability()){ // migrate
-	    row_t* new_row = (row_t*)malloc(sizeof(row_t));
-	    memcpy(new_row, row, sizeof(row_t));
-	    entry->update_timestamp(timestamp);
-	    entry->local_addr = (uint64_t)new_row;
-	    entry->set_local();
-	    row = new_row;
-
-	    worker->tab->replace(entry, this, tid);
-	}
+	if(worker->tab->admit(entry, tid) && worker->tab->migrate(entry, row, timestamp)) // migrate
+	    row = (row_t*)entry->local_addr;
 	#endif
     }
     #else
@@ -315,11 +357,14 @@ RC ycsb_txn_man_t::run_request(base_request_t* _request, int tid){
 
     //memcpy(response->data, row->get_data(), sizeof(row_t));
     //memcpy(response->data, row->get_data(), ROW_SIZE);
-    memcpy(response->data, row, sizeof(row_t));
-
     assert(rc == RCOK);
     response->type = rc;
+    #ifdef PROJECTION
+    response_size += pack_row(qp_id, row, response->data);
+    #else
+    memcpy(response->data, row, sizeof(row_t));
     response_size += sizeof(row_t);
+    #endif
     transport->send_client((uint64_t)response, response_size, qp_id);
     #ifdef BREAKDOWN
     t[qp_id].end = asm_rdtsc();
@@ -329,4 +374,109 @@ RC ycsb_txn_man_t::run_request(base_request_t* _request, int tid){
 
     return rc;
 }
+
+#ifdef NEAR_DATA
+// the client sends a scan as one request with its length and filter in the data
+RC ycsb_txn_man_t::run_scan(rpc_request_t<Key>* request, int tid){
+    int client_id = request->qp_id;
+    auto& scan = scans[client_id];
+    scan.filter = *(scan_filter_t*)request->data;
+    scan.timestamp = request->timestamp;
+    scan.next = 0;
+    scan.remote_num = 0;
+    scan.result.cnt = 0;
+    scan.num = worker->index->scan(request->key, scan.row_ids, std::min(request->num, MAX_SCAN_NUM), tid);
+    return continue_scan(client_id, tid);
+}
+
+RC ycsb_txn_man_t::continue_scan(int client_id, int tid){
+    RC rc = RCOK;
+    auto& scan = scans[client_id];
+    while(scan.next < scan.num){
+	table_entry_t* entry = nullptr;
+	auto row = get_row(rc, scan.row_ids[scan.next++], client_id, tid, 0, SCAN, worker->tab, entry, scan.timestamp);
+	if(row == nullptr){
+	    if(rc == ABORT){
+		auto response = create_message<rpc_response_t>(mem->rpc_response_buffer_pool(tid), tid, rc);
+		transport->send_client((uint64_t)response, sizeof(base_response_t), client_id);
+	    }
+	    return rc; // WAIT: resume_scan() picks it up once the lock is granted
+	}
+	add_scan_row(client_id, entry);
+    }
+    finish_scan(client_id, tid);
+    return rc;
+}
+
+void ycsb_txn_man_t::resume_scan(Access* access, int tid){
+    add_scan_row(access->client_id, access->entry);
+    continue_scan(access->client_id, tid);
+}
+
+// rows in DPU memory are filtered right away, the others once the whole scan is locked
+void ycsb_txn_man_t::add_scan_row(int client_id, table_entry_t* entry){
+    auto& scan = scans[client_id];
+    if(entry->is_remote()){
+	scan.remote[scan.remote_num++] = entry;
+	return;
+    }
+    auto row = (row_t*)entry->local_addr;
+    auto value = *(uint64_t*)(row->get_data() + scan.filter.offset);
+    if(value >= scan.filter.lo && value <= scan.filter.hi)
+	scan.result.values[scan.result.cnt++] = value;
+}
+
+// every host-resident row costs a row-sized read over PCIe, past the threshold the
+// memory server filters them in place and only the qualifying values come back
+void ycsb_txn_man_t::finish_scan(int client_id, int tid){
+    auto& scan = scans[client_id];
+    if(scan.remote_num >= NEAR_DATA_THRESHOLD){
+	delegate_scan(client_id, tid);
+    }
+    else{
+	auto row = mem->row_buffer_pool(tid);
+	for(int i=0; i<scan.remote_num; i++){
+	    auto entry = scan.remote[i];
+	    transport->read((uint64_t)row, entry->remote_addr, sizeof(row_t), tid, entry->pid);
+	    auto value = *(uint64_t*)(row->get_data() + scan.filter.offset);
+	    if(value >= scan.filter.lo && value <= scan.filter.hi)
+		scan.result.values[scan.result.cnt++] = value;
+	}
+    }
+
+    auto response = create_message<rpc_response_t>(mem->rpc_response_buffer_pool(tid), tid, RCOK);
+    size_t result_size = sizeof(int) + sizeof(uint64_t) * scan.result.cnt;
+    memcpy(response->data, &scan.result, result_size);
+    transport->send_client((uint64_t)response, sizeof(base_response_t) + result_size, client_id);
+}
+
+void ycsb_txn_man_t::delegate_scan(int client_id, int tid){
+    auto& scan = scans[client_id];
+    // staged in the row buffer, no row is read on this path
+    auto row = mem->row_buffer_pool(tid);
+    auto args = (near_data_scan_t*)row;
+    args->filter = scan.filter;
+    args->filter.offset += row->get_data() - (char*)row;
+    args->num = scan.remote_num;
+    for(int i=0; i<scan.remote_num; i++)
+	args->addr[i] = scan.remote[i]->remote_addr;
+    auto host_addr = near_data_addr[tid];
+    size_t args_size = (char*)&args->addr[args->num] - (char*)args;
+    transport->write((uint64_t)args, host_addr, args_size, tid, 0);
+
+    // the write is ordered before the send on the same QP
+    auto request = create_message<request_t>(mem->request_buffer_pool(tid), tid, 0, request_type::NEAR_DATA_SCAN, host_addr);
+    transport->send((uint64_t)request, sizeof(request_t), tid);
+    auto response = create_message<response_t>(mem->response_buffer_pool(tid));
+    transport->recv((uint64_t)response, sizeof(response_t), tid);
+
+    int cnt = response->addr;
+    if(cnt > 0){
+	size_t values_offset = (char*)args->values - (char*)args;
+	transport->read((uint64_t)args->values, host_addr + values_offset, sizeof(uint64_t) * cnt, tid, 0);
+	memcpy(&scan.result.values[scan.result.cnt], args->values, sizeof(uint64_t) * cnt);
+	scan.result.cnt += cnt;
+    }
+}
+#endif
 #endif
@@ -1,5 +1,6 @@
 #include "common/global.h"
 #include "common/hash.h"
+#include "common/helper.h"
 #include "worker/ycsb.h"
 #include "storage/catalog.h"
 #include "storage/table.h"
@@ -7,6 +8,9 @@
 #include "index/tree.h"
 #include "worker/transport.h"
 #include "worker/mr.h"
+#include "worker/arena.h"
+#include "worker/reclaim.h"
+#include "worker/placement.h"
 #include "worker/thread.h"
 #include "worker/txn.h"
 #include "index/indirection.h"
@@ -26,10 +30,10 @@ RC ycsb_worker_t::init(config_t* conf){
     #else
     tab = new indirection_table_t();
     #endif
-    free_pages.store(DEFAULT_BUFFER_SIZE);
-    //free_pages.store(YCSB_PAGE_NUM/2);
 
+    plan_placement();
     init_table();
+    dpu_arena->print();
     return RCOK;
 }
 
@@ -48,6 +52,24 @@ RC ycsb_worker_t::init_table(){
     return RCOK;
 }
 
+// zipf ranks map to keys the way the clients do, so the hottest ranks are planned first
+void ycsb_worker_t::plan_placement(){
+    uint64_t keys = node_first_key(g_node_id + 1) - node_first_key(g_node_id); // the range of this memory node
+    placement = new placement_t(keys);
+    if(placement->budget() >= keys){
+	placement->pin(table, keys);
+    }
+    else{
+	for(uint64_t rank=0; rank<2*g_synth_table_size && placement->budget()>0; rank++){
+	    uint64_t key = h(&rank, sizeof(rank), HASH_FUNC) % g_synth_table_size + 1;
+	    if(key_to_node(key) != g_node_id)
+		continue;
+	    placement->set_hot(table, key, g_synth_table_size + 1);
+	}
+    }
+    placement->print();
+}
+
 int ycsb_worker_t::key_to_part(uint64_t key){
     return h(&key, sizeof(key), HASH_FUNC) % MR_PARTITION_NUM;
 }
@@ -55,22 +77,24 @@ int ycsb_worker_t::key_to_part(uint64_t key){
 RC ycsb_worker_t::init_table_parallel(int tid){
     bind_core_worker(tid);
 
-    uint64_t chunk = g_synth_table_size / WORKER_THREAD_NUM;
-    uint64_t from = chunk * tid + 1;
-    uint64_t to = chunk * (tid + 1) + 1;
+    uint64_t first = node_first_key(g_node_id);
+    uint64_t last = node_first_key(g_node_id + 1);
+    uint64_t chunk = (last - first) / WORKER_THREAD_NUM;
+    uint64_t from = first + chunk * tid;
+    uint64_t to = first + chunk * (tid + 1);
     if(tid == WORKER_THREAD_NUM-1)
-	to = g_synth_table_size + 1;
+	to = last;
 
     for(uint64_t key=from; key<to; key++){
 	uint32_t row_id = tab->get_next_id();
 	int pid = key_to_part(key);
 	row_t* new_row;
-	bool alloc_local = free_pages.load() > 0 ? true : false;
+	auto local_row = placement->alloc(table, key);
+	bool alloc_local = local_row != nullptr;
 	uint64_t local_addr = 0;
 	uint64_t remote_addr = rpc_alloc(tid, pid);
 	if(alloc_local){ // local alloc
-	    free_pages.fetch_sub(1);
-	    new_row = (row_t*)malloc(ROW_SIZE);
+	    new_row = local_row;
 	    //new_row = (row_t*)malloc(sizeof(row_t));
 	    local_addr = (uint64_t)new_row;
 	}
@@ -111,7 +135,9 @@ RC ycsb_worker_t::init_table_parallel(int tid){
 	uint64_t idx_key = key;
 	uint32_t idx_value = row_id;
 
+	dpu_reclaimer->enter(tid); // cached index pages may be evicted by other loaders
 	index->insert(idx_key, idx_value, tid);
+	dpu_reclaimer->exit(tid);
     }
     return RCOK;
 }